@@ -83,6 +83,21 @@ extern "C" {
 #define NET_MBEDTLS_CONNECT_TIMEOUT     10000U
 #endif /* NET_MBEDTLS_CONNECT_TIMEOUT */
 
+/* Number of TLS sessions kept for resumption (one per server name), 0 to disable */
+#if !defined NET_MBEDTLS_SESSION_CACHE_SIZE
+#define NET_MBEDTLS_SESSION_CACHE_SIZE  2U
+#endif /* NET_MBEDTLS_SESSION_CACHE_SIZE */
+
+/* Maximum age in ms of a cached TLS session before a full handshake is forced */
+#if !defined NET_MBEDTLS_SESSION_LIFETIME
+#define NET_MBEDTLS_SESSION_LIFETIME    3600000U
+#endif /* NET_MBEDTLS_SESSION_LIFETIME */
+
+/* Maximum length of the server name used as session cache key */
+#if !defined NET_MBEDTLS_SESSION_NAME_LEN
+#define NET_MBEDTLS_SESSION_NAME_LEN    64U
+#endif /* NET_MBEDTLS_SESSION_NAME_LEN */
+
 #if !defined(MBEDTLS_CONFIG_FILE)
 #define MBEDTLS_CONFIG_FILE "mbedtls/config.h"
 #endif /* MBEDTLS_CONFIG_FILE */
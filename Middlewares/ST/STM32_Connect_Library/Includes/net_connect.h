@@ -116,6 +116,7 @@ typedef enum
   NET_SO_TLS_SERVER_NAME    =      12,/**< to define server name to check again, option type is a pointer to a null terminated string */
   NET_SO_TLS_PASSWORD       =      13,/**< to define password (if any) used to encrypt the device key, option type is pointer to a null terminated string */
   NET_SO_TLS_CERT_PROF      =      14,/**< to set the X509 security profile, option type is pointer to mbedtls_x509_crt_profile structure */
+  NET_SO_TLS_PROFILE        =      15,/**< to share a TLS profile created by net_tls_profile_create, option type is a pointer to a net_tls_profile_t handle, CA, device cert/key/password, verification and X509 profile options are then ignored */
   NET_SO_BROADCAST          =  0x0020, /* permit to send and to receive broadcast messages (see IP_SOF_BROADCAST option) */
 }
 net_socketoption_t;
@@ -347,6 +348,28 @@ int32_t net_getsockname(int32_t sock, net_sockaddr_t *name, uint32_t *namelen);
 int32_t net_getpeername(int32_t sock, net_sockaddr_t *name, uint32_t *namelen);
 #endif /* NET_BYPASS_NET_SOCKET */
 
+void net_shared_lock(void);
+void net_shared_unlock(void);
+
+#ifdef NET_MBEDTLS_HOST_SUPPORT
+typedef struct net_tls_profile net_tls_profile_t;
+
+/* Parameters of a shared TLS profile, strings are parsed at creation and not referenced afterwards */
+typedef struct
+{
+  const char_t *tls_ca_certs;   /**< Root CA chain, pem format string, NULL if none */
+  const char_t *tls_dev_cert;   /**< Device certificate, pem format string, NULL if none */
+  const char_t *tls_dev_key;    /**< Device key, pem format string, NULL if none */
+  const uint8_t *tls_dev_pwd;   /**< Password of the device key, NULL if none */
+  size_t tls_dev_pwd_len;       /**< Password length */
+  bool tls_srv_verification;    /**< True to require a valid server certificate */
+  const struct mbedtls_x509_crt_profile *tls_cert_prof; /**< X509 security profile, NULL for default */
+} net_tls_profile_conf_t;
+
+int32_t net_tls_profile_create(net_tls_profile_t **profile, const net_tls_profile_conf_t *params);
+void net_tls_profile_release(net_tls_profile_t *profile);
+#endif /* NET_MBEDTLS_HOST_SUPPORT */
+
 extern  const int32_t net_tls_sizeof_suite_structure;
 extern  const void    *net_tls_user_suite0;
 extern  const void    *net_tls_user_suite1;
@@ -56,8 +56,9 @@ void net_unlock_nochk(int32_t idx);
 #define NET_LOCK_SOCKET_ARRAY   NET_MAX_SOCKETS_NBR
 #define NET_LOCK_NETIF_LIST     NET_MAX_SOCKETS_NBR+1
 #define NET_LOCK_STATE_EVENT    NET_MAX_SOCKETS_NBR+2
+#define NET_LOCK_SHARED         NET_MAX_SOCKETS_NBR+3
 
-#define NET_LOCK_NUMBER          (NET_LOCK_STATE_EVENT+1)
+#define NET_LOCK_NUMBER          (NET_LOCK_SHARED+1)
 
 #define  LOCK_SOCK(s)           net_lock((int32_t)s,NET_OS_WAIT_FOREVER)
 #define  UNLOCK_SOCK(s)         net_unlock(s)
@@ -71,6 +72,9 @@ void net_unlock_nochk(int32_t idx);
 #define  WAIT_STATE_CHANGE(to)  net_lock_nochk(NET_LOCK_STATE_EVENT,to )
 #define  SIGNAL_STATE_CHANGE()  net_unlock_nochk(NET_LOCK_STATE_EVENT )
 
+#define  LOCK_SHARED()          net_lock(NET_LOCK_SHARED,NET_OS_WAIT_FOREVER )
+#define  UNLOCK_SHARED()        net_unlock(NET_LOCK_SHARED )
+
 #else
 
 #define  LOCK_SOCK(s)
@@ -81,6 +85,8 @@ void net_unlock_nochk(int32_t idx);
 #define  UNLOCK_NETIF_LIST()
 #define  WAIT_STATE_CHANGE(to)  pnetif->pdrv->if_yield(pnetif, to)
 #define  SIGNAL_STATE_CHANGE()
+#define  LOCK_SHARED()
+#define  UNLOCK_SHARED()
 
 
 
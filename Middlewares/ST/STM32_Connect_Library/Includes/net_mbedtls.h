@@ -33,6 +33,17 @@
 
 /* Private defines -----------------------------------------------------------*/
 
+/* Immutable TLS client setup shared by several sockets, see net_tls_profile_create() */
+struct net_tls_profile
+{
+  mbedtls_ssl_config conf;
+  mbedtls_x509_crt cacert;
+  mbedtls_x509_crt clicert;
+  mbedtls_pk_context pkey;
+  bool srv_verification;
+  uint32_t ref_count;   /* updated under LOCK_SHARED(), the sockets of several tasks may hold the profile */
+};
+
 struct net_tls_data
 {
   const char_t *tls_ca_certs;  /**< Socket option. */
@@ -51,6 +62,7 @@ struct net_tls_data
   mbedtls_x509_crt clicert;
   mbedtls_pk_context pkey;
   const mbedtls_x509_crt_profile *tls_cert_prof;  /**< Socket option. */
+  net_tls_profile_t *tls_profile;                 /**< Socket option, replaces conf, certificates and key. */
 } ;
 
 void net_tls_init(void);
@@ -62,6 +74,7 @@ int32_t net_mbedtls_sock_recv(net_socket_t *sockhnd, uint8_t *buf, size_t len);
 int32_t net_mbedtls_sock_send(net_socket_t *sockhnd, const uint8_t *buf, size_t len);
 bool net_mbedtls_check_tlsdata(net_socket_t *sockhnd);
 void net_mbedtls_set_read_timeout(net_socket_t *sock);
+void net_tls_profile_retain(net_tls_profile_t *profile);
 
 
 #endif /* MBEDTLS_NET_H */
@@ -176,6 +176,27 @@ void net_if_notify(net_if_handle_t *pnetif, net_evt_t event_class, uint32_t even
   }
 }
 
+/**
+  * @brief  Lock the state shared by the tasks using the network, as the TLS session cache, the TLS profiles
+  *         and the application connection pools.
+  *         The lock is not recursive, it must not be held across a socket call.
+  *         It is a no-op without NET_USE_RTOS.
+  * @retval None
+  */
+void net_shared_lock(void)
+{
+  LOCK_SHARED();
+}
+
+/**
+  * @brief  Unlock the state locked by net_shared_lock()
+  * @retval None
+  */
+void net_shared_unlock(void)
+{
+  UNLOCK_SHARED();
+}
+
 
 #ifdef NET_USE_RTOS
 static int32_t net_initialized = 0;
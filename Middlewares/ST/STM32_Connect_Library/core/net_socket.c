@@ -397,9 +397,11 @@ int32_t net_connect(int32_t sock, net_sockaddr_t *addr, uint32_t addrlen)
 #ifdef NET_MBEDTLS_HOST_SUPPORT
             if ((pSocket->is_secure == true) && (pSocket->tlsData != NULL))
             {
+              net_tls_profile_release(pSocket->tlsData->tls_profile);
               /*cstat -MISRAC2012-Rule-21.3 -MISRAC2012-Dir-4.13_h */
               NET_FREE(pSocket->tlsData);
               /*cstat +MISRAC2012-Rule-21.3 +MISRAC2012-Dir-4.13_h */
+              pSocket->tlsData = NULL;
             }
             pSocket->is_secure = false;
 #endif /* NET_MBEDTLS_HOST_SUPPORT */
@@ -775,6 +777,15 @@ int32_t net_closesocket(int32_t sock)
       }
       pSocket->is_secure = false;
     }
+    if (pSocket->tlsData != NULL)
+    {
+      /* TLS was not started: release the profile reference taken by NET_SO_TLS_PROFILE */
+      net_tls_profile_release(pSocket->tlsData->tls_profile);
+      /*cstat -MISRAC2012-Rule-21.3 -MISRAC2012-Dir-4.13_h */
+      NET_FREE(pSocket->tlsData);
+      /*cstat +MISRAC2012-Rule-21.3 +MISRAC2012-Dir-4.13_h */
+      pSocket->tlsData = NULL;
+    }
 #endif /* NET_MBEDTLS_HOST_SUPPORT */
 
     if (check_low_level_socket(sock) < 0)
@@ -1190,6 +1201,35 @@ int32_t net_setsockopt(int32_t sock, int32_t level, net_socketoption_t optname,
         }
         break;
       }
+
+      /* Share an already parsed TLS configuration */
+      case NET_SO_TLS_PROFILE:
+      {
+        if (pSocket->status == SOCKET_CONNECTED)
+        {
+          ret = NET_ERROR_IS_CONNECTED;
+        }
+        else
+        {
+          OPTCHECKTYPE(net_tls_profile_t *, optlen);
+          if (!net_mbedtls_check_tlsdata(pSocket))
+          {
+            NET_DBG_ERROR("Failed to set TLS profile, Allocation failure\n");
+            ret = NET_ERROR_NO_MEMORY;
+          }
+          else
+          {
+            /*cstat -MISRAC2012-Rule-11.5 */
+            net_tls_profile_t *profile = *(net_tls_profile_t *const *) optvalue;
+            /*cstat +MISRAC2012-Rule-11.5 */
+            net_tls_profile_retain(profile);
+            net_tls_profile_release(pSocket->tlsData->tls_profile);
+            pSocket->tlsData->tls_profile = profile;
+            ret = NET_OK;
+          }
+        }
+        break;
+      }
 #endif /* NET_MBEDTLS_HOST_SUPPORT */
 
       default:
@@ -31,12 +31,43 @@ int32_t  mbedtls_rng_raw(void *data, uchar_t *output, size_t len);
 extern struct __RNG_HandleTypeDef hrng;
 
 /* Private defines -----------------------------------------------------------*/
+#if defined(MBEDTLS_SSL_CLI_C) && (NET_MBEDTLS_SESSION_CACHE_SIZE > 0U)
+#define NET_MBEDTLS_SESSION_CACHE
+#endif /* MBEDTLS_SSL_CLI_C && NET_MBEDTLS_SESSION_CACHE_SIZE */
+
 /* Private typedef -----------------------------------------------------------*/
+#ifdef NET_MBEDTLS_SESSION_CACHE
+typedef struct
+{
+  char_t                name[NET_MBEDTLS_SESSION_NAME_LEN];   /* server name, cache key */
+  mbedtls_ssl_session   session;
+  uint32_t              lifetime;                             /* in ms */
+  uint32_t              stored_tick;
+  uint32_t              used_tick;
+  bool                  verified;                             /* the server certificate was verified */
+  bool                  valid;
+} net_tls_session_entry_t;
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
 /* Private variables ---------------------------------------------------------*/
+#ifdef NET_MBEDTLS_SESSION_CACHE
+/* Shared by the sockets of every task, accessed under LOCK_SHARED() */
+static net_tls_session_entry_t net_tls_session_cache[NET_MBEDTLS_SESSION_CACHE_SIZE];
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
 /* Private function prototypes -----------------------------------------------*/
 static void mbedtls_free_resource(net_socket_t *sock);
+#ifdef NET_MBEDTLS_SESSION_CACHE
+static net_tls_session_entry_t *session_cache_find(const char_t *name);
+static void session_cache_drop(net_tls_session_entry_t *entry);
+static void session_cache_forget(const char_t *name);
+static bool session_cache_restore(net_tls_data_t *tlsData);
+static void session_cache_save(net_tls_data_t *tlsData);
+#endif /* NET_MBEDTLS_SESSION_CACHE */
 static int32_t  mbedtls_net_recv(void *ctx, uchar_t *buf, size_t len, uint32_t timeout);
+static int32_t  mbedtls_net_recv_sock(void *ctx, uchar_t *buf, size_t len);
 static int32_t  mbedtls_net_send(void *ctx, const uchar_t *buf, size_t len);
+static void tls_profile_free(net_tls_profile_t *profile);
 
 #ifdef NET_USE_RTOS
 extern void *pxCurrentTCB;
@@ -94,6 +125,14 @@ void net_tls_init(void)
 
 void net_tls_destroy(void)
 {
+#ifdef NET_MBEDTLS_SESSION_CACHE
+  LOCK_SHARED();
+  for (uint32_t i = 0U; i < NET_MBEDTLS_SESSION_CACHE_SIZE; i++)
+  {
+    session_cache_drop(&net_tls_session_cache[i]);
+  }
+  UNLOCK_SHARED();
+#endif /* NET_MBEDTLS_SESSION_CACHE */
 #ifdef MBEDTLS_THREADING_ALT
   mbedtls_threading_free_alt();
 #endif /* MBEDTLS_THREADING_ALT */
@@ -148,7 +187,7 @@ static void DebugPrint(void *ctx,
 void net_mbedtls_set_read_timeout(net_socket_t *sock)
 {
   net_tls_data_t *tlsData = sock->tlsData;
-  if (tlsData != NULL)
+  if ((tlsData != NULL) && (tlsData->tls_profile == NULL))
   {
     mbedtls_ssl_conf_read_timeout(&tlsData->conf, (uint32_t) sock->read_timeout);
   }
@@ -178,40 +217,41 @@ static void net_wrapper_free(void *p)
 
 uint32_t        NET_TICK(void);
 
-int32_t net_mbedtls_start(net_socket_t *sock)
+/**
+  * @brief  Parse the certificates and key, and fill an SSL client configuration
+  * @param  conf: configuration to build
+  * @param  cacert: storage for the root CA chain
+  * @param  clicert: storage for the device certificate
+  * @param  pkey: storage for the device key
+  * @param  params: PEM strings and options to apply
+  * @retval NET_OK on success, NET_ERROR_MBEDTLS_* otherwise, caller frees the objects in all cases
+  */
+static int32_t mbedtls_config_build(mbedtls_ssl_config *conf, mbedtls_x509_crt *cacert,
+                                    mbedtls_x509_crt *clicert, mbedtls_pk_context *pkey,
+                                    const net_tls_profile_conf_t *params)
 {
   int32_t       ret = NET_OK;
-  net_tls_data_t *tlsData = sock->tlsData;
-  uint32_t      start_tick;
 
   (void)   mbedtls_platform_set_calloc_free(net_wrapper_calloc, net_wrapper_free);
-  mbedtls_ssl_init(&tlsData->ssl);
-  mbedtls_ssl_config_init(&tlsData->conf);
+  mbedtls_ssl_config_init(conf);
   /*cstat -MISRAC2012-Rule-11.1 */
-  mbedtls_ssl_conf_dbg(&tlsData->conf, (mbedtls_debug_func_t) DebugPrint, NULL);
+  mbedtls_ssl_conf_dbg(conf, (mbedtls_debug_func_t) DebugPrint, NULL);
   /*cstat +MISRAC2012-Rule-11.1 */
 
   mbedtls_debug_set_threshold(NET_MBEDTLS_DEBUG_LEVEL);
-  mbedtls_x509_crt_init(&tlsData->cacert);
-  if (tlsData->tls_dev_cert != NULL)
-  {
-    mbedtls_x509_crt_init(&tlsData->clicert);
-  }
-  if (tlsData->tls_dev_key != NULL)
-  {
-    mbedtls_pk_init(&tlsData->pkey);
-  }
+  mbedtls_x509_crt_init(cacert);
+  mbedtls_x509_crt_init(clicert);
+  mbedtls_pk_init(pkey);
 
   /* Root CA */
-  if (tlsData->tls_ca_certs != NULL)
+  if (params->tls_ca_certs != NULL)
   {
-    ret = mbedtls_x509_crt_parse(&tlsData->cacert, (uchar_t const *) tlsData->tls_ca_certs,
-                                 strlen((char_t const *) tlsData->tls_ca_certs) + 1U);
+    ret = mbedtls_x509_crt_parse(cacert, (uchar_t const *) params->tls_ca_certs,
+                                 strlen((char_t const *) params->tls_ca_certs) + 1U);
 
     if (ret != 0)
     {
       NET_DBG_ERROR(" failed\n  !  mbedtls_x509_crt_parse returned 0x%lx while parsing root cert\n", ret);
-      mbedtls_free_resource(sock);
       ret =  NET_ERROR_MBEDTLS_CRT_PARSE;
     }
   }
@@ -223,25 +263,23 @@ int32_t net_mbedtls_start(net_socket_t *sock)
 
 
   /* Client cert. and key */
-  if ((ret == NET_OK) && (tlsData->tls_dev_cert != NULL) && (tlsData->tls_dev_key != NULL))
+  if ((ret == NET_OK) && (params->tls_dev_cert != NULL) && (params->tls_dev_key != NULL))
   {
-    ret = mbedtls_x509_crt_parse(&tlsData->clicert, (uchar_t const *) tlsData->tls_dev_cert,
-                                 strlen((char_t const *)tlsData->tls_dev_cert) + 1U);
+    ret = mbedtls_x509_crt_parse(clicert, (uchar_t const *) params->tls_dev_cert,
+                                 strlen((char_t const *)params->tls_dev_cert) + 1U);
     if (ret != 0)
     {
       NET_DBG_ERROR(" failed\n  !  mbedtls_x509_crt_parse returned -0x%lx while parsing device cert\n", -ret);
-      mbedtls_free_resource(sock);
       ret = NET_ERROR_MBEDTLS_CRT_PARSE;
     }
     else
     {
-      ret = mbedtls_pk_parse_key(&tlsData->pkey, (uchar_t const *)tlsData->tls_dev_key,
-                                 strlen((char_t const *)tlsData->tls_dev_key) + 1U,
-                                 (uchar_t const *)tlsData->tls_dev_pwd, tlsData->tls_dev_pwd_len);
+      ret = mbedtls_pk_parse_key(pkey, (uchar_t const *)params->tls_dev_key,
+                                 strlen((char_t const *)params->tls_dev_key) + 1U,
+                                 (uchar_t const *)params->tls_dev_pwd, params->tls_dev_pwd_len);
       if (ret != 0)
       {
         NET_DBG_ERROR(" failed\n  !  mbedtls_pk_parse_key returned -0x%lx while parsing private key\n\n", -ret);
-        mbedtls_free_resource(sock);
         ret = NET_ERROR_MBEDTLS_KEY_PARSE;
       }
     }
@@ -250,12 +288,11 @@ int32_t net_mbedtls_start(net_socket_t *sock)
   /* TLS Connection */
   if (ret == NET_OK)
   {
-    ret = mbedtls_ssl_config_defaults(&tlsData->conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+    ret = mbedtls_ssl_config_defaults(conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
                                       MBEDTLS_SSL_PRESET_DEFAULT);
     if (ret != 0)
     {
       NET_DBG_ERROR(" failed\n  ! mbedtls_ssl_config_defaults returned -0x%lx\n\n", -ret);
-      mbedtls_free_resource(sock);
       ret = NET_ERROR_MBEDTLS_CONFIG;
     }
   }
@@ -263,20 +300,20 @@ int32_t net_mbedtls_start(net_socket_t *sock)
   if (ret == NET_OK)
   {
     /* Allow the user to select a TLS profile? */
-    if (tlsData->tls_cert_prof != NULL)
+    if (params->tls_cert_prof != NULL)
     {
-      mbedtls_ssl_conf_cert_profile(&tlsData->conf, tlsData->tls_cert_prof);
+      mbedtls_ssl_conf_cert_profile(conf, params->tls_cert_prof);
     }
     /*cstat -MISRAC2012-Dir-4.4 */
     /* Only for debug  mbedtls_ssl_conf_verify(&(tlsDataParams->conf), _iot_tls_verify_cert, NULL); */
     /*cstat +MISRAC2012-Dir-4.4 */
-    if (tlsData->tls_srv_verification == true)
+    if (params->tls_srv_verification == true)
     {
-      mbedtls_ssl_conf_authmode(&tlsData->conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+      mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
     }
     else
     {
-      mbedtls_ssl_conf_authmode(&tlsData->conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
+      mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_OPTIONAL);
     }
 
     /* no verification because no certificate */
@@ -290,24 +327,156 @@ int32_t net_mbedtls_start(net_socket_t *sock)
     /*cstat +MISRAC2012-Dir-4.4 */
 
     /*cstat -MISRAC2012-Rule-11.1 */
-    mbedtls_ssl_conf_rng(&tlsData->conf, (mbedtls_rng_func_t) mbedtls_rng_raw, &hrng);
+    mbedtls_ssl_conf_rng(conf, (mbedtls_rng_func_t) mbedtls_rng_raw, &hrng);
     /*cstat +MISRAC2012-Rule-11.1 */
-    mbedtls_ssl_conf_ca_chain(&tlsData->conf, &tlsData->cacert, NULL);
+    mbedtls_ssl_conf_ca_chain(conf, cacert, NULL);
 
-    if ((tlsData->tls_dev_cert != NULL) && (tlsData->tls_dev_key != NULL))
+    if ((params->tls_dev_cert != NULL) && (params->tls_dev_key != NULL))
     {
-      ret = mbedtls_ssl_conf_own_cert(&tlsData->conf, &tlsData->clicert, &tlsData->pkey);
+      ret = mbedtls_ssl_conf_own_cert(conf, clicert, pkey);
       if (ret != 0)
       {
         NET_DBG_ERROR(" failed\n  ! mbedtls_ssl_conf_own_cert returned -0x%lx\n\n", -ret);
-        mbedtls_free_resource(sock);
         ret = NET_ERROR_MBEDTLS_CONFIG;
       }
     }
   }
+  return ret;
+}
+
+
+int32_t net_tls_profile_create(net_tls_profile_t **profile, const net_tls_profile_conf_t *params)
+{
+  int32_t ret = NET_OK;
+  net_tls_profile_t *p;
+
+  if ((profile == NULL) || (params == NULL))
+  {
+    ret = NET_ERROR_PARAMETER;
+  }
+  else
+  {
+    /*cstat -MISRAC2012-Rule-11.5 -MISRAC2012-Rule-21.3 -MISRAC2012-Dir-4.12 */
+    p = NET_MALLOC(sizeof(net_tls_profile_t));
+    /*cstat +MISRAC2012-Rule-11.5 +MISRAC2012-Rule-21.3 +MISRAC2012-Dir-4.12 */
+    if (p == NULL)
+    {
+      NET_DBG_ERROR("Failed to allocate TLS profile.\n");
+      ret = NET_ERROR_NO_MEMORY;
+    }
+    else
+    {
+      (void) memset(p, 0, sizeof(net_tls_profile_t));
+      ret = mbedtls_config_build(&p->conf, &p->cacert, &p->clicert, &p->pkey, params);
+      if (ret == NET_OK)
+      {
+        p->srv_verification = params->tls_srv_verification;
+        p->ref_count = 1U;
+        *profile = p;
+      }
+      else
+      {
+        tls_profile_free(p);
+      }
+    }
+  }
+  return ret;
+}
+
+
+/* The profile is shared by the sockets of every task, its reference count is updated under LOCK_SHARED() */
+void net_tls_profile_retain(net_tls_profile_t *profile)
+{
+  if (profile != NULL)
+  {
+    LOCK_SHARED();
+    profile->ref_count++;
+    UNLOCK_SHARED();
+  }
+}
+
+
+void net_tls_profile_release(net_tls_profile_t *profile)
+{
+  bool last = false;
+
+  if (profile != NULL)
+  {
+    LOCK_SHARED();
+    if (profile->ref_count > 0U)
+    {
+      profile->ref_count--;
+      last = (profile->ref_count == 0U);
+    }
+    UNLOCK_SHARED();
+  }
+
+  /* No other reference is left, the profile is freed out of the lock */
+  if (last == true)
+  {
+    tls_profile_free(profile);
+  }
+}
+
+
+static void tls_profile_free(net_tls_profile_t *profile)
+{
+  mbedtls_x509_crt_free(&profile->clicert);
+  mbedtls_pk_free(&profile->pkey);
+  mbedtls_x509_crt_free(&profile->cacert);
+  mbedtls_ssl_config_free(&profile->conf);
+  /*cstat -MISRAC2012-Rule-21.3 */
+  NET_FREE(profile);
+  /*cstat +MISRAC2012-Rule-21.3 */
+}
+
+
+int32_t net_mbedtls_start(net_socket_t *sock)
+{
+  int32_t       ret = NET_OK;
+  net_tls_data_t *tlsData = sock->tlsData;
+  mbedtls_ssl_config *conf;
+  uint32_t      start_tick;
+#ifdef NET_MBEDTLS_SESSION_CACHE
+  bool          resuming = false;
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
+  (void)   mbedtls_platform_set_calloc_free(net_wrapper_calloc, net_wrapper_free);
+  mbedtls_ssl_init(&tlsData->ssl);
+
+  if (tlsData->tls_profile != NULL)
+  {
+    /* Shared configuration, certificates and key are already parsed */
+    conf = &tlsData->tls_profile->conf;
+    tlsData->tls_srv_verification = tlsData->tls_profile->srv_verification;
+  }
+  else
+  {
+    net_tls_profile_conf_t params;
+
+    params.tls_ca_certs = tlsData->tls_ca_certs;
+    params.tls_dev_cert = tlsData->tls_dev_cert;
+    params.tls_dev_key = tlsData->tls_dev_key;
+    params.tls_dev_pwd = tlsData->tls_dev_pwd;
+    params.tls_dev_pwd_len = tlsData->tls_dev_pwd_len;
+    params.tls_srv_verification = tlsData->tls_srv_verification;
+    params.tls_cert_prof = tlsData->tls_cert_prof;
+
+    conf = &tlsData->conf;
+    ret = mbedtls_config_build(conf, &tlsData->cacert, &tlsData->clicert, &tlsData->pkey, &params);
+    if (ret != NET_OK)
+    {
+      mbedtls_free_resource(sock);
+    }
+    else
+    {
+      mbedtls_ssl_conf_read_timeout(conf, (uint32_t)sock->read_timeout);
+    }
+  }
+
   if (ret == NET_OK)
   {
-    ret = mbedtls_ssl_setup(&tlsData->ssl, &tlsData->conf);
+    ret = mbedtls_ssl_setup(&tlsData->ssl, conf);
     if (ret != 0)
     {
       NET_DBG_ERROR(" failed\n  ! mbedtls_ssl_setup returned -0x%lx\n\n", -ret);
@@ -327,13 +496,29 @@ int32_t net_mbedtls_start(net_socket_t *sock)
     }
   }
 
+#ifdef NET_MBEDTLS_SESSION_CACHE
+  /* Offer a previous session to the server, an abbreviated handshake is done if it accepts it */
+  if (ret == NET_OK)
+  {
+    resuming = session_cache_restore(tlsData);
+  }
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
   if (ret == NET_OK)
   {
     /*cstat -MISRAC2012-Rule-11.1 */
-    mbedtls_ssl_set_bio(&tlsData->ssl,  sock, (mbedtls_ssl_send_t *) mbedtls_net_send, NULL,
-                        (mbedtls_ssl_recv_timeout_t *) mbedtls_net_recv);
+    if (tlsData->tls_profile != NULL)
+    {
+      /* The shared configuration cannot carry the read timeout of each socket */
+      mbedtls_ssl_set_bio(&tlsData->ssl,  sock, (mbedtls_ssl_send_t *) mbedtls_net_send,
+                          (mbedtls_ssl_recv_t *) mbedtls_net_recv_sock, NULL);
+    }
+    else
+    {
+      mbedtls_ssl_set_bio(&tlsData->ssl,  sock, (mbedtls_ssl_send_t *) mbedtls_net_send, NULL,
+                          (mbedtls_ssl_recv_timeout_t *) mbedtls_net_recv);
+    }
     /*cstat +MISRAC2012-Rule-11.1 */
-    mbedtls_ssl_conf_read_timeout(&tlsData->conf, (uint32_t)sock->read_timeout);
 
 
     NET_DBG_INFO("\n\nSSL state connect : %d ", sock->tlsData->ssl.state);
@@ -350,6 +535,12 @@ int32_t net_mbedtls_start(net_socket_t *sock)
 
       if (elapsed_tick > NET_MBEDTLS_CONNECT_TIMEOUT)
       {
+#ifdef NET_MBEDTLS_SESSION_CACHE
+        if (resuming == true)
+        {
+          session_cache_forget(tlsData->tls_srv_name);
+        }
+#endif /* NET_MBEDTLS_SESSION_CACHE */
         mbedtls_free_resource(sock);
         ret = NET_ERROR_MBEDTLS_CONNECT;
         break;
@@ -373,6 +564,12 @@ int32_t net_mbedtls_start(net_socket_t *sock)
         }
         NET_DBG_ERROR(" failed\n  ! mbedtls_ssl_handshake returned -0x%lx\n", -ret);
 
+#ifdef NET_MBEDTLS_SESSION_CACHE
+        if (resuming == true)
+        {
+          session_cache_forget(tlsData->tls_srv_name);
+        }
+#endif /* NET_MBEDTLS_SESSION_CACHE */
         mbedtls_free_resource(sock);
         ret = (ret == MBEDTLS_ERR_X509_CERT_VERIFY_FAILED) ? NET_ERROR_MBEDTLS_REMOTE_AUTH : NET_ERROR_MBEDTLS_CONNECT;
         /*cstat -MISRAC2012-Rule-15.4 */
@@ -399,6 +596,10 @@ int32_t net_mbedtls_start(net_socket_t *sock)
         NET_DBG_INFO("    [ Record expansion is unknown (compression) ]\n");
       }
 
+#ifdef NET_MBEDTLS_SESSION_CACHE
+      session_cache_save(tlsData);
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
       NET_DBG_INFO("  . Verifying peer X.509 certificate...");
 
 
@@ -445,6 +646,7 @@ int32_t net_mbedtls_sock_recv(net_socket_t *sock, uint8_t *buf, size_t len)
     switch (ret)
     {
       case 0:
+      case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
         ret = NET_ERROR_DISCONNECTED;
         break;
 
@@ -518,11 +720,18 @@ static void mbedtls_free_resource(net_socket_t *sock)
 {
   net_tls_data_t *tlsData = sock->tlsData;
 
-  mbedtls_x509_crt_free(&tlsData->clicert);
-  mbedtls_pk_free(&tlsData->pkey);
-  mbedtls_x509_crt_free(&tlsData->cacert);
   mbedtls_ssl_free(&tlsData->ssl);
-  mbedtls_ssl_config_free(&tlsData->conf);
+  if (tlsData->tls_profile != NULL)
+  {
+    net_tls_profile_release(tlsData->tls_profile);
+  }
+  else
+  {
+    mbedtls_x509_crt_free(&tlsData->clicert);
+    mbedtls_pk_free(&tlsData->pkey);
+    mbedtls_x509_crt_free(&tlsData->cacert);
+    mbedtls_ssl_config_free(&tlsData->conf);
+  }
   /*cstat -MISRAC2012-Rule-21.3 */
   NET_FREE(tlsData);
   /*cstat +MISRAC2012-Rule-21.3 */
@@ -588,6 +797,17 @@ static int32_t mbedtls_net_recv(void *ctx, uchar_t *buf, size_t len, uint32_t ti
 }
 
 
+/* received interface for sockets sharing a TLS profile, timeout is the one of the socket */
+static int32_t mbedtls_net_recv_sock(void *ctx, uchar_t *buf, size_t len)
+{
+  /*cstat -MISRAC2012-Rule-11.5 */
+  net_socket_t  *pSocket = (net_socket_t *) ctx;
+  /*cstat +MISRAC2012-Rule-11.5 */
+
+  return mbedtls_net_recv(ctx, buf, len, (uint32_t) pSocket->read_timeout);
+}
+
+
 static int32_t mbedtls_net_send(void *ctx, const uchar_t *buf, size_t len)
 {
   /*cstat -MISRAC2012-Rule-11.5 */
@@ -629,6 +849,213 @@ static int32_t mbedtls_net_send(void *ctx, const uchar_t *buf, size_t len)
   return ret;
 }
 
+#ifdef NET_MBEDTLS_SESSION_CACHE
+/**
+  * @brief  Look up the cached session of a server
+  * @param  name: server name used at connection time
+  * @retval pointer to the cache entry, NULL if none
+  */
+static net_tls_session_entry_t *session_cache_find(const char_t *name)
+{
+  net_tls_session_entry_t *ret = NULL;
+
+  if (name != NULL)
+  {
+    for (uint32_t i = 0U; i < NET_MBEDTLS_SESSION_CACHE_SIZE; i++)
+    {
+      if ((net_tls_session_cache[i].valid == true) &&
+          (strncmp(net_tls_session_cache[i].name, name, NET_MBEDTLS_SESSION_NAME_LEN) == 0))
+      {
+        ret = &net_tls_session_cache[i];
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+/**
+  * @brief  Release a cache entry
+  * @param  entry: cache entry, may be NULL
+  * @retval None
+  */
+static void session_cache_drop(net_tls_session_entry_t *entry)
+{
+  if ((entry != NULL) && (entry->valid == true))
+  {
+    mbedtls_ssl_session_free(&entry->session);
+    entry->valid = false;
+  }
+}
+
+/**
+  * @brief  Release the cache entry of a server
+  * @param  name: server name used at connection time, may be NULL
+  * @retval None
+  */
+static void session_cache_forget(const char_t *name)
+{
+  LOCK_SHARED();
+  session_cache_drop(session_cache_find(name));
+  UNLOCK_SHARED();
+}
+
+/**
+  * @brief  Load a non expired cached session in the SSL context before the handshake
+  * @param  tlsData: TLS data of the socket, SSL context already set up
+  * @retval true if a session has been offered to the server
+  */
+static bool session_cache_restore(net_tls_data_t *tlsData)
+{
+  bool ret = false;
+  net_tls_session_entry_t *entry;
+
+  LOCK_SHARED();
+  entry = session_cache_find(tlsData->tls_srv_name);
+  if (entry != NULL)
+  {
+    uint32_t now = NET_TICK();
+
+    if ((now - entry->stored_tick) >= entry->lifetime)
+    {
+      NET_DBG_INFO("  . TLS session of %s expired\n", entry->name);
+      session_cache_drop(entry);
+    }
+    else if ((tlsData->tls_srv_verification == true) && (entry->verified == false))
+    {
+      /* Resumption skips the certificate check this socket requires */
+      NET_DBG_INFO("  . TLS session of %s was not verified\n", entry->name);
+    }
+    else if (mbedtls_ssl_set_session(&tlsData->ssl, &entry->session) != 0)
+    {
+      session_cache_drop(entry);
+    }
+    else
+    {
+      NET_DBG_INFO("  . Resuming TLS session of %s\n", entry->name);
+      entry->used_tick = now;
+      ret = true;
+    }
+  }
+  UNLOCK_SHARED();
+  return ret;
+}
+
+/**
+  * @brief  Store the session negotiated by the handshake for later reconnections
+  * @param  tlsData: TLS data of the socket, handshake completed
+  * @retval None
+  */
+static void session_cache_save(net_tls_data_t *tlsData)
+{
+  net_tls_session_entry_t *entry;
+  mbedtls_ssl_session session;
+  size_t name_len = 0U;
+  bool keep = false;
+  /* Resumption skips the certificate check, a socket requiring it only resumes verified sessions */
+  bool verified = (mbedtls_ssl_get_verify_result(&tlsData->ssl) == 0U);
+
+  mbedtls_ssl_session_init(&session);
+
+  /* The handshake succeeded under the authentication mode of the socket */
+  if (tlsData->tls_srv_name != NULL)
+  {
+    name_len = strlen(tlsData->tls_srv_name);
+    if ((name_len < NET_MBEDTLS_SESSION_NAME_LEN) && (mbedtls_ssl_get_session(&tlsData->ssl, &session) == 0))
+    {
+      /* A session without identifier nor ticket cannot be resumed */
+      keep = (session.id_len != 0U);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+      keep = keep || (session.ticket_len != 0U);
+#endif /* MBEDTLS_SSL_SESSION_TICKETS */
+    }
+  }
+
+  LOCK_SHARED();
+  entry = (keep == true) ? session_cache_find(tlsData->tls_srv_name) : NULL;
+  if (entry != NULL)
+  {
+    /* Resumed with the same identifier and no new ticket: keep the original age */
+    bool renewed = (entry->verified != verified) || (entry->session.id_len != session.id_len) ||
+                   (memcmp(entry->session.id, session.id, session.id_len) != 0);
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    renewed = renewed || (entry->session.ticket_len != session.ticket_len) ||
+              ((session.ticket_len != 0U) &&
+               (memcmp(entry->session.ticket, session.ticket, session.ticket_len) != 0));
+#endif /* MBEDTLS_SSL_SESSION_TICKETS */
+    if (renewed == false)
+    {
+      entry->used_tick = NET_TICK();
+      keep = false;
+    }
+    else
+    {
+      session_cache_drop(entry);
+    }
+  }
+  else if (keep == true)
+  {
+    /* Pick a free slot, or evict the least recently used one */
+    uint32_t now = NET_TICK();
+    entry = &net_tls_session_cache[0];
+    for (uint32_t i = 0U; i < NET_MBEDTLS_SESSION_CACHE_SIZE; i++)
+    {
+      if (net_tls_session_cache[i].valid == false)
+      {
+        entry = &net_tls_session_cache[i];
+        break;
+      }
+      if ((now - net_tls_session_cache[i].used_tick) > (now - entry->used_tick))
+      {
+        entry = &net_tls_session_cache[i];
+      }
+    }
+    session_cache_drop(entry);
+  }
+  else
+  {
+    /* nothing to store */
+  }
+
+  if (keep == true)
+  {
+#ifdef MBEDTLS_X509_CRT_PARSE_C
+    /* The peer chain is not needed to resume, free it to save heap */
+    if (session.peer_cert != NULL)
+    {
+      mbedtls_x509_crt_free(session.peer_cert);
+      /*cstat -MISRAC2012-Rule-21.3 */
+      mbedtls_free(session.peer_cert);
+      /*cstat +MISRAC2012-Rule-21.3 */
+      session.peer_cert = NULL;
+    }
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
+
+    (void) memcpy(entry->name, tlsData->tls_srv_name, name_len + 1U);
+    entry->session = session;
+    entry->lifetime = NET_MBEDTLS_SESSION_LIFETIME;
+#ifdef MBEDTLS_SSL_SESSION_TICKETS
+    /* Honour the ticket lifetime hint of the server (in seconds) */
+    if ((session.ticket_len != 0U) && (session.ticket_lifetime != 0U) &&
+        (session.ticket_lifetime < (NET_MBEDTLS_SESSION_LIFETIME / 1000U)))
+    {
+      entry->lifetime = session.ticket_lifetime * 1000U;
+    }
+#endif /* MBEDTLS_SSL_SESSION_TICKETS */
+    entry->stored_tick = NET_TICK();
+    entry->used_tick = entry->stored_tick;
+    entry->verified = verified;
+    entry->valid = true;
+  }
+  UNLOCK_SHARED();
+
+  if (keep == false)
+  {
+    mbedtls_ssl_session_free(&session);
+  }
+}
+#endif /* NET_MBEDTLS_SESSION_CACHE */
+
 #endif /* NET_MBEDTLS_HOST_SUPPORT */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,353 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "client/api/json_stream.h"
+
+// tokenizer states
+enum {
+  JS_VALUE = 0,      // a value is expected
+  JS_VALUE_OR_END,   // a value or the end of an empty array is expected
+  JS_KEY_OR_END,     // a key or the end of an empty object is expected
+  JS_KEY,            // a key is expected
+  JS_COLON,          // the separator after a key is expected
+  JS_STRING,         // inside a string
+  JS_ESCAPE,         // after a backslash in a string
+  JS_UNICODE,        // inside a \u escape
+  JS_LITERAL,        // inside a number, true, false or null
+  JS_AFTER_VALUE,    // a separator or the end of a container is expected
+  JS_DONE            // the root value is complete
+};
+
+static bool is_space(char c) { return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'); }
+
+static void token_add(json_stream_t *js, char c) {
+  if (js->token_len < JSON_STREAM_TOKEN_MAX - 1) {
+    js->token[js->token_len++] = c;
+  } else {
+    js->truncated = true;
+  }
+}
+
+static void token_add_utf8(json_stream_t *js, uint16_t cp) {
+  if (cp < 0x80) {
+    token_add(js, (char)cp);
+  } else if (cp < 0x800) {
+    token_add(js, (char)(0xC0 | (cp >> 6)));
+    token_add(js, (char)(0x80 | (cp & 0x3F)));
+  } else {
+    token_add(js, (char)(0xE0 | (cp >> 12)));
+    token_add(js, (char)(0x80 | ((cp >> 6) & 0x3F)));
+    token_add(js, (char)(0x80 | (cp & 0x3F)));
+  }
+}
+
+static void token_reset(json_stream_t *js) {
+  js->token_len = 0;
+  js->truncated = false;
+}
+
+static int emit(json_stream_t *js, json_stream_event_t event, char const *value, size_t len) {
+  if (js->cb && js->cb(js->opaque, event, js->path, value, len) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+// sets the path of the value about to start
+static int path_set(json_stream_t *js, char const *suffix, size_t suffix_len, bool with_dot) {
+  size_t base = js->depth ? js->path_len[js->depth - 1] : 0;
+  size_t needed = base + (with_dot ? 1 : 0) + suffix_len;
+  if (needed >= JSON_STREAM_PATH_MAX) {
+    printf("[%s:%d] JSON path too long\n", __func__, __LINE__);
+    return -1;
+  }
+  if (with_dot) {
+    js->path[base++] = '.';
+  }
+  memcpy(js->path + base, suffix, suffix_len);
+  js->path[needed] = '\0';
+  return 0;
+}
+
+static void after_value(json_stream_t *js) { js->state = (js->depth == 0) ? JS_DONE : JS_AFTER_VALUE; }
+
+static int open_container(json_stream_t *js, char type) {
+  if (js->depth >= JSON_STREAM_DEPTH_MAX) {
+    printf("[%s:%d] JSON nesting too deep\n", __func__, __LINE__);
+    return -1;
+  }
+  if (emit(js, (type == '{') ? JSON_STREAM_OBJECT_START : JSON_STREAM_ARRAY_START, "", 0) != 0) {
+    return -1;
+  }
+  js->stack[js->depth] = type;
+  js->path_len[js->depth] = (uint8_t)strlen(js->path);
+  js->depth++;
+  js->state = (type == '{') ? JS_KEY_OR_END : JS_VALUE_OR_END;
+  return 0;
+}
+
+static int close_container(json_stream_t *js, char type) {
+  if ((js->depth == 0) || (js->stack[js->depth - 1] != type)) {
+    return -1;
+  }
+  js->depth--;
+  js->path[js->path_len[js->depth]] = '\0';
+  if (emit(js, (type == '{') ? JSON_STREAM_OBJECT_END : JSON_STREAM_ARRAY_END, "", 0) != 0) {
+    return -1;
+  }
+  after_value(js);
+  return 0;
+}
+
+static int end_string(json_stream_t *js) {
+  js->token[js->token_len] = '\0';
+  // a truncated key or value would hand a wrong ID or message to the callback
+  if (js->truncated) {
+    return -1;
+  }
+  if (js->is_key) {
+    js->state = JS_COLON;
+    return path_set(js, js->token, js->token_len, js->path_len[js->depth - 1] != 0);
+  }
+  if (emit(js, JSON_STREAM_STRING, js->token, js->token_len) != 0) {
+    return -1;
+  }
+  after_value(js);
+  return 0;
+}
+
+static int end_literal(json_stream_t *js) {
+  json_stream_event_t event = JSON_STREAM_NUMBER;
+  js->token[js->token_len] = '\0';
+  if (strcmp(js->token, "true") == 0 || strcmp(js->token, "false") == 0) {
+    event = JSON_STREAM_BOOL;
+  } else if (strcmp(js->token, "null") == 0) {
+    event = JSON_STREAM_NULL;
+  } else {
+    for (size_t i = 0; i < js->token_len; i++) {
+      char c = js->token[i];
+      if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+        return -1;
+      }
+    }
+  }
+  if (js->truncated || emit(js, event, js->token, js->token_len) != 0) {
+    return -1;
+  }
+  after_value(js);
+  return 0;
+}
+
+static int start_value(json_stream_t *js, char c) {
+  if (js->depth && js->stack[js->depth - 1] == '[') {
+    if (path_set(js, "[]", 2, false) != 0) {
+      return -1;
+    }
+  }
+
+  if (c == '{' || c == '[') {
+    return open_container(js, c);
+  }
+  token_reset(js);
+  if (c == '"') {
+    js->is_key = false;
+    js->state = JS_STRING;
+    return 0;
+  }
+  if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+    token_add(js, c);
+    js->state = JS_LITERAL;
+    return 0;
+  }
+  return -1;
+}
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static int parse_char(json_stream_t *js, char c) {
+  switch (js->state) {
+    case JS_DONE:
+      return is_space(c) ? 0 : -1;
+
+    case JS_VALUE_OR_END:
+      if (is_space(c)) return 0;
+      if (c == ']') return close_container(js, '[');
+      return start_value(js, c);
+
+    case JS_VALUE:
+      if (is_space(c)) return 0;
+      return start_value(js, c);
+
+    case JS_KEY_OR_END:
+      if (is_space(c)) return 0;
+      if (c == '}') return close_container(js, '{');
+      // fall through
+    case JS_KEY:
+      if (is_space(c)) return 0;
+      if (c != '"') return -1;
+      token_reset(js);
+      js->is_key = true;
+      js->state = JS_STRING;
+      return 0;
+
+    case JS_COLON:
+      if (is_space(c)) return 0;
+      if (c != ':') return -1;
+      js->state = JS_VALUE;
+      return 0;
+
+    case JS_STRING:
+      if (c == '"') return end_string(js);
+      if (c == '\\') {
+        js->state = JS_ESCAPE;
+        return 0;
+      }
+      if ((unsigned char)c < 0x20) return -1;
+      token_add(js, c);
+      return 0;
+
+    case JS_ESCAPE:
+      js->state = JS_STRING;
+      switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+          token_add(js, c);
+          return 0;
+        case 'b':
+          token_add(js, '\b');
+          return 0;
+        case 'f':
+          token_add(js, '\f');
+          return 0;
+        case 'n':
+          token_add(js, '\n');
+          return 0;
+        case 'r':
+          token_add(js, '\r');
+          return 0;
+        case 't':
+          token_add(js, '\t');
+          return 0;
+        case 'u':
+          js->hex_count = 0;
+          js->code_point = 0;
+          js->state = JS_UNICODE;
+          return 0;
+        default:
+          return -1;
+      }
+
+    case JS_UNICODE: {
+      int v = hex_value(c);
+      if (v < 0) return -1;
+      js->code_point = (uint16_t)((js->code_point << 4) | v);
+      if (++js->hex_count == 4) {
+        token_add_utf8(js, js->code_point);
+        js->state = JS_STRING;
+      }
+      return 0;
+    }
+
+    case JS_LITERAL:
+      if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '+' || c == '-' ||
+          c == '.') {
+        token_add(js, c);
+        return 0;
+      }
+      if (end_literal(js) != 0) return -1;
+      // the delimiter belongs to the enclosing container
+      return parse_char(js, c);
+
+    case JS_AFTER_VALUE:
+      if (is_space(c)) return 0;
+      if (c == ',') {
+        js->state = (js->stack[js->depth - 1] == '{') ? JS_KEY : JS_VALUE;
+        return 0;
+      }
+      if (c == '}' || c == ']') return close_container(js, (c == '}') ? '{' : '[');
+      return -1;
+
+    default:
+      return -1;
+  }
+}
+
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *opaque) {
+  if (js) {
+    memset(js, 0, sizeof(json_stream_t));
+    js->cb = cb;
+    js->opaque = opaque;
+    js->state = JS_VALUE;
+  }
+}
+
+int json_stream_feed(json_stream_t *js, char const *data, size_t len) {
+  if (js == NULL || (data == NULL && len)) {
+    printf("[%s:%d] invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  for (size_t i = 0; i < len && !js->error; i++) {
+    if (parse_char(js, data[i]) != 0) {
+      printf("[%s:%d] JSON parsing failed at '%s'\n", __func__, __LINE__, js->path);
+      js->error = true;
+    }
+  }
+  return js->error ? -1 : 0;
+}
+
+int json_stream_finish(json_stream_t *js) {
+  if (js == NULL || js->error) {
+    return -1;
+  }
+  // a number at the root has no delimiter
+  if (js->state == JS_LITERAL && js->depth == 0 && end_literal(js) != 0) {
+    js->error = true;
+    return -1;
+  }
+  return (js->state == JS_DONE) ? 0 : -1;
+}
+
+void json_stream_http_body(void *opaque, char const *data, int size) {
+  if (size > 0) {
+    json_stream_feed((json_stream_t *)opaque, data, (size_t)size);
+  }
+}
+
+int json_stream_to_uint64(char const *value, uint64_t *num) {
+  uint64_t n = 0;
+  if (value == NULL || num == NULL || *value == '\0') {
+    return -1;
+  }
+  for (char const *p = value; *p; p++) {
+    if (*p < '0' || *p > '9') {
+      return -1;
+    }
+    uint64_t digit = (uint64_t)(*p - '0');
+    if (n > (UINT64_MAX - digit) / 10) {
+      // overflow
+      return -1;
+    }
+    n = (n * 10) + digit;
+  }
+  *num = n;
+  return 0;
+}
+
+int json_stream_to_uint32(char const *value, uint32_t *num) {
+  uint64_t n = 0;
+  if (json_stream_to_uint64(value, &n) != 0 || n > UINT32_MAX || num == NULL) {
+    return -1;
+  }
+  *num = (uint32_t)n;
+  return 0;
+}
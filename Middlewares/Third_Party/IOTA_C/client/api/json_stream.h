@@ -0,0 +1,180 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_JSON_STREAM_H__
+#define __CLIENT_API_JSON_STREAM_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** @addtogroup IOTA_C
+ * @{
+ */
+
+/** @addtogroup CLIENT
+ * @{
+ */
+
+/** @addtogroup API
+ * @{
+ */
+
+/** @defgroup JSON_Stream JSON Stream
+ * @{
+ */
+
+/** @defgroup JSON_Stream_EXPORTED_TYPES Exported Types
+ * @{
+ */
+
+#define JSON_STREAM_DEPTH_MAX 8     ///< The maximum nesting of objects and arrays
+#define JSON_STREAM_PATH_MAX 64     ///< The maximum length of a value path, including the null terminator
+#define JSON_STREAM_TOKEN_MAX 160   ///< The maximum length of a string or literal value, including the null terminator
+
+/**
+ * @brief Events reported to the stream callback
+ *
+ */
+typedef enum {
+  JSON_STREAM_OBJECT_START = 0,  ///< An object begins
+  JSON_STREAM_OBJECT_END,        ///< An object ends
+  JSON_STREAM_ARRAY_START,       ///< An array begins
+  JSON_STREAM_ARRAY_END,         ///< An array ends
+  JSON_STREAM_STRING,            ///< A string value, unescaped
+  JSON_STREAM_NUMBER,            ///< A number value, as text
+  JSON_STREAM_BOOL,              ///< A true or false value, as text
+  JSON_STREAM_NULL               ///< A null value
+} json_stream_event_t;
+
+/**
+ * @brief Stream callback, called for each value as soon as it is complete
+ *
+ * The path is made of the object keys joined by '.', array elements are noted "[]", e.g.
+ * "data.messageIds[]". The value is null terminated and only valid during the call, a string longer than
+ * JSON_STREAM_TOKEN_MAX - 1 characters fails the parse.
+ *
+ * @param[in] opaque The user context given to json_stream_init()
+ * @param[in] event The event type
+ * @param[in] path The path of the value
+ * @param[in] value The value text, empty for container events
+ * @param[in] len The length of the value text
+ * @return int 0 to continue, any other value stops the parsing with an error
+ */
+typedef int (*json_stream_cb_t)(void *opaque, json_stream_event_t event, char const *path, char const *value,
+                                size_t len);
+
+/**
+ * @brief Incremental JSON parser state
+ *
+ * The document can be fed in chunks of any size, no DOM is built.
+ *
+ */
+typedef struct {
+  json_stream_cb_t cb;                            ///< The value callback
+  void *opaque;                                   ///< The user context of the callback
+  uint8_t state;                                  ///< The tokenizer state
+  uint8_t depth;                                  ///< The number of open containers
+  bool error;                                     ///< A syntax error or an abort occurred, sticky
+  bool is_key;                                    ///< The string being read is an object key
+  bool truncated;                                 ///< The current token did not fit in the buffer
+  char stack[JSON_STREAM_DEPTH_MAX];              ///< '{' or '[' for each open container
+  uint8_t path_len[JSON_STREAM_DEPTH_MAX];        ///< The path length of each open container
+  char path[JSON_STREAM_PATH_MAX];                ///< The path of the current value
+  char token[JSON_STREAM_TOKEN_MAX];              ///< The current string or literal
+  size_t token_len;                               ///< The length of the current token
+  uint8_t hex_count;                              ///< The number of hex digits read in a \u escape
+  uint16_t code_point;                            ///< The \u escape being decoded
+} json_stream_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup JSON_Stream_EXPORTED_FUNCTIONS Exported Functions
+ * @{
+ */
+
+/**
+ * @brief Initializes a JSON stream parser
+ *
+ * @param[out] js A parser object
+ * @param[in] cb The value callback
+ * @param[in] opaque The user context passed to the callback
+ */
+void json_stream_init(json_stream_t *js, json_stream_cb_t cb, void *opaque);
+
+/**
+ * @brief Parses a chunk of the JSON document
+ *
+ * @param[in] js A parser object
+ * @param[in] data A chunk of the document
+ * @param[in] len The length of the chunk
+ * @return int 0 on success, -1 on a syntax error, a value too long or if the callback aborted
+ */
+int json_stream_feed(json_stream_t *js, char const *data, size_t len);
+
+/**
+ * @brief Checks that a complete document has been parsed
+ *
+ * @param[in] js A parser object
+ * @return int 0 on success
+ */
+int json_stream_finish(json_stream_t *js);
+
+/**
+ * @brief Feeds a chunk of an HTTP body, to be used as http_response_t body callback
+ *
+ * @param[in] opaque A json_stream_t object
+ * @param[in] data A chunk of the body
+ * @param[in] size The length of the chunk
+ */
+void json_stream_http_body(void *opaque, char const *data, int size);
+
+/**
+ * @brief Converts a number value to uint32_t
+ *
+ * @param[in] value A number value from the callback
+ * @param[out] num The converted number
+ * @return int 0 on success
+ */
+int json_stream_to_uint32(char const *value, uint32_t *num);
+
+/**
+ * @brief Converts a number value to uint64_t
+ *
+ * @param[in] value A number value from the callback
+ * @param[out] num The converted number
+ * @return int 0 on success
+ */
+int json_stream_to_uint64(char const *value, uint64_t *num);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,119 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <string.h>
+
+#include "client/api/json_writer.h"
+
+static char const* const hex_digits = "0123456789ABCDEF";
+
+static void put(json_writer_t* w, char c) {
+  if (w->buf) {
+    w->buf[w->len] = c;
+  }
+  w->len++;
+  w->last = c;
+}
+
+// a separator is needed unless the value is the first one in its container
+static void separator(json_writer_t* w) {
+  if (w->len && w->last != '{' && w->last != '[' && w->last != ':') {
+    put(w, ',');
+  }
+}
+
+static void put_digits(json_writer_t* w, uint64_t num) {
+  char digits[20];
+  size_t n = 0;
+  do {
+    digits[n++] = (char)('0' + (num % 10));
+    num /= 10;
+  } while (num);
+  while (n) {
+    put(w, digits[--n]);
+  }
+}
+
+void json_writer_init(json_writer_t* w, char* buf) {
+  if (w) {
+    w->buf = buf;
+    w->len = 0;
+    w->last = '\0';
+  }
+}
+
+void json_writer_object_start(json_writer_t* w) {
+  separator(w);
+  put(w, '{');
+}
+
+void json_writer_object_end(json_writer_t* w) { put(w, '}'); }
+
+void json_writer_array_start(json_writer_t* w) {
+  separator(w);
+  put(w, '[');
+}
+
+void json_writer_array_end(json_writer_t* w) { put(w, ']'); }
+
+void json_writer_key(json_writer_t* w, char const key[]) {
+  separator(w);
+  put(w, '"');
+  for (char const* p = key; *p; p++) {
+    put(w, *p);
+  }
+  put(w, '"');
+  put(w, ':');
+}
+
+void json_writer_string(json_writer_t* w, char const str[]) {
+  separator(w);
+  put(w, '"');
+  for (char const* p = str; *p; p++) {
+    unsigned char c = (unsigned char)*p;
+    if (c == '"' || c == '\\') {
+      put(w, '\\');
+      put(w, (char)c);
+    } else if (c < 0x20) {
+      put(w, '\\');
+      put(w, 'u');
+      put(w, '0');
+      put(w, '0');
+      put(w, hex_digits[c >> 4]);
+      put(w, hex_digits[c & 0x0F]);
+    } else {
+      put(w, (char)c);
+    }
+  }
+  put(w, '"');
+}
+
+void json_writer_hex(json_writer_t* w, byte_t const bin[], size_t len) {
+  separator(w);
+  put(w, '"');
+  for (size_t i = 0; i < len; i++) {
+    put(w, hex_digits[bin[i] >> 4]);
+    put(w, hex_digits[bin[i] & 0x0F]);
+  }
+  put(w, '"');
+}
+
+void json_writer_uint64(json_writer_t* w, uint64_t num) {
+  separator(w);
+  put_digits(w, num);
+}
+
+void json_writer_uint64_string(json_writer_t* w, uint64_t num) {
+  separator(w);
+  put(w, '"');
+  put_digits(w, num);
+  put(w, '"');
+}
+
+void json_writer_null(json_writer_t* w) {
+  separator(w);
+  put(w, 'n');
+  put(w, 'u');
+  put(w, 'l');
+  put(w, 'l');
+}
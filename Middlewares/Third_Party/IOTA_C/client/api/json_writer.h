@@ -0,0 +1,165 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CLIENT_API_JSON_WRITER_H__
+#define __CLIENT_API_JSON_WRITER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/types.h"
+
+/** @addtogroup IOTA_C
+ * @{
+ */
+
+/** @addtogroup CLIENT
+ * @{
+ */
+
+/** @addtogroup API
+ * @{
+ */
+
+/** @defgroup JSON_Writer JSON Writer
+ * @{
+ */
+
+/** @defgroup JSON_Writer_EXPORTED_TYPES Exported Types
+ * @{
+ */
+
+/**
+ * @brief Compact JSON emitter writing into a caller buffer
+ *
+ * With a NULL buffer nothing is written and only the length is computed, so a serializer can be run once to size
+ * the output and once to fill it. Separators between members and elements are added automatically.
+ *
+ */
+typedef struct {
+  char *buf;   ///< The output buffer, NULL to only compute the length
+  size_t len;  ///< The number of characters written, without a null terminator
+  char last;   ///< The last character written
+} json_writer_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup JSON_Writer_EXPORTED_FUNCTIONS Exported Functions
+ * @{
+ */
+
+/**
+ * @brief Initializes a writer
+ *
+ * @param[out] w A writer object
+ * @param[in] buf The output buffer, large enough for the whole document, or NULL to compute the length
+ */
+void json_writer_init(json_writer_t *w, char *buf);
+
+/**
+ * @brief Starts an object
+ *
+ * @param[in] w A writer object
+ */
+void json_writer_object_start(json_writer_t *w);
+
+/**
+ * @brief Ends an object
+ *
+ * @param[in] w A writer object
+ */
+void json_writer_object_end(json_writer_t *w);
+
+/**
+ * @brief Starts an array
+ *
+ * @param[in] w A writer object
+ */
+void json_writer_array_start(json_writer_t *w);
+
+/**
+ * @brief Ends an array
+ *
+ * @param[in] w A writer object
+ */
+void json_writer_array_end(json_writer_t *w);
+
+/**
+ * @brief Writes the key of an object member, the value must follow
+ *
+ * @param[in] w A writer object
+ * @param[in] key The key, it is not escaped
+ */
+void json_writer_key(json_writer_t *w, char const key[]);
+
+/**
+ * @brief Writes a string value
+ *
+ * @param[in] w A writer object
+ * @param[in] str A null terminated string, it is escaped
+ */
+void json_writer_string(json_writer_t *w, char const str[]);
+
+/**
+ * @brief Writes binary data as a hex string value
+ *
+ * @param[in] w A writer object
+ * @param[in] bin The data
+ * @param[in] len The length of the data
+ */
+void json_writer_hex(json_writer_t *w, byte_t const bin[], size_t len);
+
+/**
+ * @brief Writes an unsigned number value
+ *
+ * @param[in] w A writer object
+ * @param[in] num The number
+ */
+void json_writer_uint64(json_writer_t *w, uint64_t num);
+
+/**
+ * @brief Writes an unsigned number as a string value, for numbers beyond the double precision
+ *
+ * @param[in] w A writer object
+ * @param[in] num The number
+ */
+void json_writer_uint64_string(json_writer_t *w, uint64_t num);
+
+/**
+ * @brief Writes a null value
+ *
+ * @param[in] w A writer object
+ */
+void json_writer_null(json_writer_t *w);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif
@@ -6,10 +6,11 @@
 #include "utlist.h"
 
 #include "json_utils.h"
+#include "json_writer.h"
 #include "message_builder.h"
 
-// serialize indexation payload to a JSON object
-static cJSON* indexation_to_json(indexation_t* index) {
+// serialize indexation payload
+static int indexation_to_json(json_writer_t* w, indexation_t* index) {
   /*
   An indexation payload structure
   "payload": {
@@ -18,69 +19,26 @@ static cJSON* indexation_to_json(indexation_t* index) {
       "data": "426172"
   }
   */
-  cJSON* payload_obj = NULL;
-
-  if (!index) {
+  if (!index || !index->index || !index->data) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  if ((payload_obj = cJSON_CreateObject()) == NULL) {
-    printf("[%s:%d] creating payload object failed\n", __func__, __LINE__);
-    return NULL;
+    return -1;
   }
 
+  json_writer_object_start(w);
   // type 2 denote as an indexation payload
-  if (!cJSON_AddNumberToObject(payload_obj, JSON_KEY_TYPE, 2)) {
-    printf("[%s:%d] add payload type failed\n", __func__, __LINE__);
-    cJSON_Delete(payload_obj);
-    return NULL;
-  }
-
+  json_writer_key(w, JSON_KEY_TYPE);
+  json_writer_uint64(w, 2);
   // make sure index is a hex string
-  byte_buf_t* idx_hex = byte_buf_str2hex(index->index);
-  if (!idx_hex) {
-    printf("[%s:%d] convert index to hex failed\n", __func__, __LINE__);
-    cJSON_Delete(payload_obj);
-    return NULL;
-  }
-
-  if (!cJSON_AddStringToObject(payload_obj, JSON_KEY_INDEX, (char const*)idx_hex->data)) {
-    printf("[%s:%d] add index failed\n", __func__, __LINE__);
-    cJSON_Delete(payload_obj);
-    byte_buf_free(idx_hex);
-    return NULL;
-  }
-  byte_buf_free(idx_hex);  // no needed
-
-  size_t data_str_len = index->data->len * 2 + 1;
-  char* data_str = malloc(data_str_len);
-  if (!data_str) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
-    cJSON_Delete(payload_obj);
-    return NULL;
-  }
-
-  if (bin_2_hex(index->data->data, index->data->len, data_str, data_str_len) == 0) {
-    // add data object
-    if (!cJSON_AddStringToObject(payload_obj, JSON_KEY_DATA, data_str)) {
-      printf("[%s:%d] creating data failed\n", __func__, __LINE__);
-      cJSON_Delete(payload_obj);
-      payload_obj = NULL;
-    }
-  } else {
-    printf("[%s:%d] convert bin to hex string failed\n", __func__, __LINE__);
-    free(data_str);
-    cJSON_Delete(payload_obj);
-    return NULL;
-  }
-
-  free(data_str);
-  return payload_obj;
+  json_writer_key(w, JSON_KEY_INDEX);
+  json_writer_hex(w, index->index->data, byte_buf_str_len(index->index));
+  json_writer_key(w, JSON_KEY_DATA);
+  json_writer_hex(w, index->data->data, index->data->len);
+  json_writer_object_end(w);
+  return 0;
 }
 
-// serialize utxo input array to a JSON object
-static cJSON* tx_inputs_to_json(transaction_essence_t* es) {
+// serialize utxo input array
+static int tx_inputs_to_json(json_writer_t* w, transaction_essence_t* es) {
   /*
   [
     {
@@ -90,69 +48,29 @@ static cJSON* tx_inputs_to_json(transaction_essence_t* es) {
     }
   ]
   */
-  char tx_id_str[TRANSACTION_ID_BYTES * 2 + 1];
-  memset(tx_id_str, 0, sizeof(tx_id_str));
-  cJSON* input_arr = NULL;
-
-  if (!es->inputs) {
+  if (!es->inputs.elm) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  if ((input_arr = cJSON_CreateArray()) == NULL) {
-    printf("[%s:%d] creating input array failed\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  utxo_input_ht *elm, *tmp;
-  HASH_ITER(hh, es->inputs, elm, tmp) {
-    cJSON* item = cJSON_CreateObject();
-    if (!item) {
-      printf("[%s:%d] creating input item object failed\n", __func__, __LINE__);
-      cJSON_Delete(input_arr);
-      return NULL;
-    }
-
-    // add type
-    if (!cJSON_AddNumberToObject(item, JSON_KEY_TYPE, 0)) {
-      printf("[%s:%d] add input type failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(input_arr);
-      return NULL;
-    }
-
-    // add tx id
-    if (bin_2_hex(elm->tx_id, TRANSACTION_ID_BYTES, tx_id_str, sizeof(tx_id_str)) != 0) {
-      printf("[%s:%d] tx id convertion failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(input_arr);
-      return NULL;
-    }
-
-    if (!cJSON_AddStringToObject(item, JSON_KEY_TX_ID, tx_id_str)) {
-      printf("[%s:%d] add tx id to item failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(input_arr);
-      return NULL;
-    }
-
-    // add index
-    if (!cJSON_AddNumberToObject(item, JSON_KEY_TX_OUT_INDEX, elm->output_index)) {
-      printf("[%s:%d] add input type failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(input_arr);
-      return NULL;
-    }
-
-    // add item to array
-    cJSON_AddItemToArray(input_arr, item);
-  }
-
-  return input_arr;
+    return -1;
+  }
+
+  json_writer_array_start(w);
+  for (uint16_t i = 0; i < es->inputs.count; i++) {
+    utxo_input_t const* elm = &es->inputs.elm[i];
+    json_writer_object_start(w);
+    json_writer_key(w, JSON_KEY_TYPE);
+    json_writer_uint64(w, 0);
+    json_writer_key(w, JSON_KEY_TX_ID);
+    json_writer_hex(w, elm->tx_id, TRANSACTION_ID_BYTES);
+    json_writer_key(w, JSON_KEY_TX_OUT_INDEX);
+    json_writer_uint64(w, elm->output_index);
+    json_writer_object_end(w);
+  }
+  json_writer_array_end(w);
+  return 0;
 }
 
-// serialize utxo output array to a JSON object
-static cJSON* tx_outputs_to_json(transaction_essence_t* es) {
+// serialize utxo output array
+static int tx_outputs_to_json(json_writer_t* w, transaction_essence_t* es) {
   /*
   [
     {
@@ -165,91 +83,35 @@ static cJSON* tx_outputs_to_json(transaction_essence_t* es) {
     }
   ]
   */
-  char addr_str[ED25519_ADDRESS_BYTES * 2 + 1];
-  memset(addr_str, 0, sizeof(addr_str));
-  cJSON* output_arr = NULL;
-
-  if (!es->outputs) {
+  if (!es->outputs.elm) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  if ((output_arr = cJSON_CreateArray()) == NULL) {
-    printf("[%s:%d] creating output array failed\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  outputs_ht *elm, *tmp;
-  HASH_ITER(hh, es->outputs, elm, tmp) {
-    cJSON* item = cJSON_CreateObject();
-    if (!item) {
-      printf("[%s:%d] creating output item object failed\n", __func__, __LINE__);
-      cJSON_Delete(output_arr);
-      return NULL;
-    }
-
-    // add type
-    if (!cJSON_AddNumberToObject(item, JSON_KEY_TYPE, elm->output_type)) {
-      printf("[%s:%d] add output type failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      return NULL;
-    }
-
-    // new address object
-    cJSON* addr_obj = cJSON_CreateObject();
-    if (!addr_obj) {
-      printf("[%s:%d] creating output address object failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      return NULL;
-    }
-
-    // add address type, using ed25519 address schema
-    if (!cJSON_AddNumberToObject(addr_obj, JSON_KEY_TYPE, ADDRESS_VER_ED25519)) {
-      printf("[%s:%d] creating output address object failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      cJSON_Delete(addr_obj);
-      return NULL;
-    }
-
-    // add address hash
-    if (bin_2_hex(elm->address, ED25519_ADDRESS_BYTES, addr_str, sizeof(addr_str)) != 0) {
-      printf("[%s:%d] address convertion failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      cJSON_Delete(addr_obj);
-      return NULL;
-    }
-
-    if (!cJSON_AddStringToObject(addr_obj, JSON_KEY_ADDR, addr_str)) {
-      printf("[%s:%d] add address hash failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      cJSON_Delete(addr_obj);
-      return NULL;
-    }
-    // add address object to item
-    cJSON_AddItemToObject(item, JSON_KEY_ADDR, addr_obj);
-
-    // add amount
-    if (!cJSON_AddNumberToObject(item, JSON_KEY_AMOUNT, elm->amount)) {
-      printf("[%s:%d] add amount failed\n", __func__, __LINE__);
-      cJSON_Delete(item);
-      cJSON_Delete(output_arr);
-      return NULL;
-    }
-
-    // add item to array
-    cJSON_AddItemToArray(output_arr, item);
-  }
-
-  return output_arr;
+    return -1;
+  }
+
+  json_writer_array_start(w);
+  for (uint16_t i = 0; i < es->outputs.count; i++) {
+    utxo_output_t const* elm = &es->outputs.elm[i];
+    json_writer_object_start(w);
+    json_writer_key(w, JSON_KEY_TYPE);
+    json_writer_uint64(w, elm->output_type);
+    // address object, using ed25519 address schema
+    json_writer_key(w, JSON_KEY_ADDR);
+    json_writer_object_start(w);
+    json_writer_key(w, JSON_KEY_TYPE);
+    json_writer_uint64(w, ADDRESS_VER_ED25519);
+    json_writer_key(w, JSON_KEY_ADDR);
+    json_writer_hex(w, elm->address, ED25519_ADDRESS_BYTES);
+    json_writer_object_end(w);
+    json_writer_key(w, JSON_KEY_AMOUNT);
+    json_writer_uint64(w, elm->amount);
+    json_writer_object_end(w);
+  }
+  json_writer_array_end(w);
+  return 0;
 }
 
-// serialize transaction essence to a JSON object
-static cJSON* tx_essence_to_json(transaction_essence_t* es) {
+// serialize transaction essence
+static int tx_essence_to_json(json_writer_t* w, transaction_essence_t* es) {
   /*
   {
     "type": 0,
@@ -258,71 +120,44 @@ static cJSON* tx_essence_to_json(transaction_essence_t* es) {
     "payload": null
   }
   */
-
-  cJSON* es_obj = NULL;
-  cJSON* input_arr = NULL;
-  cJSON* output_arr = NULL;
-
   if (!es) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
+    return -1;
   }
 
-  // create essence object
-  if ((es_obj = cJSON_CreateObject()) == NULL) {
-    printf("[%s:%d] creating tx essence object failed\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  // "type": 0,
-  if (!cJSON_AddNumberToObject(es_obj, JSON_KEY_TYPE, 0)) {
-    printf("[%s:%d] add tx type failed\n", __func__, __LINE__);
-    cJSON_Delete(es_obj);
-    return NULL;
-  }
+  json_writer_object_start(w);
+  json_writer_key(w, JSON_KEY_TYPE);
+  json_writer_uint64(w, 0);
 
-  // input array
-  if ((input_arr = tx_inputs_to_json(es)) == NULL) {
+  json_writer_key(w, JSON_KEY_INPUTS);
+  if (tx_inputs_to_json(w, es) != 0) {
     printf("[%s:%d] add inputs failed\n", __func__, __LINE__);
-    cJSON_Delete(es_obj);
-    return NULL;
+    return -1;
   }
-  cJSON_AddItemToObject(es_obj, JSON_KEY_INPUTS, input_arr);
 
-  // output array
-  if ((output_arr = tx_outputs_to_json(es)) == NULL) {
+  json_writer_key(w, JSON_KEY_OUTPUTS);
+  if (tx_outputs_to_json(w, es) != 0) {
     printf("[%s:%d] add outputs failed\n", __func__, __LINE__);
-    cJSON_Delete(es_obj);
-    return NULL;
+    return -1;
   }
-  cJSON_AddItemToObject(es_obj, JSON_KEY_OUTPUTS, output_arr);
 
   // optional payload
+  json_writer_key(w, JSON_KEY_PAYLOAD);
   if (es->payload) {
     // TODO support different payload type
-    cJSON* idx_payload = indexation_to_json((indexation_t*)es->payload);
-    if (idx_payload) {
-      // add a indexation payload to essence
-      cJSON_AddItemToObject(es_obj, JSON_KEY_PAYLOAD, idx_payload);
-    } else {
+    if (indexation_to_json(w, (indexation_t*)es->payload) != 0) {
       printf("[%s:%d] add indexation payload failed\n", __func__, __LINE__);
-      cJSON_Delete(es_obj);
-      return NULL;
+      return -1;
     }
   } else {
-    // add a null payload to essence
-    if (!cJSON_AddNullToObject(es_obj, JSON_KEY_PAYLOAD)) {
-      printf("[%s:%d] add null payload failed\n", __func__, __LINE__);
-      cJSON_Delete(es_obj);
-      return NULL;
-    }
+    json_writer_null(w);
   }
-
-  return es_obj;
+  json_writer_object_end(w);
+  return 0;
 }
 
-// serialize unlocked block array to a JSON object
-static cJSON* tx_blocks_to_json(unlock_blocks_t* blocks) {
+// serialize unlocked block array
+static int tx_blocks_to_json(json_writer_t* w, unlock_blocks_t* blocks) {
   /*
   [
     {
@@ -339,113 +174,46 @@ static cJSON* tx_blocks_to_json(unlock_blocks_t* blocks) {
     }
   ]
   */
-  char pub_str[ED_PUBLIC_KEY_BYTES * 2 + 1];
-  memset(pub_str, 0, sizeof(pub_str));
-  char sig_str[ED_PRIVATE_KEY_BYTES * 2 + 1];
-  memset(pub_str, 0, sizeof(pub_str));
-  cJSON* block_arr = NULL;
-
   if (!blocks) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  // new unlocked block array
-  if ((block_arr = cJSON_CreateArray()) == NULL) {
-    printf("[%s:%d] creating unlocked block array failed\n", __func__, __LINE__);
-    return NULL;
+    return -1;
   }
 
-  unlock_blocks_t* elm;
-  LL_FOREACH(blocks, elm) {
+  json_writer_array_start(w);
+  for (uint16_t i = 0; i < blocks->count; i++) {
+    unlock_block_elm_t const* elm = &blocks->elm[i];
     if (elm->type == 0) {  // signature block
-      cJSON* sig_block = cJSON_CreateObject();
-      if (!sig_block) {
-        printf("[%s:%d] new signature item failed\n", __func__, __LINE__);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // add type to item, 0 denote a signature unlocked block
-      if (!cJSON_AddNumberToObject(sig_block, JSON_KEY_TYPE, 0)) {
-        printf("[%s:%d] add reference type failed\n", __func__, __LINE__);
-        cJSON_Delete(sig_block);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      cJSON* sig_obj = cJSON_CreateObject();
-      if (!sig_obj) {
-        printf("[%s:%d] new signature obj failed\n", __func__, __LINE__);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // add signature type to item, 0 denote as an ed25519 signature
-      if (!cJSON_AddNumberToObject(sig_obj, JSON_KEY_TYPE, ADDRESS_VER_ED25519)) {
-        printf("[%s:%d] add reference type failed\n", __func__, __LINE__);
-        cJSON_Delete(sig_obj);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // convert signature to string
-      bin_2_hex(elm->sig_block + 1, ED_PUBLIC_KEY_BYTES, pub_str, sizeof(pub_str));
-      if (!cJSON_AddStringToObject(sig_obj, JSON_KEY_PUB_KEY, pub_str)) {
-        printf("[%s:%d] add public key failed\n", __func__, __LINE__);
-        cJSON_Delete(sig_obj);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      bin_2_hex(elm->sig_block + 1 + ED_PUBLIC_KEY_BYTES, ED_PRIVATE_KEY_BYTES, sig_str, sizeof(sig_str));
-      if (!cJSON_AddStringToObject(sig_obj, JSON_KEY_SIG, sig_str)) {
-        printf("[%s:%d] add signature failed\n", __func__, __LINE__);
-        cJSON_Delete(sig_obj);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // add signature to array
-      cJSON_AddItemToObject(sig_block, JSON_KEY_SIG, sig_obj);
-      cJSON_AddItemToArray(block_arr, sig_block);
-
+      json_writer_object_start(w);
+      json_writer_key(w, JSON_KEY_TYPE);
+      json_writer_uint64(w, 0);
+      // 0 denote as an ed25519 signature
+      json_writer_key(w, JSON_KEY_SIG);
+      json_writer_object_start(w);
+      json_writer_key(w, JSON_KEY_TYPE);
+      json_writer_uint64(w, ADDRESS_VER_ED25519);
+      json_writer_key(w, JSON_KEY_PUB_KEY);
+      json_writer_hex(w, elm->sig_block + 1, ED_PUBLIC_KEY_BYTES);
+      json_writer_key(w, JSON_KEY_SIG);
+      json_writer_hex(w, elm->sig_block + 1 + ED_PUBLIC_KEY_BYTES, ED_PRIVATE_KEY_BYTES);
+      json_writer_object_end(w);
+      json_writer_object_end(w);
     } else if (elm->type == 1) {  // reference block
-      // new ref obj and add to array
-      cJSON* ref = cJSON_CreateObject();
-      if (!ref) {
-        printf("[%s:%d] new reference item failed\n", __func__, __LINE__);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // add type to item, 1 denote as a reference block
-      if (!cJSON_AddNumberToObject(ref, JSON_KEY_TYPE, 1)) {
-        printf("[%s:%d] add reference type failed\n", __func__, __LINE__);
-        cJSON_Delete(ref);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-
-      // add reference to array
-      if (!cJSON_AddNumberToObject(ref, JSON_KEY_REFERENCE, elm->reference)) {
-        printf("[%s:%d] add reference failed\n", __func__, __LINE__);
-        cJSON_Delete(ref);
-        cJSON_Delete(block_arr);
-        return NULL;
-      }
-      cJSON_AddItemToArray(block_arr, ref);
-
+      json_writer_object_start(w);
+      json_writer_key(w, JSON_KEY_TYPE);
+      json_writer_uint64(w, 1);
+      json_writer_key(w, JSON_KEY_REFERENCE);
+      json_writer_uint64(w, elm->reference);
+      json_writer_object_end(w);
     } else {
       printf("[%s:%d] Unkown unlocked block type\n", __func__, __LINE__);
     }
   }
-
-  return block_arr;
+  json_writer_array_end(w);
+  return 0;
 }
 
-// serialize a transaction payload to a JSON object
-static cJSON* tx_payload_to_json(transaction_payload_t* tx) {
+// serialize a transaction payload
+static int tx_payload_to_json(json_writer_t* w, transaction_payload_t* tx) {
   /*
   {
     "type": 0,
@@ -453,49 +221,32 @@ static cJSON* tx_payload_to_json(transaction_payload_t* tx) {
     "unlockBlocks": unlock blocks object
   }
   */
-  cJSON* tx_payload = NULL;
-  cJSON* essence = NULL;
-  cJSON* blocks = NULL;
-
   if (!tx) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
+    return -1;
   }
 
-  // create payload object
-  if ((tx_payload = cJSON_CreateObject()) == NULL) {
-    printf("[%s:%d] creating tx payload object failed\n", __func__, __LINE__);
-    return NULL;
-  }
-
-  // "type": 0,
-  if (!cJSON_AddNumberToObject(tx_payload, JSON_KEY_TYPE, 0)) {
-    printf("[%s:%d] add payload type failed\n", __func__, __LINE__);
-    cJSON_Delete(tx_payload);
-    return NULL;
-  }
+  json_writer_object_start(w);
+  json_writer_key(w, JSON_KEY_TYPE);
+  json_writer_uint64(w, 0);
 
-  // essence
-  if ((essence = tx_essence_to_json(tx->essence)) == NULL) {
+  json_writer_key(w, JSON_KEY_ESSENCE);
+  if (tx_essence_to_json(w, tx->essence) != 0) {
     printf("[%s:%d] create essence object failed\n", __func__, __LINE__);
-    cJSON_Delete(tx_payload);
-    return NULL;
+    return -1;
   }
-  cJSON_AddItemToObject(tx_payload, JSON_KEY_ESSENCE, essence);
 
-  // unlocked blocks
-  if ((blocks = tx_blocks_to_json(tx->unlock_blocks)) == NULL) {
+  json_writer_key(w, JSON_KEY_UNLOCK_BLOCKS);
+  if (tx_blocks_to_json(w, tx->unlock_blocks) != 0) {
     printf("[%s:%d] create unlocked blocks object failed\n", __func__, __LINE__);
-    cJSON_Delete(tx_payload);
-    return NULL;
+    return -1;
   }
-  cJSON_AddItemToObject(tx_payload, JSON_KEY_UNLOCK_BLOCKS, blocks);
-
-  return tx_payload;
+  json_writer_object_end(w);
+  return 0;
 }
 
-// serialize a message to a string for sending to a node
-char* message_to_json(core_message_t* msg) {
+// serialize a message, the same writer calls are used to compute the length and to fill the buffer
+static int message_write(json_writer_t* w, core_message_t* msg) {
   /*
   {
   "networkId": "6530425480034647824",
@@ -509,98 +260,125 @@ char* message_to_json(core_message_t* msg) {
   "nonce": "2695978"
   }
   */
-  char* json_str = NULL;
-  cJSON* msg_obj = NULL;
-  cJSON* payload = NULL;
-  cJSON* parents = NULL;
-  char tmp_id_str[IOTA_MESSAGE_ID_BYTES * 2 + 1];
-  memset(tmp_id_str, 0, sizeof(tmp_id_str));
-
-  if (!msg) {
-    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return NULL;
-  }
+  int ret = -1;
 
-  // create message object
-  if ((msg_obj = cJSON_CreateObject()) == NULL) {
-    printf("[%s:%d] creating message object failed\n", __func__, __LINE__);
-    return NULL;
-  }
+  json_writer_object_start(w);
 
-  // add network ID
+  // network ID and nonce are 64-bit numbers, strings keep their precision
+  json_writer_key(w, JSON_KEY_NET_ID);
   if (msg->network_id > 0) {
-    if (!cJSON_AddNumberToObject(msg_obj, JSON_KEY_NET_ID, msg->network_id)) {
-      printf("[%s:%d] creating network ID failed\n", __func__, __LINE__);
-      cJSON_Delete(msg_obj);
-      return NULL;
-    }
+    json_writer_uint64_string(w, msg->network_id);
   } else {
-    if (!cJSON_AddNullToObject(msg_obj, JSON_KEY_NET_ID)) {
-      printf("[%s:%d] creating network ID failed\n", __func__, __LINE__);
-      cJSON_Delete(msg_obj);
-      return NULL;
-    }
+    json_writer_null(w);
   }
 
-  // add parents
-  if ((parents = cJSON_CreateArray()) == NULL) {
-    printf("[%s:%d] creating parent array failed\n", __func__, __LINE__);
-    cJSON_Delete(msg_obj);
-    return NULL;
-  }
-
-  cJSON_AddItemToObject(msg_obj, JSON_KEY_PARENT_IDS, parents);
+  json_writer_key(w, JSON_KEY_PARENT_IDS);
+  json_writer_array_start(w);
   byte_t* p = NULL;
-  p = (byte_t*)utarray_next(msg->parents, p);
-  while (p != NULL) {
-    bin_2_hex(p, IOTA_MESSAGE_ID_BYTES, tmp_id_str, sizeof(tmp_id_str));
-    cJSON_AddItemToArray(parents, cJSON_CreateString(tmp_id_str));
-    p = (byte_t*)utarray_next(msg->parents, p);
+  while ((p = (byte_t*)utarray_next(msg->parents, p)) != NULL) {
+    json_writer_hex(w, p, IOTA_MESSAGE_ID_BYTES);
   }
+  json_writer_array_end(w);
 
-  // add payload
+  json_writer_key(w, JSON_KEY_PAYLOAD);
   switch (msg->payload_type) {
     case 0:
-      payload = tx_payload_to_json((transaction_payload_t*)msg->payload);
+      ret = tx_payload_to_json(w, (transaction_payload_t*)msg->payload);
       break;
     case 1:
       printf("[%s:%d] TODO\n", __func__, __LINE__);
       break;
     case 2:
-      payload = indexation_to_json((indexation_t*)msg->payload);
+      ret = indexation_to_json(w, (indexation_t*)msg->payload);
       break;
     default:
       printf("[%s:%d] Unknow payload type\n", __func__, __LINE__);
       break;
   }
 
-  if (payload == NULL) {
+  if (ret != 0) {
     printf("[%s:%d] creating payload failed\n", __func__, __LINE__);
-    cJSON_Delete(msg_obj);
-    return NULL;
+    return -1;
   }
-  cJSON_AddItemToObject(msg_obj, JSON_KEY_PAYLOAD, payload);
 
-  // add nonce
+  json_writer_key(w, JSON_KEY_NONCE);
   if (msg->nonce > 0) {
-    if (!cJSON_AddNumberToObject(msg_obj, JSON_KEY_NONCE, msg->nonce)) {
-      printf("[%s:%d] creating nonce failed\n", __func__, __LINE__);
-      cJSON_Delete(msg_obj);
-      return NULL;
-    }
+    json_writer_uint64_string(w, msg->nonce);
   } else {
-    if (!cJSON_AddNullToObject(msg_obj, JSON_KEY_NONCE)) {
-      printf("[%s:%d] creating nonce failed\n", __func__, __LINE__);
-      cJSON_Delete(msg_obj);
-      return NULL;
-    }
+    json_writer_null(w);
+  }
+
+  json_writer_object_end(w);
+  return 0;
+}
+
+// second pass, writes a string of the length given by the first one and its terminator
+static void message_write_str(core_message_t* msg, char buf[], size_t json_len) {
+  json_writer_t w;
+  json_writer_init(&w, buf);
+  message_write(&w, msg);
+  buf[json_len] = '\0';
+}
+
+size_t message_to_json_str(core_message_t* msg, char buf[], size_t buf_len) {
+  json_writer_t w;
+
+  if (!msg) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return 0;
+  }
+
+  // first pass computes the exact length
+  json_writer_init(&w, NULL);
+  if (message_write(&w, msg) != 0) {
+    return 0;
+  }
+
+  size_t json_len = w.len;
+  if (!buf || buf_len <= json_len) {
+    return json_len;
   }
 
-  // json object to json string
-  if ((json_str = cJSON_PrintUnformatted(msg_obj)) == NULL) {
-    printf("[%s:%d] convert to string failed\n", __func__, __LINE__);
+  message_write_str(msg, buf, json_len);
+  return json_len;
+}
+
+int message_to_json_buf(core_message_t* msg, byte_buf_t* buf) {
+  if (!msg || !buf) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t json_len = message_to_json_str(msg, NULL, 0);
+  if (json_len == 0) {
+    return -1;
+  }
+
+  if (!byte_buf_reserve(buf, buf->len + json_len + 1)) {
+    printf("[%s:%d] allocate buffer failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  message_write_str(msg, (char*)buf->data + buf->len, json_len);
+  // the data length includes string terminator
+  buf->len += json_len + 1;
+  return 0;
+}
+
+// serialize a message to a string for sending to a node
+char* message_to_json(core_message_t* msg) {
+  char* json_str = NULL;
+
+  size_t json_len = message_to_json_str(msg, NULL, 0);
+  if (json_len == 0) {
+    return NULL;
+  }
+
+  if ((json_str = malloc(json_len + 1)) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
   }
-  cJSON_Delete(msg_obj);
 
+  message_write_str(msg, json_str, json_len);
   return json_str;
 }
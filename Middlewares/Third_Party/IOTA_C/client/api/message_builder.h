@@ -38,6 +38,27 @@ extern "C" {
  */
 char* message_to_json(core_message_t* msg);
 
+/**
+ * @brief Serialize message object to a JSON string appended to a buffer
+ *
+ * The buffer is grown once to the exact length of the message, no intermediate JSON object is built.
+ *
+ * @param[in] msg A message object
+ * @param[out] buf A buffer, the string and its null terminator are appended
+ * @return int 0 on success
+ */
+int message_to_json_buf(core_message_t* msg, byte_buf_t* buf);
+
+/**
+ * @brief Serialize message object to a JSON string in a caller buffer
+ *
+ * @param[in] msg A message object
+ * @param[out] buf A buffer holds the string and its null terminator, NULL to get the length only
+ * @param[in] buf_len The size of the buffer
+ * @return size_t The string length without the terminator, nothing is written if it does not fit, 0 on failure
+ */
+size_t message_to_json_str(core_message_t* msg, char buf[], size_t buf_len);
+
 /**
  * @}
  */
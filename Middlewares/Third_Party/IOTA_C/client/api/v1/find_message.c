@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "client/api/v1/find_message.h"
+#include "client/api/json_stream.h"
 #include "client/api/json_utils.h"
 #include "client/network/http_lib.h"
 #include "core/utils/iota_str.h"
@@ -26,6 +27,81 @@ static void find_msg_free(find_msg_t *ids) {
   }
 }
 
+// JSON paths of the streamed values
+#define FIND_MSG_PATH_DATA "data"
+#define FIND_MSG_PATH_MAX_RESULTS "data.maxResults"
+#define FIND_MSG_PATH_COUNT "data.count"
+#define FIND_MSG_PATH_IDS "data.messageIds"
+#define FIND_MSG_PATH_ID "data.messageIds[]"
+
+// fields found in the streamed response
+#define FIND_MSG_HAS_MAX_RESULTS (1 << 0)
+#define FIND_MSG_HAS_COUNT (1 << 1)
+#define FIND_MSG_HAS_IDS (1 << 2)
+#define FIND_MSG_HAS_ALL (FIND_MSG_HAS_MAX_RESULTS | FIND_MSG_HAS_COUNT | FIND_MSG_HAS_IDS)
+
+// the state of a streamed find message response
+typedef struct {
+  res_find_msg_t *res;  // the response, u.msg_ids is filled while parsing
+  res_err_t *err;       // the error object if the node returned an error
+  uint8_t found;        // FIND_MSG_HAS_* flags
+} find_msg_stream_t;
+
+static int find_msg_stream_cb(void *opaque, json_stream_event_t event, char const *path, char const *value,
+                              size_t len) {
+  find_msg_stream_t *ctx = (find_msg_stream_t *)opaque;
+  find_msg_t *data = ctx->res->u.msg_ids;
+  (void)len;
+
+  if (event == JSON_STREAM_OBJECT_START && strcmp(path, FIND_MSG_PATH_DATA) == 0) {
+    if (data == NULL && (ctx->res->u.msg_ids = find_msg_new()) == NULL) {
+      printf("[%s:%d]: find_msg_t object allocation failed\n", __func__, __LINE__);
+      return -1;
+    }
+  } else if (event == JSON_STREAM_NUMBER && data) {
+    if (strcmp(path, FIND_MSG_PATH_MAX_RESULTS) == 0) {
+      if (json_stream_to_uint32(value, &data->max_results) != 0) {
+        return -1;
+      }
+      ctx->found |= FIND_MSG_HAS_MAX_RESULTS;
+    } else if (strcmp(path, FIND_MSG_PATH_COUNT) == 0) {
+      if (json_stream_to_uint32(value, &data->count) != 0) {
+        return -1;
+      }
+      ctx->found |= FIND_MSG_HAS_COUNT;
+    }
+  } else if (event == JSON_STREAM_ARRAY_START && data && strcmp(path, FIND_MSG_PATH_IDS) == 0) {
+    ctx->found |= FIND_MSG_HAS_IDS;
+  } else if (event == JSON_STREAM_STRING) {
+    if (data && strcmp(path, FIND_MSG_PATH_ID) == 0) {
+      utarray_push_back(data->msg_ids, (void *)&value);
+    } else if (deser_error_stream(&ctx->err, path, value) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int find_msg_stream_end(find_msg_stream_t *ctx, int parsed) {
+  res_err_t *err = deser_error_stream_end(ctx->err);
+  if (parsed == 0 && err) {
+    // got an error response
+    find_msg_free(ctx->res->u.msg_ids);
+    ctx->res->is_error = true;
+    ctx->res->u.error = err;
+    return 0;
+  }
+  res_err_free(err);
+
+  if (parsed == 0 && ctx->res->u.msg_ids && ctx->found == FIND_MSG_HAS_ALL) {
+    return 0;
+  }
+  printf("[%s:%d]: JSON parsing failed\n", __func__, __LINE__);
+  find_msg_free(ctx->res->u.msg_ids);
+  ctx->res->u.msg_ids = NULL;
+  return -1;
+}
+
 res_find_msg_t *res_find_msg_new(void) {
   res_find_msg_t *res = malloc(sizeof(res_find_msg_t));
   if (res) {
@@ -72,62 +148,16 @@ char *res_find_msg_get_id(res_find_msg_t *res, size_t index) {
 }
 
 int deser_find_message(char const *const j_str, res_find_msg_t *res) {
-  int ret = -1;
   if (j_str == NULL || res == NULL) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
     return -1;
   }
 
-  cJSON *json_obj = cJSON_Parse(j_str);
-  if (json_obj == NULL) {
-    return -1;
-  }
-
-  res_err_t *res_err = deser_error(json_obj);
-  if (res_err) {
-    // got an error response
-    res->is_error = true;
-    res->u.error = res_err;
-    ret = 0;
-    goto end;
-
-  } else {
-
-    cJSON *data_obj = cJSON_GetObjectItemCaseSensitive(json_obj, JSON_KEY_DATA);
-    if (data_obj) {
-      // allocate find_msg_t after parsing json object.
-      res->u.msg_ids = find_msg_new();
-      if (res->u.msg_ids == NULL) {
-        printf("[%s:%d]: find_msg_t object allocation failed\n", __func__, __LINE__);
-        goto end;
-      }
-      // TODO index element?
-      
-      // maxResults
-      if ((ret = json_get_uint32(data_obj, JSON_KEY_MAX_RESULTS, &res->u.msg_ids->max_results)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_MAX_RESULTS);
-        goto end;
-      }
-      
-      // count
-      if ((ret = json_get_uint32(data_obj, JSON_KEY_COUNT, &res->u.msg_ids->count)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_COUNT);
-        goto end;
-      }
-      
-      // message IDs
-      if ((ret = json_string_array_to_utarray(data_obj, JSON_KEY_MSG_IDS, res->u.msg_ids->msg_ids)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_MSG_IDS);
-      }
-      
-    } else {
-      printf("[%s:%d]: JSON parsing failed\n", __func__, __LINE__);
-    }
-  }
-
-end:
-  cJSON_Delete(json_obj);
-  return ret;
+  find_msg_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, find_msg_stream_cb, &stream_ctx);
+  json_stream_feed(&js, j_str, strlen(j_str));
+  return find_msg_stream_end(&stream_ctx, json_stream_finish(&js));
 }
 
 int find_message_by_index(iota_client_conf_t const *conf, char const index[], res_find_msg_t *res) {
@@ -167,12 +197,12 @@ int find_message_by_index(iota_client_conf_t const *conf, char const index[], re
     goto done;
   }
 
-  // allocate response
-  http_res.body = byte_buf_new();
-  if (http_res.body == NULL) {
-    printf("[%s:%d]: allocate response failed\n", __func__, __LINE__);
-    goto done;
-  }
+  // the response is parsed while it is received
+  find_msg_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, find_msg_stream_cb, &stream_ctx);
+  http_res.body_func = json_stream_http_body;
+  http_res.body_opaque = &js;
   http_res.code = 0;
 
   // http client configuration
@@ -182,7 +212,7 @@ int find_message_by_index(iota_client_conf_t const *conf, char const index[], re
   http_ctx.use_tls = conf->use_tls;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -195,14 +225,13 @@ int find_message_by_index(iota_client_conf_t const *conf, char const index[], re
                   NULL);
   if (ret < 0) {
     printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+    find_msg_stream_end(&stream_ctx, -1);
   } else {
-    byte_buf2str(http_res.body);
-    // json deserialization
-    ret = deser_find_message((char const *)http_res.body->data, res);
+    ret = find_msg_stream_end(&stream_ctx, json_stream_finish(&js));
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -211,6 +240,5 @@ int find_message_by_index(iota_client_conf_t const *conf, char const index[], re
 done:
   // cleanup command
   iota_str_destroy(cmd);
-  byte_buf_free(http_res.body);
   return ret;
 }
@@ -497,7 +497,7 @@ int get_message_by_id(iota_client_conf_t const *conf, char const msg_id[], res_m
   http_ctx.port = conf->port;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -517,7 +517,7 @@ int get_message_by_id(iota_client_conf_t const *conf, char const msg_id[], res_m
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -530,6 +530,91 @@ done:
   return ret;
 }
 
+int get_message_raw(iota_client_conf_t const *conf, char const msg_id[], core_message_t **msg) {
+  int ret = -1;
+  iota_str_t *cmd = NULL;
+  http_context_t http_ctx;
+  http_response_t http_res;
+  memset(&http_res, 0, sizeof(http_response_t));
+  char const *const cmd_str = "/api/v1/messages/";
+  char const *const cmd_raw = "/raw";
+
+  if (conf == NULL || msg_id == NULL || msg == NULL) {
+    // invalid parameters
+    return -1;
+  }
+  *msg = NULL;
+
+  if (strlen(msg_id) != IOTA_MESSAGE_ID_HEX_BYTES) {
+    // invalid message id length
+    printf("[%s:%d]: invalid message id length: %zu\n", __func__, __LINE__, strlen(msg_id));
+    return -1;
+  }
+
+  cmd = iota_str_reserve(strlen(cmd_str) + IOTA_MESSAGE_ID_HEX_BYTES + strlen(cmd_raw) + 1);
+  if (cmd == NULL) {
+    printf("[%s:%d]: allocate command buffer failed\n", __func__, __LINE__);
+    return -1;
+  }
+  // composing API command
+  snprintf(cmd->buf, cmd->cap, "%s%s%s", cmd_str, msg_id, cmd_raw);
+  cmd->len = strlen(cmd->buf);
+
+  // allocate response
+  http_res.body = byte_buf_new();
+  if (http_res.body == NULL) {
+    printf("[%s:%d]: allocate response failed\n", __func__, __LINE__);
+    goto done;
+  }
+  http_res.code = 0;
+
+  // http client configuration
+  http_ctx.host = conf->host;
+  http_ctx.path = cmd->buf;
+  http_ctx.use_tls = conf->use_tls;
+  http_ctx.port = conf->port;
+
+  // http open
+  ret = http_pool_open(&http_ctx);
+  if (ret != HTTP_OK) {
+    printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
+    goto done;
+  }
+
+  // send request via http client
+  ret = http_read(&http_ctx,
+                  &http_res,
+                  "Accept: application/octet-stream",
+                  NULL);
+  if (ret < 0) {
+    printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+  } else if (http_res.code != 200) {
+    // errors are returned as JSON
+    printf("[%s:%d]: HTTP status %d\n", __func__, __LINE__, http_res.code);
+    ret = -1;
+  } else if ((*msg = core_message_deserialize(http_res.body->data, http_res.body->len)) == NULL) {
+    printf("[%s:%d]: deserialize message failed\n", __func__, __LINE__);
+    ret = -1;
+  } else {
+    ret = 0;
+  }
+
+  // http close
+  if (http_pool_close(&http_ctx) != HTTP_OK )
+  {
+    printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
+    core_message_free(*msg);
+    *msg = NULL;
+    ret = -1;
+  }
+
+done:
+  // cleanup command
+  iota_str_destroy(cmd);
+  byte_buf_free(http_res.body);
+  return ret;
+}
+
 size_t get_message_milestone_signature_count(res_message_t const *const res) {
   if (res) {
     if (!res->is_error && res->u.msg->type == MSG_PAYLOAD_MILESTONE) {
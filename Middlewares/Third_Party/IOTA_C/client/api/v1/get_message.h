@@ -89,6 +89,19 @@ void res_message_free(res_message_t *msg);
  */
 int get_message_by_id(iota_client_conf_t const *conf, char const msg_id[], res_message_t *res);
 
+/**
+ * @brief Get the binary form of a message and deserialize it
+ *
+ * The raw message is about half the size of the JSON one and is parsed without a DOM. Transaction and indexation
+ * payloads are supported.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg_id A message ID to query
+ * @param[out] msg The message object, to be freed with core_message_free()
+ * @return int 0 on success
+ */
+int get_message_raw(iota_client_conf_t const *conf, char const msg_id[], core_message_t **msg);
+
 /**
  * @brief The message response deserialization
  *
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "client/api/json_stream.h"
 #include "client/api/json_utils.h"
 #include "client/api/v1/get_message_children.h"
 #include "client/network/http_lib.h"
@@ -30,6 +31,89 @@ static void msg_children_free(msg_children_t *ch) {
   }
 }
 
+// JSON paths of the streamed values
+#define CHILDREN_PATH_DATA "data"
+#define CHILDREN_PATH_MSG_ID "data.messageId"
+#define CHILDREN_PATH_MAX_RESULTS "data.maxResults"
+#define CHILDREN_PATH_COUNT "data.count"
+#define CHILDREN_PATH_IDS "data.childrenMessageIds"
+#define CHILDREN_PATH_ID "data.childrenMessageIds[]"
+
+// fields found in the streamed response
+#define CHILDREN_HAS_MSG_ID (1 << 0)
+#define CHILDREN_HAS_MAX_RESULTS (1 << 1)
+#define CHILDREN_HAS_COUNT (1 << 2)
+#define CHILDREN_HAS_IDS (1 << 3)
+#define CHILDREN_HAS_ALL (CHILDREN_HAS_MSG_ID | CHILDREN_HAS_MAX_RESULTS | CHILDREN_HAS_COUNT | CHILDREN_HAS_IDS)
+
+// the state of a streamed message children response
+typedef struct {
+  res_msg_children_t *res;  // the response, u.data is filled while parsing
+  res_err_t *err;           // the error object if the node returned an error
+  uint8_t found;            // CHILDREN_HAS_* flags
+} children_stream_t;
+
+static int children_stream_cb(void *opaque, json_stream_event_t event, char const *path, char const *value,
+                              size_t len) {
+  children_stream_t *ctx = (children_stream_t *)opaque;
+  msg_children_t *data = ctx->res->u.data;
+
+  if (event == JSON_STREAM_OBJECT_START && strcmp(path, CHILDREN_PATH_DATA) == 0) {
+    if (data == NULL && (ctx->res->u.data = msg_children_new()) == NULL) {
+      printf("[%s:%d]: msg_children_t object allocation failed\n", __func__, __LINE__);
+      return -1;
+    }
+  } else if (event == JSON_STREAM_NUMBER && data) {
+    if (strcmp(path, CHILDREN_PATH_MAX_RESULTS) == 0) {
+      if (json_stream_to_uint32(value, &data->max_results) != 0) {
+        return -1;
+      }
+      ctx->found |= CHILDREN_HAS_MAX_RESULTS;
+    } else if (strcmp(path, CHILDREN_PATH_COUNT) == 0) {
+      if (json_stream_to_uint32(value, &data->count) != 0) {
+        return -1;
+      }
+      ctx->found |= CHILDREN_HAS_COUNT;
+    }
+  } else if (event == JSON_STREAM_ARRAY_START && data && strcmp(path, CHILDREN_PATH_IDS) == 0) {
+    ctx->found |= CHILDREN_HAS_IDS;
+  } else if (event == JSON_STREAM_STRING) {
+    if (data && strcmp(path, CHILDREN_PATH_ID) == 0) {
+      utarray_push_back(data->children, (void *)&value);
+    } else if (data && strcmp(path, CHILDREN_PATH_MSG_ID) == 0) {
+      if (len >= sizeof(data->msg_id)) {
+        printf("[%s:%d]: %s too long\n", __func__, __LINE__, JSON_KEY_MSG_ID);
+        return -1;
+      }
+      memcpy(data->msg_id, value, len + 1);
+      ctx->found |= CHILDREN_HAS_MSG_ID;
+    } else if (deser_error_stream(&ctx->err, path, value) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int children_stream_end(children_stream_t *ctx, int parsed) {
+  res_err_t *err = deser_error_stream_end(ctx->err);
+  if (parsed == 0 && err) {
+    // got an error response
+    msg_children_free(ctx->res->u.data);
+    ctx->res->is_error = true;
+    ctx->res->u.error = err;
+    return 0;
+  }
+  res_err_free(err);
+
+  if (parsed == 0 && ctx->res->u.data && ctx->found == CHILDREN_HAS_ALL) {
+    return 0;
+  }
+  printf("[%s:%d]: JSON parsing failed\n", __func__, __LINE__);
+  msg_children_free(ctx->res->u.data);
+  ctx->res->u.data = NULL;
+  return -1;
+}
+
 res_msg_children_t *res_msg_children_new(void) {
   res_msg_children_t *res = malloc(sizeof(res_msg_children_t));
   if (res) {
@@ -75,65 +159,16 @@ char *res_msg_children_get(res_msg_children_t *res, size_t index) {
 }
 
 int deser_msg_children(char const *const j_str, res_msg_children_t *res) {
-  int ret = -1;
   if (j_str == NULL || res == NULL) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
     return -1;
   }
 
-  cJSON *json_obj = cJSON_Parse(j_str);
-  if (json_obj == NULL) {
-    return -1;
-  }
-
-  res_err_t *res_err = deser_error(json_obj);
-  if (res_err) {
-    // got an error response
-    res->is_error = true;
-    res->u.error = res_err;
-    ret = 0;
-  } else {
-
-    cJSON *data_obj = cJSON_GetObjectItemCaseSensitive(json_obj, JSON_KEY_DATA);
-    if (data_obj) {
-      // allocate message metadata object after parsing json object.
-      res->u.data = msg_children_new();
-      if (res->u.data == NULL) {
-        printf("[%s:%d]: msg_children_t object allocation filaed\n", __func__, __LINE__);
-        goto end;
-      }
-      
-      // message ID
-      if ((ret = json_get_string(data_obj, JSON_KEY_MSG_ID, res->u.data->msg_id, sizeof(res->u.data->msg_id))) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_MSG_ID);
-        goto end;
-      }
-      
-      // max results
-      if ((ret = json_get_uint32(data_obj, JSON_KEY_MAX_RESULTS, &res->u.data->max_results)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_MAX_RESULTS);
-        goto end;
-      }
-      
-      // count
-      if ((ret = json_get_uint32(data_obj, JSON_KEY_COUNT, &res->u.data->count)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_COUNT);
-        goto end;
-      }
-      
-      // children
-      if ((ret = json_string_array_to_utarray(data_obj, JSON_KEY_CHILDREN_MSG_IDS, res->u.data->children)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_CHILDREN_MSG_IDS);
-      }
-      
-    } else {
-      printf("[%s:%d]: JSON parsing failed\n", __func__, __LINE__);
-    }
-  }
-
-end:
-  cJSON_Delete(json_obj);
-  return ret;
+  children_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, children_stream_cb, &stream_ctx);
+  json_stream_feed(&js, j_str, strlen(j_str));
+  return children_stream_end(&stream_ctx, json_stream_finish(&js));
 }
 
 int get_message_children(iota_client_conf_t const *ctx, char const msg_id[], res_msg_children_t *res) {
@@ -165,12 +200,12 @@ int get_message_children(iota_client_conf_t const *ctx, char const msg_id[], res
   snprintf(cmd->buf, cmd->cap, "%s%s%s", cmd_prefix, msg_id, cmd_suffix);
   cmd->len = strlen(cmd->buf);
 
-  // allocate response
-  http_res.body = byte_buf_new();
-  if (http_res.body == NULL) {
-    printf("[%s:%d]: allocate response failed\n", __func__, __LINE__);
-    goto done;
-  }
+  // the response is parsed while it is received
+  children_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, children_stream_cb, &stream_ctx);
+  http_res.body_func = json_stream_http_body;
+  http_res.body_opaque = &js;
   http_res.code = 0;
 
   // http client configuration
@@ -180,7 +215,7 @@ int get_message_children(iota_client_conf_t const *ctx, char const msg_id[], res
   http_ctx.port = ctx->port;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -193,14 +228,13 @@ int get_message_children(iota_client_conf_t const *ctx, char const msg_id[], res
                   NULL);
   if (ret < 0) {
     printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+    children_stream_end(&stream_ctx, -1);
   } else {
-    byte_buf2str(http_res.body);
-    // json deserialization
-    ret = deser_msg_children((char const *)http_res.body->data, res);
+    ret = children_stream_end(&stream_ctx, json_stream_finish(&js));
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -209,6 +243,5 @@ int get_message_children(iota_client_conf_t const *ctx, char const msg_id[], res
 done:
   // cleanup command
   iota_str_destroy(cmd);
-  byte_buf_free(http_res.body);
   return ret;
 }
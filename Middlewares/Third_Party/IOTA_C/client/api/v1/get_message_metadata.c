@@ -199,7 +199,7 @@ int get_message_metadata(iota_client_conf_t const *conf, char const msg_id[], re
   http_ctx.use_tls = conf->use_tls;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -219,7 +219,7 @@ int get_message_metadata(iota_client_conf_t const *conf, char const msg_id[], re
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
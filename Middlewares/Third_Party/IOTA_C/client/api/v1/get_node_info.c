@@ -88,7 +88,7 @@ int get_node_info(iota_client_conf_t const *conf, res_node_info_t *res) {
   http_ctx.port = conf->port;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -108,7 +108,7 @@ int get_node_info(iota_client_conf_t const *conf, res_node_info_t *res) {
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -1,6 +1,7 @@
 // Copyright 2020 IOTA Stiftung
 // SPDX-License-Identifier: Apache-2.0
 
+#include "client/api/json_stream.h"
 #include "client/api/json_utils.h"
 #include "client/api/v1/get_outputs_from_address.h"
 #include "client/network/http_lib.h"
@@ -27,6 +28,99 @@ static void outputs_free(get_outputs_address_t *ids) {
   }
 }
 
+// JSON paths of the streamed values
+#define OUTPUTS_PATH_DATA "data"
+#define OUTPUTS_PATH_ADDR "data.address"
+#define OUTPUTS_PATH_MAX_RESULTS "data.maxResults"
+#define OUTPUTS_PATH_COUNT "data.count"
+#define OUTPUTS_PATH_IDS "data.outputIds"
+#define OUTPUTS_PATH_ID "data.outputIds[]"
+#define OUTPUTS_PATH_LEDGER_IDX "data.ledgerIndex"
+
+// fields found in the streamed response
+#define OUTPUTS_HAS_ADDR (1 << 0)
+#define OUTPUTS_HAS_MAX_RESULTS (1 << 1)
+#define OUTPUTS_HAS_COUNT (1 << 2)
+#define OUTPUTS_HAS_IDS (1 << 3)
+#define OUTPUTS_HAS_LEDGER_IDX (1 << 4)
+#define OUTPUTS_HAS_ALL \
+  (OUTPUTS_HAS_ADDR | OUTPUTS_HAS_MAX_RESULTS | OUTPUTS_HAS_COUNT | OUTPUTS_HAS_IDS | OUTPUTS_HAS_LEDGER_IDX)
+
+// the state of a streamed outputs response
+typedef struct {
+  res_outputs_address_t *res;  // the response, u.output_ids is filled while parsing
+  res_err_t *err;              // the error object if the node returned an error
+  uint8_t found;               // OUTPUTS_HAS_* flags
+} outputs_stream_t;
+
+static int outputs_stream_cb(void *opaque, json_stream_event_t event, char const *path, char const *value,
+                             size_t len) {
+  outputs_stream_t *ctx = (outputs_stream_t *)opaque;
+  get_outputs_address_t *data = ctx->res->u.output_ids;
+
+  if (event == JSON_STREAM_OBJECT_START && strcmp(path, OUTPUTS_PATH_DATA) == 0) {
+    if (data == NULL && (ctx->res->u.output_ids = outputs_new()) == NULL) {
+      // OOM
+      printf("[%s:%d]: allocate output object failed\n", __func__, __LINE__);
+      return -1;
+    }
+  } else if (event == JSON_STREAM_NUMBER && data) {
+    if (strcmp(path, OUTPUTS_PATH_MAX_RESULTS) == 0) {
+      if (json_stream_to_uint32(value, &data->max_results) != 0) {
+        return -1;
+      }
+      ctx->found |= OUTPUTS_HAS_MAX_RESULTS;
+    } else if (strcmp(path, OUTPUTS_PATH_COUNT) == 0) {
+      if (json_stream_to_uint32(value, &data->count) != 0) {
+        return -1;
+      }
+      ctx->found |= OUTPUTS_HAS_COUNT;
+    } else if (strcmp(path, OUTPUTS_PATH_LEDGER_IDX) == 0) {
+      if (json_stream_to_uint64(value, &data->ledger_idx) != 0) {
+        return -1;
+      }
+      ctx->found |= OUTPUTS_HAS_LEDGER_IDX;
+    }
+  } else if (event == JSON_STREAM_ARRAY_START && data && strcmp(path, OUTPUTS_PATH_IDS) == 0) {
+    ctx->found |= OUTPUTS_HAS_IDS;
+  } else if (event == JSON_STREAM_STRING) {
+    if (data && strcmp(path, OUTPUTS_PATH_ID) == 0) {
+      utarray_push_back(data->outputs, (void *)&value);
+    } else if (data && strcmp(path, OUTPUTS_PATH_ADDR) == 0) {
+      if (len >= sizeof(data->address)) {
+        printf("[%s:%d]: %s too long\n", __func__, __LINE__, JSON_KEY_ADDR);
+        return -1;
+      }
+      memcpy(data->address, value, len + 1);
+      ctx->found |= OUTPUTS_HAS_ADDR;
+    } else if (deser_error_stream(&ctx->err, path, value) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int outputs_stream_end(outputs_stream_t *ctx, int parsed) {
+  res_err_t *err = deser_error_stream_end(ctx->err);
+  if (parsed == 0 && err) {
+    // got an error response
+    outputs_free(ctx->res->u.output_ids);
+    ctx->res->is_error = true;
+    ctx->res->u.error = err;
+    return 0;
+  }
+  res_err_free(err);
+
+  if (parsed == 0 && ctx->res->u.output_ids && ctx->found == OUTPUTS_HAS_ALL) {
+    return 0;
+  }
+  // JSON format mismatched.
+  printf("[%s:%d]: parsing JSON object failed\n", __func__, __LINE__);
+  outputs_free(ctx->res->u.output_ids);
+  ctx->res->u.output_ids = NULL;
+  return -1;
+}
+
 res_outputs_address_t *res_outputs_address_new() {
   res_outputs_address_t *res = malloc(sizeof(res_outputs_address_t));
   if (res) {
@@ -69,70 +163,16 @@ size_t res_outputs_address_output_id_count(res_outputs_address_t *res) {
   return utarray_len(res->u.output_ids->outputs);
 }
 int deser_outputs_from_address(char const *const j_str, res_outputs_address_t *res) {
-  int ret = -1;
   if (j_str == NULL || res == NULL) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
     return -1;
   }
 
-  cJSON *json_obj = cJSON_Parse(j_str);
-  if (json_obj == NULL) {
-    return -1;
-  }
-
-  res_err_t *res_err = deser_error(json_obj);
-  if (res_err) {
-    // got an error response
-    res->is_error = true;
-    res->u.error = res_err;
-    ret = 0;
-    goto end;
-  } else {
-
-    cJSON *data_obj = cJSON_GetObjectItemCaseSensitive(json_obj, JSON_KEY_DATA);
-    if (data_obj) {
-      res->u.output_ids = outputs_new();
-      if (res->u.output_ids == NULL) {
-        // OOM
-        printf("[%s:%d]: allocate output object failed\n", __func__, __LINE__);
-        goto end;
-      }
-      ret = json_get_string(data_obj, JSON_KEY_ADDR, res->u.output_ids->address, sizeof(res->u.output_ids->address));
-      if (ret != 0) {
-        printf("[%s:%d]: gets %s failed\n", __func__, __LINE__, JSON_KEY_ADDR);
-        goto end;
-      }
-      ret = json_get_uint32(data_obj, JSON_KEY_MAX_RESULTS, &res->u.output_ids->max_results);
-      if (ret != 0) {
-        printf("[%s:%d]: gets %s failed\n", __func__, __LINE__, JSON_KEY_MAX_RESULTS);
-        goto end;
-      }
-      ret = json_get_uint32(data_obj, JSON_KEY_COUNT, &res->u.output_ids->count);
-      if (ret != 0) {
-        printf("[%s:%d]: gets %s failed\n", __func__, __LINE__, JSON_KEY_COUNT);
-        goto end;
-      }
-      ret = json_string_array_to_utarray(data_obj, JSON_KEY_OUTPUT_IDS, res->u.output_ids->outputs);
-      if (ret != 0) {
-        printf("[%s:%d]: gets %s failed\n", __func__, __LINE__, JSON_KEY_OUTPUT_IDS);
-        goto end;
-      }
-      ret = json_get_uint64(data_obj, JSON_KEY_LEDGER_IDX, &res->u.output_ids->ledger_idx);
-      if (ret != 0) {
-        printf("[%s:%d]: gets %s failed\n", __func__, __LINE__, JSON_KEY_LEDGER_IDX);
-        goto end;
-      }
-      
-    } else {
-      // JSON format mismatched.
-      printf("[%s:%d]: parsing JSON object failed\n", __func__, __LINE__);
-    }
-  }
-
-end:
-  cJSON_Delete(json_obj);
-
-  return ret;
+  outputs_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, outputs_stream_cb, &stream_ctx);
+  json_stream_feed(&js, j_str, strlen(j_str));
+  return outputs_stream_end(&stream_ctx, json_stream_finish(&js));
 }
 
 int get_outputs_from_address(iota_client_conf_t const *conf, bool is_bech32, char const addr[], res_outputs_address_t *res) {
@@ -168,12 +208,12 @@ int get_outputs_from_address(iota_client_conf_t const *conf, bool is_bech32, cha
     goto done;
   }
 
-  // allocate response
-  http_res.body = byte_buf_new();
-  if (http_res.body == NULL) {
-    printf("[%s:%d]: allocate response failed\n", __func__, __LINE__);
-    goto done;
-  }
+  // the response is parsed while it is received
+  outputs_stream_t stream_ctx = {.res = res, .err = NULL, .found = 0};
+  json_stream_t js;
+  json_stream_init(&js, outputs_stream_cb, &stream_ctx);
+  http_res.body_func = json_stream_http_body;
+  http_res.body_opaque = &js;
   http_res.code = 0;
 
   // http client configuration
@@ -183,7 +223,7 @@ int get_outputs_from_address(iota_client_conf_t const *conf, bool is_bech32, cha
   http_ctx.port = conf->port;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -196,14 +236,13 @@ int get_outputs_from_address(iota_client_conf_t const *conf, bool is_bech32, cha
                   NULL);
   if (ret < 0) {
     printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+    outputs_stream_end(&stream_ctx, -1);
   } else {
-    byte_buf2str(http_res.body);
-    // json deserialization
-    ret = deser_outputs_from_address((char const *)http_res.body->data, res);
+    ret = outputs_stream_end(&stream_ctx, json_stream_finish(&js));
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -211,6 +250,5 @@ int get_outputs_from_address(iota_client_conf_t const *conf, bool is_bech32, cha
 
 done:
   // cleanup command
-  byte_buf_free(http_res.body);
   return ret;
 }
@@ -3,11 +3,64 @@
 
 #include <stdio.h>
 
+#include "client/api/json_stream.h"
 #include "client/api/json_utils.h"
 #include "client/api/v1/get_tips.h"
 #include "client/network/http_lib.h"
 #include "core/utils/iota_str.h"
 
+// JSON paths of the streamed values
+#define TIPS_PATH_IDS "data.tipMessageIds"
+#define TIPS_PATH_ID "data.tipMessageIds[]"
+
+// the state of a streamed tips response
+typedef struct {
+  res_tips_t *res;  // the response, u.tips is filled while parsing
+  res_err_t *err;   // the error object if the node returned an error
+} tips_stream_t;
+
+static int tips_stream_cb(void *opaque, json_stream_event_t event, char const *path, char const *value, size_t len) {
+  tips_stream_t *ctx = (tips_stream_t *)opaque;
+  (void)len;
+
+  if (event == JSON_STREAM_ARRAY_START && strcmp(path, TIPS_PATH_IDS) == 0) {
+    if (ctx->res->u.tips == NULL) {
+      utarray_new(ctx->res->u.tips, &ut_str_icd);
+    }
+  } else if (event == JSON_STREAM_STRING) {
+    if (ctx->res->u.tips && strcmp(path, TIPS_PATH_ID) == 0) {
+      utarray_push_back(ctx->res->u.tips, (void *)&value);
+    } else if (deser_error_stream(&ctx->err, path, value) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int tips_stream_end(tips_stream_t *ctx, int parsed) {
+  res_err_t *err = deser_error_stream_end(ctx->err);
+  if (parsed == 0 && err) {
+    // got an error response
+    if (ctx->res->u.tips) {
+      utarray_free(ctx->res->u.tips);
+    }
+    ctx->res->is_error = true;
+    ctx->res->u.error = err;
+    return 0;
+  }
+  res_err_free(err);
+
+  if (parsed == 0 && ctx->res->u.tips) {
+    return 0;
+  }
+  printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_TIP_MSG_IDS);
+  if (ctx->res->u.tips) {
+    utarray_free(ctx->res->u.tips);
+    ctx->res->u.tips = NULL;
+  }
+  return -1;
+}
+
 int get_tips(iota_client_conf_t const *conf, res_tips_t *res) {
   int ret = -1;
   char const *const cmd_tips = "/api/v1/tips";
@@ -15,12 +68,17 @@ int get_tips(iota_client_conf_t const *conf, res_tips_t *res) {
   http_response_t http_res;
   memset(&http_res, 0, sizeof(http_response_t));
 
-  // allocate response
-  http_res.body = byte_buf_new();
-  if (http_res.body == NULL) {
-    printf("[%s:%d]: allocate response failed\n", __func__, __LINE__);
-    goto done;
+  if (conf == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
   }
+
+  // the response is parsed while it is received
+  tips_stream_t stream_ctx = {.res = res, .err = NULL};
+  json_stream_t js;
+  json_stream_init(&js, tips_stream_cb, &stream_ctx);
+  http_res.body_func = json_stream_http_body;
+  http_res.body_opaque = &js;
   http_res.code = 0;
 
   // http client configuration
@@ -30,7 +88,7 @@ int get_tips(iota_client_conf_t const *conf, res_tips_t *res) {
   http_ctx.port = conf->port;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto done;
@@ -43,23 +101,19 @@ int get_tips(iota_client_conf_t const *conf, res_tips_t *res) {
                   NULL);
   if (ret < 0) {
     printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+    tips_stream_end(&stream_ctx, -1);
   } else {
-    byte_buf2str(http_res.body);
-    // json deserialization
-    ret = deser_get_tips((char const *)http_res.body->data, res);
+    ret = tips_stream_end(&stream_ctx, json_stream_finish(&js));
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
   }
 
 done:
-  // cleanup command
-  byte_buf_free(http_res.body);
-
   return ret;
 }
 
@@ -88,44 +142,18 @@ void res_tips_free(res_tips_t *tips) {
 }
 
 int deser_get_tips(char const *const j_str, res_tips_t *res) {
-  int ret = -1;
   if (j_str == NULL || res == NULL) {
     printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
     return -1;
   }
 
-  cJSON *json_obj = cJSON_Parse(j_str);
-  if (json_obj == NULL) {
-    return -1;
-  }
-
-  res_err_t *res_err = deser_error(json_obj);
-  if (res_err) {
-    // got an error response
-    res->is_error = true;
-    res->u.error = res_err;
-    ret = 0;
-    goto end;
-  } else {
-
-    cJSON *data_obj = cJSON_GetObjectItemCaseSensitive(json_obj, JSON_KEY_DATA);
-    if (data_obj) {
-      utarray_new(res->u.tips, &ut_str_icd);
-      if ((ret = json_string_array_to_utarray(data_obj, JSON_KEY_TIP_MSG_IDS, res->u.tips)) != 0) {
-        printf("[%s:%d]: parsing %s failed\n", __func__, __LINE__, JSON_KEY_TIP_MSG_IDS);
-        utarray_free(res->u.tips);
-        res->u.tips = NULL;
-        goto end;
-      }
-    }
-  }
-
-end:
-  cJSON_Delete(json_obj);
-  return ret;
+  tips_stream_t stream_ctx = {.res = res, .err = NULL};
+  json_stream_t js;
+  json_stream_init(&js, tips_stream_cb, &stream_ctx);
+  json_stream_feed(&js, j_str, strlen(j_str));
+  return tips_stream_end(&stream_ctx, json_stream_finish(&js));
 }
 
-
 size_t get_tips_id_count(res_tips_t *tips) {
   if (tips) {
     if (!tips->is_error && tips->u.tips) {
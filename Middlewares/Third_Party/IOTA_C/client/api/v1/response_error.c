@@ -84,3 +84,59 @@ res_err_t *deser_error(cJSON *j_obj) {
 
   return res_err;
 }
+
+int deser_error_stream(res_err_t **err, char const *path, char const *value) {
+  char **field = NULL;
+  if (err == NULL || path == NULL || value == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // error fields are at error.code and error.message
+  size_t key_len = strlen(JSON_KEY_ERROR);
+  if (strncmp(path, JSON_KEY_ERROR, key_len) != 0 || path[key_len] != '.') {
+    return 0;
+  }
+  path += key_len + 1;
+
+  if (*err == NULL) {
+    *err = malloc(sizeof(res_err_t));
+    if (*err == NULL) {
+      printf("[%s:%d] OOM\n", __func__, __LINE__);
+      return -1;
+    }
+    (*err)->code = NULL;
+    (*err)->msg = NULL;
+  }
+
+  if (strcmp(path, JSON_KEY_CODE) == 0) {
+    field = &(*err)->code;
+  } else if (strcmp(path, JSON_KEY_MSG) == 0) {
+    field = &(*err)->msg;
+  } else {
+    // other fields are ignored
+    return 1;
+  }
+
+  size_t len = strlen(value);
+  char *str = malloc(len + 1);
+  if (str == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  memcpy(str, value, len + 1);
+  if (*field) {
+    free(*field);
+  }
+  *field = str;
+  return 1;
+}
+
+res_err_t *deser_error_stream_end(res_err_t *err) {
+  if (err && (err->code == NULL || err->msg == NULL)) {
+    printf("[%s:%d] incomplete error object\n", __func__, __LINE__);
+    res_err_free(err);
+    return NULL;
+  }
+  return err;
+}
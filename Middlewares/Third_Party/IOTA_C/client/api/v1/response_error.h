@@ -53,6 +53,24 @@ void res_err_free(res_err_t *err);
 
 res_err_t *deser_error(cJSON *j_obj);
 
+/**
+ * @brief Stores an error field reported by a JSON stream parser
+ *
+ * @param[in,out] err The error object, allocated with the first field
+ * @param[in] path The path of the value
+ * @param[in] value The string value
+ * @return int 1 if the value is an error field, 0 if not, -1 on failure
+ */
+int deser_error_stream(res_err_t **err, char const *path, char const *value);
+
+/**
+ * @brief Validates an error object built by deser_error_stream
+ *
+ * @param[in] err The error object, may be NULL
+ * @return res_err_t* The error object if both code and message are set, else NULL and the object is freed
+ */
+res_err_t *deser_error_stream_end(res_err_t *err);
+
 /**
  * @}
  */
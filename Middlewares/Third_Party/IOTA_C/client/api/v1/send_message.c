@@ -2,33 +2,24 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "client/api/json_utils.h"
+#include "client/api/json_writer.h"
 #include "client/api/message_builder.h"
+#include "client/api/v1/get_node_info.h"
 #include "client/api/v1/get_tips.h"
 #include "client/api/v1/send_message.h"
+#include "core/utils/byte_buffer.h"
 #include "core/utils/iota_str.h"
 #include "client/network/http_lib.h"
+#include "crypto/iota_crypto.h"
 
 char const* const cmd_msg = "/api/v1/messages";
 
-// create JSON object and put the JSON string in byte_buf_t that can send by http client.
-int serialize_indexation(message_t* msg, byte_buf_t* buf) {
-  int ret = -1;
-  byte_buf_t* hex_data = NULL;
-  byte_buf_t* hex_index = NULL;
-  char* json_string = NULL;
-
-  if (msg == NULL || buf == NULL) {
-    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
-    return -1;
-  }
-
-  cJSON* json_root = cJSON_CreateObject();
-  if (!json_root) {
-    printf("[%s:%d] create json root object failed\n", __func__, __LINE__);
-    return -1;
-  }
+// write the indexation message, the same calls are used to compute the length and to fill the buffer
+static void indexation_write(json_writer_t* w, message_t* msg) {
+  payload_index_t* payload = (payload_index_t*)msg->payload;
 
   /*
   { "networkId": "",
@@ -37,82 +28,72 @@ int serialize_indexation(message_t* msg, byte_buf_t* buf) {
         "9f5066de0e3225f062e9ac8c285306f56815677fe5d1db0bbccecfc8f7f1e82c"
     ],
   */
-  if (!cJSON_AddStringToObject(json_root, JSON_KEY_NET_ID, "")) {
-    printf("[%s:%d] networkId object failed\n", __func__, __LINE__);
-    goto end;
-  } else {
+  json_writer_object_start(w);
+  json_writer_key(w, JSON_KEY_NET_ID);
+  json_writer_string(w, "");
+  json_writer_key(w, JSON_KEY_PARENT_IDS);
+  json_writer_array_start(w);
+  char** p = NULL;
+  while ((p = (char**)utarray_next(msg->parent_msg_ids, p)) != NULL) {
+    json_writer_string(w, *p);
+  }
+  json_writer_array_end(w);
 
-    if (utarray_to_json_string_array(msg->parent_msg_ids, json_root, JSON_KEY_PARENT_IDS) != JSON_OK) {
-      printf("[%s:%d] add parents failed\n", __func__, __LINE__);
-      goto end;
-    } else {
+  /*
+  "payload": {
+    "type": 2,
+    "index": "iota.c",
+    "data": "48656c6c6f"
+  },
+  */
+  json_writer_key(w, JSON_KEY_PAYLOAD);
+  json_writer_object_start(w);
+  json_writer_key(w, JSON_KEY_TYPE);
+  json_writer_uint64(w, 2);
+  json_writer_key(w, JSON_KEY_INDEX);
+  json_writer_hex(w, payload->index->data, byte_buf_str_len(payload->index));
+  json_writer_key(w, JSON_KEY_DATA);
+  json_writer_hex(w, payload->data->data, byte_buf_str_len(payload->data));
+  json_writer_object_end(w);
 
-        /*
-        "payload": {
-        "type": 2,
-        "index": "iota.c",
-        "data": "48656c6c6f"
-      },
-        */
-        cJSON* json_payload = cJSON_AddObjectToObject(json_root, JSON_KEY_PAYLOAD);
-        if (json_payload) {
-          payload_index_t* payload = (payload_index_t*)msg->payload;
-          if (!cJSON_AddNumberToObject(json_payload, JSON_KEY_TYPE, 2)) {
-            printf("[%s:%d] payload/type object failed\n", __func__, __LINE__);
-            goto end;
-          }
-
-          if ((hex_index = byte_buf_str2hex(payload->index)) != NULL) {
-            if (!cJSON_AddStringToObject(json_payload, JSON_KEY_INDEX, (char const *)hex_index->data)) {
-              printf("[%s:%d] payload/index object failed\n", __func__, __LINE__);
-              goto end;
-            }
-          } else {
-            printf("[%s:%d] payload/index serialization failed\n", __func__, __LINE__);
-            goto end;
-          }
-          
-          if ((hex_data = byte_buf_str2hex(payload->data)) != NULL) {
-            if (!cJSON_AddStringToObject(json_payload, JSON_KEY_DATA, (char const *)hex_data->data)) {
-              printf("[%s:%d] payload/data object failed\n", __func__, __LINE__);
-              goto end;
-            }
-          } else {
-            printf("[%s:%d] payload/data serialization failed\n", __func__, __LINE__);
-            goto end;
-          }
-          
-          /*
-          "nonce": "" }
-          */
-          if (!cJSON_AddStringToObject(json_root, JSON_KEY_NONCE, "")) {
-            printf("[%s:%d] nonce object failed\n", __func__, __LINE__);
-            goto end;
-          }
-          
-          // dump json object to a string
-          if ((json_string = cJSON_PrintUnformatted(json_root)) == NULL) {
-            printf("[%s:%d] json string print failed\n", __func__, __LINE__);
-            goto end;
-          }
-          
-          if (byte_buf_append(buf, (byte_t*)json_string, strlen(json_string) + 1) == false) {
-            printf("[%s:%d] append json to buffer failed\n", __func__, __LINE__);
-            goto end;
-          }
-          ret = 0;
-        }
-    }
+  /*
+  "nonce": "" }
+  */
+  json_writer_key(w, JSON_KEY_NONCE);
+  json_writer_string(w, "");
+  json_writer_object_end(w);
+}
+
+// write the JSON string into byte_buf_t that can send by http client.
+int serialize_indexation(message_t* msg, byte_buf_t* buf) {
+  json_writer_t w;
+
+  if (msg == NULL || buf == NULL || msg->payload == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
   }
 
-end:
-  cJSON_Delete(json_root);
-  byte_buf_free(hex_data);
-  byte_buf_free(hex_index);
-  if (json_string) {
-    free(json_string);
+  payload_index_t* payload = (payload_index_t*)msg->payload;
+  if (payload->index == NULL || payload->data == NULL) {
+    printf("[%s:%d] invalid indexation payload\n", __func__, __LINE__);
+    return -1;
   }
-  return ret;
+
+  // first pass computes the exact length
+  json_writer_init(&w, NULL);
+  indexation_write(&w, msg);
+  size_t json_len = w.len;
+  if (byte_buf_reserve(buf, buf->len + json_len + 1) == false) {
+    printf("[%s:%d] allocate buffer failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  json_writer_init(&w, (char*)buf->data + buf->len);
+  indexation_write(&w, msg);
+  buf->data[buf->len + json_len] = '\0';
+  // the data length includes string terminator
+  buf->len += json_len + 1;
+  return 0;
 }
 
 int deser_send_message_response(char const* json_str, res_send_message_t* res) {
@@ -156,6 +137,7 @@ int send_message(iota_client_conf_t const* const conf, message_t* msg, res_send_
   byte_buf_t* json_data = byte_buf_new();
   http_context_t http_ctx;
   http_response_t http_res;
+  memset(&http_res, 0, sizeof(http_response_t));
   http_res.body = byte_buf_new();
   if (!json_data || !http_res.body) {
     printf("[%s:%d] allocate http buffer failed\n", __func__, __LINE__);
@@ -192,7 +174,7 @@ int send_message(iota_client_conf_t const* const conf, message_t* msg, res_send_
 
   // http open
   //printf("[%s:%d]: Opening HTTP session...\n", __func__, __LINE__);
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto end;
@@ -214,7 +196,7 @@ int send_message(iota_client_conf_t const* const conf, message_t* msg, res_send_
 
   // http close
   //printf("[%s:%d]: Closing HTTP session...\n", __func__, __LINE__);
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
@@ -284,55 +266,98 @@ done:
   return ret;
 }
 
-int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg, res_send_message_t* res) {
+// add the tips of the node as parents of the message
+static int core_message_add_tips(iota_client_conf_t const* const conf, core_message_t* msg) {
   int ret = -1;
-  byte_buf_t* json_data = byte_buf_new();
-  http_response_t http_res;
-  http_context_t http_ctx;
-  http_res.body = byte_buf_new();
-  http_res.code = 0;
   res_tips_t* tips = NULL;
   byte_t tmp_msg_parent[IOTA_MESSAGE_ID_BYTES];
   memset(&tmp_msg_parent, 0, sizeof(tmp_msg_parent));
 
-  if (!json_data || !http_res.body) {
-    printf("[%s:%d] allocate http buffer failed\n", __func__, __LINE__);
-    goto end;
+  if ((tips = res_tips_new()) == NULL) {
+    printf("[%s:%d] allocate tips response failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if ((ret = get_tips(conf, tips)) != 0) {
+    printf("[%s:%d] get tips failed\n", __func__, __LINE__);
+  } else if (tips->is_error) {
+    printf("[%s:%d] get tips failed: %s\n", __func__, __LINE__, tips->u.error->msg);
+    ret = -1;
   } else {
-    if ((tips = res_tips_new()) == NULL) {
-      printf("[%s:%d] allocate tips response failed\n", __func__, __LINE__);
-      goto end;
-    } else {
-      // get tips
-      if ((ret = get_tips(conf, tips)) != 0) {
-        printf("[%s:%d] get tips failed\n", __func__, __LINE__);
-        goto end;
-      } else {
-        if (tips->is_error) {
-          printf("[%s:%d] get tips failed: %s\n", __func__, __LINE__, tips->u.error->msg);
-          goto end;
-        } else {
-          char** p = NULL;
-          p = (char**)utarray_next(tips->u.tips, p);
-          while (p != NULL) {
-            hex_2_bin(*p, STR_TIP_MSG_ID_LEN, tmp_msg_parent, sizeof(tmp_msg_parent));
-            utarray_push_back(msg->parents, tmp_msg_parent);
-            p = (char**)utarray_next(tips->u.tips, p);
-          }
-          char* msg_str = message_to_json(msg);
-          if (!msg_str) {
-            printf("[%s:%d] build message failed\n", __func__, __LINE__);
-            goto end;
-          }
-          // put json string into byte_buf_t
-          json_data->data = (byte_t*)msg_str;
-          json_data->cap = json_data->len = strlen(msg_str) + 1;
-        }
-      }
+    char** p = NULL;
+    p = (char**)utarray_next(tips->u.tips, p);
+    while (p != NULL) {
+      hex_2_bin(*p, STR_TIP_MSG_ID_LEN, tmp_msg_parent, sizeof(tmp_msg_parent));
+      utarray_push_back(msg->parents, tmp_msg_parent);
+      p = (char**)utarray_next(tips->u.tips, p);
     }
   }
 
-  ret = -1;
+  res_tips_free(tips);
+  return ret;
+}
+
+// the network ID is the first 8 bytes of the BLAKE2b-256 hash of the network name, in little endian
+static void core_message_set_network_id(core_message_t* msg, byte_t const hash[]) {
+  msg->network_id = 0;
+  for (int i = (int)sizeof(uint64_t) - 1; i >= 0; i--) {
+    msg->network_id = (msg->network_id << 8) | hash[i];
+  }
+}
+
+// set the network ID if it is not set and get the minimum PoW score, min_pow_score is optional
+static int core_message_apply_node_info(iota_client_conf_t const* const conf, core_message_t* msg,
+                                        uint64_t* min_pow_score) {
+  int ret = -1;
+  byte_t hash[CRYPTO_BLAKE2B_HASH_BYTES];
+  res_node_info_t* info = NULL;
+
+  if ((info = res_node_info_new()) == NULL) {
+    printf("[%s:%d] allocate node info response failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (get_node_info(conf, info) != 0 || info->is_error) {
+    printf("[%s:%d] get node info failed\n", __func__, __LINE__);
+  } else if (msg->network_id == 0 &&
+             iota_blake2b_sum((uint8_t const*)info->u.output_node_info->network_id,
+                              strlen(info->u.output_node_info->network_id), hash, sizeof(hash)) != 0) {
+    printf("[%s:%d] network ID hash failed\n", __func__, __LINE__);
+  } else {
+    if (msg->network_id == 0) {
+      core_message_set_network_id(msg, hash);
+    }
+    if (min_pow_score) {
+      *min_pow_score = info->u.output_node_info->min_pow_score;
+    }
+    ret = 0;
+  }
+
+  res_node_info_free(info);
+  return ret;
+}
+
+// the response body of a message submitted without waiting for its ID is not needed
+static void discard_body(void* opaque, char const* data, int size) {
+  (void)opaque;
+  (void)data;
+  (void)size;
+}
+
+// post a message to the node and parse the response, with a NULL res only the HTTP status is checked
+static int core_message_post(iota_client_conf_t const* const conf, byte_buf_t* body, char const* const content_type,
+                             res_send_message_t* res) {
+  int ret = -1;
+  http_context_t http_ctx;
+  http_response_t http_res;
+  memset(&http_res, 0, sizeof(http_response_t));
+  if (res == NULL) {
+    http_res.body_func = discard_body;
+  } else if ((http_res.body = byte_buf_new()) == NULL) {
+    printf("[%s:%d] allocate http buffer failed\n", __func__, __LINE__);
+    return -1;
+  }
+  http_res.code = 0;
 
   // config http client
   http_ctx.host = conf->host;
@@ -341,7 +366,7 @@ int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg,
   http_ctx.use_tls = conf->use_tls;
 
   // http open
-  ret = http_open(&http_ctx);
+  ret = http_pool_open(&http_ctx);
   if (ret != HTTP_OK) {
     printf("[%s:%d]: Can not open HTTP connection\n", __func__, __LINE__);
     goto end;
@@ -350,10 +375,18 @@ int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg,
   // send request via http client
   ret = http_read(&http_ctx,
                   &http_res,
-                  "Content-Type: application/json",
-                  json_data);
+                  content_type,
+                  body);
   if (ret < 0) {
     printf("[%s:%d]: HTTP read problem\n", __func__, __LINE__);
+  } else if (res == NULL) {
+    // 201 Created, or 200 OK when the node already knows the message
+    if (http_res.code != 200 && http_res.code != 201 && http_res.code != 202) {
+      printf("[%s:%d]: HTTP status %d\n", __func__, __LINE__, http_res.code);
+      ret = -1;
+    } else {
+      ret = 0;
+    }
   } else {
     byte_buf2str(http_res.body);
     // deserialize node response
@@ -361,15 +394,207 @@ int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg,
   }
 
   // http close
-  if (http_close(&http_ctx) != HTTP_OK )
+  if (http_pool_close(&http_ctx) != HTTP_OK )
   {
     printf("[%s:%d]: Can not close HTTP connection\n", __func__, __LINE__);
     ret = -1;
   }
 
 end:
-  byte_buf_free(json_data);
   byte_buf_free(http_res.body);
-  res_tips_free(tips);
   return ret;
 }
+
+// serialize a message in a new buffer
+static byte_buf_t* core_message_to_binary(core_message_t* msg) {
+  byte_buf_t* bin_data = NULL;
+  size_t msg_len = core_message_serialize_length(msg);
+  if (msg_len == 0) {
+    printf("[%s:%d] invalid message\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  if ((bin_data = byte_buf_new()) == NULL || !byte_buf_reserve(bin_data, msg_len)) {
+    printf("[%s:%d] allocate http buffer failed\n", __func__, __LINE__);
+    byte_buf_free(bin_data);
+    return NULL;
+  }
+
+  if ((bin_data->len = core_message_serialize(msg, bin_data->data, bin_data->cap)) != msg_len) {
+    printf("[%s:%d] serialize length miss match\n", __func__, __LINE__);
+    byte_buf_free(bin_data);
+    return NULL;
+  }
+  return bin_data;
+}
+
+// post a serialized message without parsing the response, the message ID is the hash of the bytes sent
+static int core_message_post_binary(iota_client_conf_t const* const conf, byte_t const buf[], size_t len,
+                                    byte_t msg_id[]) {
+  // the body is only read, it can wrap a static or stack buffer
+  byte_buf_t body = {.len = len, .cap = len, .data = (byte_t*)buf};
+
+  if (iota_blake2b_sum(buf, len, msg_id, IOTA_MESSAGE_ID_BYTES) != 0) {
+    printf("[%s:%d] get message ID failed\n", __func__, __LINE__);
+    return -1;
+  }
+  return core_message_post(conf, &body, "Content-Type: application/octet-stream", NULL);
+}
+
+int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg, res_send_message_t* res) {
+  int ret = -1;
+  byte_buf_t* json_data = byte_buf_new();
+
+  if (!json_data) {
+    printf("[%s:%d] allocate http buffer failed\n", __func__, __LINE__);
+    goto end;
+  }
+
+  // get tips
+  if ((ret = core_message_add_tips(conf, msg)) != 0) {
+    goto end;
+  }
+
+  // write the json string into byte_buf_t
+  if ((ret = message_to_json_buf(msg, json_data)) != 0) {
+    printf("[%s:%d] build message failed\n", __func__, __LINE__);
+    goto end;
+  }
+
+  ret = core_message_post(conf, json_data, "Content-Type: application/json", res);
+
+end:
+  byte_buf_free(json_data);
+  return ret;
+}
+
+int send_core_message_prepare(iota_client_conf_t const* const conf, core_message_t* msg) {
+  if (conf == NULL || msg == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // get tips
+  if (core_message_parent_len(msg) == 0 && core_message_add_tips(conf, msg) != 0) {
+    return -1;
+  }
+
+  // the binary form has no null network ID, the node one is used
+  if (msg->network_id == 0 && core_message_apply_node_info(conf, msg, NULL) != 0) {
+    return -1;
+  }
+  return 0;
+}
+
+int send_core_message_binary(iota_client_conf_t const* const conf, core_message_t* msg, res_send_message_t* res) {
+  int ret = -1;
+  byte_buf_t* bin_data = NULL;
+
+  if (conf == NULL || msg == NULL || res == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (send_core_message_prepare(conf, msg) != 0 || (bin_data = core_message_to_binary(msg)) == NULL) {
+    return -1;
+  }
+
+  ret = core_message_post(conf, bin_data, "Content-Type: application/octet-stream", res);
+  byte_buf_free(bin_data);
+  return ret;
+}
+
+int send_prepared_core_message(iota_client_conf_t const* const conf, core_message_t* msg,
+                               byte_t msg_id[IOTA_MESSAGE_ID_BYTES]) {
+  int ret = -1;
+  byte_buf_t* bin_data = NULL;
+
+  if (conf == NULL || msg == NULL || msg_id == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (msg->nonce == 0) {
+    // the node would do the proof-of-work and the ID would change
+    printf("[%s:%d] the message nonce is not set\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if ((bin_data = core_message_to_binary(msg)) == NULL) {
+    return -1;
+  }
+
+  ret = core_message_post_binary(conf, bin_data->data, bin_data->len, msg_id);
+  byte_buf_free(bin_data);
+  return ret;
+}
+
+// fill in the parents and the network ID, and get the score the proof-of-work has to reach
+static int core_message_pow_prepare(iota_client_conf_t const* const conf, core_message_t* msg,
+                                    uint64_t* min_pow_score) {
+  // get tips
+  if (core_message_parent_len(msg) == 0 && core_message_add_tips(conf, msg) != 0) {
+    return -1;
+  }
+
+  // one node info request gives the network ID and the score to reach
+  return core_message_apply_node_info(conf, msg, min_pow_score);
+}
+
+// the proof-of-work, the message ID and the post share the buffer
+static int core_message_pow_send(iota_client_conf_t const* const conf, core_message_t* msg,
+                                 pow_worker_t const* worker, uint64_t min_pow_score, byte_t buf[], size_t buf_len,
+                                 byte_t msg_id[]) {
+  if (core_message_pow_buf(msg, min_pow_score, worker, buf, buf_len) != 0) {
+    printf("[%s:%d] proof-of-work failed\n", __func__, __LINE__);
+    return -1;
+  }
+  return core_message_post_binary(conf, buf, core_message_serialize_length(msg), msg_id);
+}
+
+int send_core_message_pow(iota_client_conf_t const* const conf, core_message_t* msg, pow_worker_t const* worker,
+                          byte_t msg_id[IOTA_MESSAGE_ID_BYTES]) {
+  int ret = -1;
+  uint64_t min_pow_score = 0;
+
+  if (conf == NULL || msg == NULL || msg_id == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (core_message_pow_prepare(conf, msg, &min_pow_score) != 0) {
+    return -1;
+  }
+
+  size_t msg_len = core_message_serialize_length(msg);
+  if (msg_len == 0) {
+    printf("[%s:%d] invalid message\n", __func__, __LINE__);
+    return -1;
+  }
+
+  byte_t* b_msg = malloc(msg_len);
+  if (b_msg == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  ret = core_message_pow_send(conf, msg, worker, min_pow_score, b_msg, msg_len, msg_id);
+  free(b_msg);
+  return ret;
+}
+
+int send_core_message_pow_buf(iota_client_conf_t const* const conf, core_message_t* msg, pow_worker_t const* worker,
+                              byte_t buf[], size_t buf_len, byte_t msg_id[IOTA_MESSAGE_ID_BYTES]) {
+  uint64_t min_pow_score = 0;
+
+  if (conf == NULL || msg == NULL || buf == NULL || msg_id == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (core_message_pow_prepare(conf, msg, &min_pow_score) != 0) {
+    return -1;
+  }
+
+  return core_message_pow_send(conf, msg, worker, min_pow_score, buf, buf_len, msg_id);
+}
@@ -11,6 +11,7 @@
 #include "client/api/v1/response_error.h"
 #include "client/client_service.h"
 #include "core/models/models_message.h"
+#include "core/pow.h"
 #include "core/types.h"
 
 /** @addtogroup IOTA_C
@@ -107,6 +108,77 @@ int send_message(iota_client_conf_t const* const conf, message_t* msg, res_send_
  */
 int send_core_message(iota_client_conf_t const* const conf, core_message_t* msg, res_send_message_t* res);
 
+/**
+ * @brief Send message thought core message object in its binary form
+ *
+ * The message is posted as application/octet-stream, less than half of the JSON size. Parents and network ID are
+ * filled in with send_core_message_prepare().
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg A core message
+ * @param[out] res An error or message ID
+ * @return int 0 on success
+ */
+int send_core_message_binary(iota_client_conf_t const* const conf, core_message_t* msg, res_send_message_t* res);
+
+/**
+ * @brief Fill in the parents and the network ID of a message from the node, if they are not set
+ *
+ * After this call the message can be finalized, e.g. with a local proof-of-work, and its ID computed with
+ * core_message_id().
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg A core message
+ * @return int 0 on success
+ */
+int send_core_message_prepare(iota_client_conf_t const* const conf, core_message_t* msg);
+
+/**
+ * @brief Send a complete message in its binary form without parsing the response
+ *
+ * The message ID is computed locally from the bytes sent, so a resubmission of the same message is idempotent and
+ * gives the same ID. The nonce must be set.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg A core message with parents, network ID and nonce
+ * @param[out] msg_id The message ID
+ * @return int 0 on success
+ */
+int send_prepared_core_message(iota_client_conf_t const* const conf, core_message_t* msg,
+                               byte_t msg_id[IOTA_MESSAGE_ID_BYTES]);
+
+/**
+ * @brief Send a message after a local proof-of-work
+ *
+ * Parents and network ID are filled in if they are not set, the nonce is searched against the minimum PoW score of
+ * the node, so the node does not need remote PoW.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg A core message
+ * @param[in] worker The search partition and cancel callback, NULL for a single worker
+ * @param[out] msg_id The message ID
+ * @return int 0 on success, -1 on failure or if cancelled
+ */
+int send_core_message_pow(iota_client_conf_t const* const conf, core_message_t* msg, pow_worker_t const* worker,
+                          byte_t msg_id[IOTA_MESSAGE_ID_BYTES]);
+
+/**
+ * @brief Send a message after a local proof-of-work, in a caller buffer
+ *
+ * The same as send_core_message_pow(), the proof-of-work, the message ID and the post share the buffer, no heap is
+ * used for the message. If the tips are not added yet, the buffer needs room for MESSAGE_MAX_PARENTS parents.
+ *
+ * @param[in] conf The client endpoint configuration
+ * @param[in] msg A core message
+ * @param[in] worker The search partition and cancel callback, NULL for a single worker
+ * @param[out] buf A buffer holds the serialized message
+ * @param[in] buf_len The size of the buffer
+ * @param[out] msg_id The message ID
+ * @return int 0 on success, -1 on failure, if cancelled or if the buffer is too small
+ */
+int send_core_message_pow_buf(iota_client_conf_t const* const conf, core_message_t* msg, pow_worker_t const* worker,
+                              byte_t buf[], size_t buf_len, byte_t msg_id[IOTA_MESSAGE_ID_BYTES]);
+
 /**
  * @}
  */
@@ -19,6 +19,7 @@
 
 /* Includes ------------------------------------------------------------------*/
 
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
@@ -34,10 +35,40 @@
 #define HTTP_HEADER             "HTTP/1.1"
 
 /* Private typedef -----------------------------------------------------------*/
+/**
+ * @brief Keep-alive connection pool entry, keyed by host/port/use_tls.
+ */
+typedef struct {
+  int32_t sock;                         /**< Network socket handle. */
+  char host[IOTA_ENDPOINT_MAX_LEN];     /**< Domain name or IP as string */
+  uint16_t port;                        /**< port to connect */
+  bool use_tls;                         /**< Use TLS or not */
+  bool is_open;                         /**< The socket is connected. */
+  bool in_use;                          /**< The connection is owned by an http_context_t. */
+  uint32_t last_used;                   /**< Pool access counter value of the last release, for LRU eviction. */
+} http_pool_entry_t;
+
+/**
+ * @brief Response parsing context, passed as opaque pointer to the tinyhttp callbacks.
+ */
+typedef struct {
+  http_response_t *response;            /**< Caller response object. */
+  http_context_t *ctx;                  /**< Session the response is read from. */
+} http_read_ctx_t;
 
 /* Private variables ----------------------------------------------------------*/
+/* The pool entries, counter and profile pointer are shared by the tasks, under net_shared_lock(). */
+static http_pool_entry_t http_pool[HTTP_POOL_SIZE];
+static uint32_t http_pool_counter = 0;
+static net_tls_profile_t *http_tls_profile = NULL;  /**< Parsed root CA shared by all the TLS sessions. */
+
 /* Private function prototypes -----------------------------------------------*/
 static int http_connect(http_context_t *http_context, sockaddr_in_t *addr);
+static int http_reconnect(http_context_t * const pCtx);
+static int http_transact(http_context_t * const pCtx, http_response_t* response,
+                         char const *req_buf, int send_bytes, byte_buf_t* const post_buffer,
+                         bool *can_retry);
+static int32_t http_tls_profile_get(net_tls_profile_t **profile);
 
 /* Functions Definition ------------------------------------------------------*/
 
@@ -106,6 +137,44 @@ int http_req_create(char *req_buf,
   return rc; /* Return the string length, or a <0 error code. */
 }
 
+/**
+ * @brief   Get the TLS profile shared by the HTTP sessions, it is created on first use.
+ * @param   Out: profile    The shared profile.
+ * @retval  NET_OK on success, a NET error code otherwise
+ */
+static int32_t http_tls_profile_get(net_tls_profile_t **profile)
+{
+  int32_t ret = NET_OK;
+  net_tls_profile_t *created = NULL;
+
+  net_shared_lock();
+  *profile = http_tls_profile;
+  net_shared_unlock();
+
+  if (*profile == NULL)
+  {
+    /* Parse the root CA once, the profile is then shared by every TLS socket */
+    net_tls_profile_conf_t tls_conf = {0};
+    tls_conf.tls_ca_certs = lUserConfigPtr->tls_root_ca_cert;
+    tls_conf.tls_srv_verification = false;
+    ret = net_tls_profile_create(&created, &tls_conf);
+    if (ret == NET_OK)
+    {
+      net_shared_lock();
+      if (http_tls_profile == NULL)
+      {
+        http_tls_profile = created;
+        created = NULL;
+      }
+      *profile = http_tls_profile;
+      net_shared_unlock();
+      /* Created by another task meanwhile. */
+      net_tls_profile_release(created);
+    }
+  }
+  return ret;
+}
+
 static int http_connect(http_context_t *pCtx, sockaddr_in_t *addr)
 {
   int ret = 0;
@@ -140,6 +209,8 @@ int http_open(http_context_t * const pCtx)
   if (pCtx != NULL)
   {
     pCtx->connection_is_open = false;
+    pCtx->connection_reused = false;
+    pCtx->pool_slot = -1;
 
     sockaddr_in_t addr;
     addr.sin_len = sizeof(sockaddr_in_t);
@@ -164,14 +235,12 @@ int http_open(http_context_t * const pCtx)
       {
 #define NET_READ_TIMEOUT 30000
         uint32_t timeout = NET_READ_TIMEOUT;
-        bool false_val = false;
-        //bool true_val = true;
-        ret  = net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_SECURE, NULL, 0);
+        net_tls_profile_t *profile = NULL;
+        ret = http_tls_profile_get(&profile);
+        ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_SECURE, NULL, 0);
         ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_RCVTIMEO, (void *) &timeout, sizeof(uint32_t));
-        ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_TLS_CA_CERT, (void *)lUserConfigPtr->tls_root_ca_cert, strlen(lUserConfigPtr->tls_root_ca_cert) + 1);
+        ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_TLS_PROFILE, (void *) &profile, sizeof(profile));
         ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_TLS_SERVER_NAME, (void *)pCtx->host, strlen(pCtx->host) + 1);
-        //ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_TLS_SERVER_VERIFICATION, (void *) &true_val, sizeof(bool));
-        ret |= net_setsockopt(pCtx->sock, NET_SOL_SOCKET, NET_SO_TLS_SERVER_VERIFICATION, (void *) &false_val, sizeof(bool));
       }
     }
 
@@ -187,6 +256,7 @@ int http_open(http_context_t * const pCtx)
     if (NET_OK != ret)
     {
       msg_http_error("Could not open HTTP session due to previous error...\n");
+      (void) net_closesocket(pCtx->sock);
     }
     else
     {
@@ -210,7 +280,13 @@ int http_close(http_context_t * const pCtx)
 {
   int rc = HTTP_ERR;
 
-  if (pCtx != NULL)
+  if ((pCtx != NULL) && (pCtx->sock < 0))
+  {
+    /* The socket is already closed, e.g. by a failed reconnection. */
+    pCtx->connection_is_open = false;
+    rc = HTTP_OK;
+  }
+  else if (pCtx != NULL)
   {
     int ret = 0;
     ret = net_closesocket(pCtx->sock);
@@ -230,22 +306,302 @@ int http_close(http_context_t * const pCtx)
   return rc;
 }
 
+/**
+ * @brief   Open an HTTP session through the keep-alive connection pool.
+ * @note    An idle pooled connection to the same host/port/use_tls is reused when
+ *          available, so that DNS resolution, TCP connection and TLS handshake are
+ *          only paid once. Otherwise a new connection is opened and kept in the pool.
+ *          When every pool slot is busy, the session falls back to a plain
+ *          http_open() and is closed by http_pool_close().
+ *          The session must be released by http_pool_close().
+ * @param   In: pCtx    Pointer to the session context. host, port and use_tls must be set.
+ * @retval  Error code
+ *            HTTP_OK        (0)  Success
+ *            HTTP_ERR_OPEN (<0)  Failure
+ */
+int http_pool_open(http_context_t * const pCtx)
+{
+  int8_t slot = -1;
+  int32_t evicted = -1;
+  int ret;
+
+  if ((pCtx == NULL) || (pCtx->host == NULL) || (strlen(pCtx->host) >= IOTA_ENDPOINT_MAX_LEN))
+  {
+    return HTTP_ERR_OPEN;
+  }
+
+  net_shared_lock();
+  http_pool_counter++;
+
+  /* Look for an idle connection to the same endpoint. */
+  for (int8_t i = 0; i < HTTP_POOL_SIZE; i++)
+  {
+    http_pool_entry_t *entry = &http_pool[i];
+    if ((entry->is_open == true) && (entry->in_use == false) && (entry->port == pCtx->port) &&
+        (entry->use_tls == pCtx->use_tls) && (strcmp(entry->host, pCtx->host) == 0))
+    {
+      entry->in_use = true;
+      net_shared_unlock();
+      pCtx->sock = entry->sock;
+      pCtx->connection_is_open = true;
+      pCtx->connection_reused = true;
+      pCtx->pool_slot = i;
+      msg_http_debug("Reusing pooled socket #%ld for %s:%d\n", pCtx->sock, pCtx->host, pCtx->port);
+      return HTTP_OK;
+    }
+  }
+
+  /* Otherwise take a free slot, or evict the least recently used idle connection. */
+  for (int8_t i = 0; i < HTTP_POOL_SIZE; i++)
+  {
+    http_pool_entry_t *entry = &http_pool[i];
+    if (entry->in_use == false)
+    {
+      if (entry->is_open == false)
+      {
+        slot = i;
+        break;
+      }
+      if ((slot < 0) || (entry->last_used < http_pool[slot].last_used))
+      {
+        slot = i;
+      }
+    }
+  }
+
+  if (slot >= 0)
+  {
+    /* Reserve the slot, the sockets are not opened or closed under the lock. */
+    if (http_pool[slot].is_open == true)
+    {
+      evicted = http_pool[slot].sock;
+      http_pool[slot].is_open = false;
+    }
+    http_pool[slot].in_use = true;
+  }
+  net_shared_unlock();
+
+  if (slot < 0)
+  {
+    /* The pool is exhausted: the connection is not kept alive. */
+    return http_open(pCtx);
+  }
+
+  if (evicted >= 0)
+  {
+    (void) net_closesocket(evicted);
+  }
+
+  ret = http_open(pCtx);
+
+  net_shared_lock();
+  http_pool_entry_t *entry = &http_pool[slot];
+  if (ret == HTTP_OK)
+  {
+    entry->sock = pCtx->sock;
+    (void) strcpy(entry->host, pCtx->host);
+    entry->port = pCtx->port;
+    entry->use_tls = pCtx->use_tls;
+    entry->is_open = true;
+    pCtx->pool_slot = slot;
+  }
+  else
+  {
+    entry->in_use = false;
+  }
+  net_shared_unlock();
+  return ret;
+}
+
+/**
+ * @brief   Release an HTTP session opened by http_pool_open().
+ * @note    The connection is kept open for the next request to the same endpoint,
+ *          unless it was closed by the server or the session is not pooled.
+ * @param   In: pCtx   Session handle.
+ * @retval  Error code
+ *            HTTP_OK   (0)  Success
+ *            HTTP_ERR (<0)  Failure
+ */
+int http_pool_close(http_context_t * const pCtx)
+{
+  bool keep;
+
+  if (pCtx == NULL)
+  {
+    return HTTP_ERR;
+  }
+
+  if ((pCtx->pool_slot < 0) || (pCtx->pool_slot >= HTTP_POOL_SIZE))
+  {
+    return http_close(pCtx);
+  }
+
+  net_shared_lock();
+  http_pool_entry_t *entry = &http_pool[pCtx->pool_slot];
+  pCtx->pool_slot = -1;
+  entry->in_use = false;
+  entry->last_used = http_pool_counter;
+  /* Server-side close or broken connection: do not keep the socket. */
+  keep = pCtx->connection_is_open;
+  entry->is_open = keep;
+  entry->sock = pCtx->sock;
+  net_shared_unlock();
+
+  return keep ? HTTP_OK : http_close(pCtx);
+}
+
+/**
+ * @brief   Close every idle connection of the pool.
+ * @note    To be called when the network interface goes down, or to release the
+ *          sockets and TLS contexts when no more request is expected.
+ *          The shared TLS profile is released too, it is freed once the
+ *          connections still in use are closed, and parsed again on next open.
+ *          It must not run while another task opens a session.
+ */
+void http_pool_flush(void)
+{
+  int32_t socks[HTTP_POOL_SIZE];
+  int8_t count = 0;
+  net_tls_profile_t *profile;
+
+  net_shared_lock();
+  for (int8_t i = 0; i < HTTP_POOL_SIZE; i++)
+  {
+    http_pool_entry_t *entry = &http_pool[i];
+    if ((entry->is_open == true) && (entry->in_use == false))
+    {
+      socks[count++] = entry->sock;
+      entry->is_open = false;
+    }
+  }
+  profile = http_tls_profile;
+  http_tls_profile = NULL;
+  net_shared_unlock();
+
+  for (int8_t i = 0; i < count; i++)
+  {
+    if (net_closesocket(socks[i]) != NET_OK)
+    {
+      msg_http_error("Could not close and destroy the socket #%ld.\n", socks[i]);
+    }
+  }
+  net_tls_profile_release(profile);
+}
+
+/**
+ * @brief   Replace a broken pooled connection by a new one to the same endpoint.
+ * @param   In: pCtx   Session handle.
+ * @retval  Error code
+ *            HTTP_OK        (0)  Success
+ *            HTTP_ERR_OPEN (<0)  Failure
+ */
+static int http_reconnect(http_context_t * const pCtx)
+{
+  int8_t slot = pCtx->pool_slot;
+  int ret;
+
+  msg_http_debug("Reconnecting socket #%ld to %s:%d\n", pCtx->sock, pCtx->host, pCtx->port);
+  (void) net_closesocket(pCtx->sock);
+  pCtx->connection_is_open = false;
+
+  ret = http_open(pCtx);
+  if (ret != HTTP_OK)
+  {
+    /* http_open() already closed the new socket: it must not be closed again. */
+    pCtx->sock = -1;
+  }
+  /* http_open() resets the pool slot: keep ownership of the previous one. */
+  pCtx->pool_slot = slot;
+  if ((slot >= 0) && (slot < HTTP_POOL_SIZE))
+  {
+    net_shared_lock();
+    http_pool[slot].sock = pCtx->sock;
+    http_pool[slot].is_open = (ret == HTTP_OK);
+    net_shared_unlock();
+  }
+  return ret;
+}
+
 static void response_body(void* opaque, const char* data, int size)
 {
-  http_response_t* response = (http_response_t*)opaque;
-  if (byte_buf_append(response->body, (byte_t*)data, (size_t)size) == false)
+  http_response_t* response = ((http_read_ctx_t*)opaque)->response;
+  if (response->body_func != NULL)
+  {
+    /* Streamed body, e.g. parsed on the fly. */
+    response->body_func(response->body_opaque, data, size);
+  }
+  else if (byte_buf_append(response->body, (byte_t*)data, (size_t)size) == false)
   {
     // OOM or NULL data
     msg_http_error("append data failed\n");
   }
 }
 
+/* Case-insensitive comparison of a non null-terminated header value with a lower-case token. */
+static bool header_value_is(const char* cvalue, int nvalue, const char* token)
+{
+  if (nvalue != (int)strlen(token))
+  {
+    return false;
+  }
+  for (int i = 0; i < nvalue; i++)
+  {
+    if (tolower((int)cvalue[i]) != token[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Reserve the response body buffer once its size is announced, instead of growing it on each chunk. */
+static void response_reserve_body(http_response_t* response, const char* cvalue, int nvalue)
+{
+  size_t content_length = 0;
+
+  if ((response->body == NULL) || (nvalue <= 0) || (nvalue > 9))
+  {
+    /* Missing or unreasonably large length: let the buffer grow. */
+    return;
+  }
+  for (int i = 0; i < nvalue; i++)
+  {
+    if ((cvalue[i] < '0') || (cvalue[i] > '9'))
+    {
+      return;
+    }
+    content_length = (content_length * 10) + (size_t)(cvalue[i] - '0');
+  }
+  if (content_length == 0)
+  {
+    /* Empty body: nothing to reserve. */
+    return;
+  }
+
+  /* One more byte for the string terminator added by the JSON parsers. */
+  if (byte_buf_reserve(response->body, response->body->len + content_length + 1) == false)
+  {
+    msg_http_error("Could not reserve %d bytes for the response body\n", (int)content_length);
+  }
+}
+
 static void response_header(void* opaque, const char* ckey, int nkey, const char* cvalue, int nvalue)
-{ /* doesn't care about headers */ }
+{
+  /* Keys are lower-cased by the parser. */
+  if ((nkey == 10) && (strncmp(ckey, "connection", 10) == 0) && header_value_is(cvalue, nvalue, "close"))
+  {
+    /* The server closes the connection after this response: do not reuse it. */
+    ((http_read_ctx_t*)opaque)->ctx->connection_is_open = false;
+  }
+  else if ((nkey == 14) && (strncmp(ckey, "content-length", 14) == 0))
+  {
+    response_reserve_body(((http_read_ctx_t*)opaque)->response, cvalue, nvalue);
+  }
+}
 
 static void response_code(void* opaque, int code)
 {
-  http_response_t* response = (http_response_t*)opaque;
+  http_response_t* response = ((http_read_ctx_t*)opaque)->response;
   response->code = code;
 }
 
@@ -256,8 +612,115 @@ static http_funcs_t responseFuncs = {
 };
 
 
+/**
+ * @brief   Send an HTTP request and parse the server response on the session socket.
+ * @param   In: pCtx            Session handle.
+ * @param   Out: response       Output response.
+ * @param   In: req_buf         The request header string.
+ * @param   In: send_bytes      The length of the request header string.
+ * @param   In: post_buffer     The POST payload, NULL for a GET request.
+ * @param   Out: can_retry      Set to true on failure when the request was not processed by the server:
+ *                              it was not sent completely, or the connection was closed before any
+ *                              response byte to a request without body. A request with a body is never
+ *                              sent again once sent completely, it may have been processed.
+ * @retval  HTTP_OK, HTTP_ERR_SEND, HTTP_ERR_RECV or HTTP_ERR_PARSE
+ */
+static int http_transact(http_context_t * const pCtx, http_response_t* response,
+                         char const *req_buf, int send_bytes, byte_buf_t* const post_buffer,
+                         bool *can_retry)
+{
+  int rc;
+  bool received = false;
+
+  *can_retry = true;
+
+  /* Send the HTTP headers. */
+  rc = net_send(pCtx->sock, (uint8_t *) req_buf, send_bytes, 0);
+  msg_http_debug("Request (len=%d): \n%s\n", strlen(req_buf), req_buf);
+  msg_http_debug("Send the HTTP headers -- rc/send_bytes (%d/%d).\n", rc, send_bytes);
+  if (rc != send_bytes)
+  {
+    msg_http_error("Header send failed (%d/%d).\n", rc, send_bytes);
+    return HTTP_ERR_SEND;
+  }
+
+  rc = HTTP_OK;
+  /* Send the POST body if applicable. */
+  if (post_buffer != NULL)
+  {
+    int offset = 0;
+    int size_left = post_buffer->len;
+    while(offset < post_buffer->len)
+    {
+      rc = net_send(pCtx->sock, post_buffer->data+offset, size_left, 0);
+      if (rc < 0)
+      {
+        msg_http_error("POST body send failed (%d/%d).\n", rc, post_buffer->len);
+        return HTTP_ERR_SEND;
+      }
+      offset += rc;
+      size_left -= rc;
+
+      rc = HTTP_OK;
+    }
+  }
+
+  /* Get and parse the server response. */
+  msg_http_debug("After sending POST body rc (%d).\n", rc);
+  *can_retry = false;
+#ifdef NET_PERF
+  uint32_t elapsed_time;
+  uint32_t start_time;
+  start_time = NET_TICK();
+#endif /* NET_PERF */
+  http_read_ctx_t read_ctx = { response, pCtx };
+  http_roundtripper_t rt;
+  http_parser_init(&rt, responseFuncs, &read_ctx);
+
+  bool needmore = true;
+  uint8_t buffer[HTTP_READ_BUFFER_SIZE];
+  while (needmore) {
+    const char* data = (char *)buffer;
+    int ndata = net_recv(pCtx->sock, buffer, sizeof(buffer), 0);
+    if (ndata < 0) {
+      msg_http_error("Error receiving data (ret=%d)\n", ndata);
+      http_parser_reset(&rt);
+      /* A timeout does not tell if the request was processed. */
+      *can_retry = (ndata == NET_ERROR_DISCONNECTED) && (received == false) && (post_buffer == NULL);
+      return HTTP_ERR_RECV;
+    }
+    if (ndata > 0) {
+      received = true;
+    }
+
+    while (needmore && ndata) {
+      int read;
+      needmore = http_parser_data(&rt, data, ndata, &read);
+      ndata -= read;
+      data += read;
+    }
+  }
+
+  if (http_parser_iserror(&rt)) {
+    msg_http_error("Error parsing data\n");
+    http_parser_reset(&rt);
+    return HTTP_ERR_PARSE;
+  }
+
+  http_parser_reset(&rt);
+#ifdef NET_PERF
+  elapsed_time = NET_TICK() - start_time;
+  msg_http_debug("Duration recv response %d ms \n", elapsed_time);
+#endif /* NET_PERF */
+  return HTTP_OK;
+}
+
 /**
  * @brief   Read from an HTTP progressive download session.
+ * @note    On a pooled session (see http_pool_open()), a connection closed by the
+ *          server is transparently reopened, and the request is sent again once if
+ *          a reused connection fails before the request is sent completely, or is
+ *          closed before any response byte to a request without body.
  * @param   In: pCtx            Session handle.
  * @param   Out: response       Output response.
  * @param   In: extra_headers   String containing additional HTTP headers to send. Each line must end with \r\n. "" for no header at all.
@@ -278,6 +741,7 @@ int http_read(http_context_t * const pCtx,
 {
   int rc = HTTP_OK;
   int send_bytes = 0;
+  bool can_retry = false;
   char req_buf[512];
   memset(req_buf, 0, sizeof(req_buf));
 
@@ -289,8 +753,16 @@ int http_read(http_context_t * const pCtx,
   {
     if (pCtx->connection_is_open == false)
     {
-      msg_http_error("The connection is not open.\n");
-      rc = HTTP_ERR_CLOSED;
+      if (pCtx->pool_slot >= 0)
+      {
+        /* Closed by the server after the previous response. */
+        rc = (http_reconnect(pCtx) == HTTP_OK) ? HTTP_OK : HTTP_ERR_CLOSED;
+      }
+      else
+      {
+        msg_http_error("The connection is not open.\n");
+        rc = HTTP_ERR_CLOSED;
+      }
     }
   }
   
@@ -305,87 +777,32 @@ int http_read(http_context_t * const pCtx,
       
   if (rc == HTTP_OK) 
   {
-    /* Send the HTTP headers. */
-    rc = net_send(pCtx->sock, (uint8_t *) req_buf, send_bytes, 0);
-    msg_http_debug("Request (len=%d): \n%s\n", strlen(req_buf), req_buf);
-    msg_http_debug("Send the HTTP headers -- rc/send_bytes (%d/%d).\n", rc, send_bytes);
-    if (rc != send_bytes)
-    {
-      msg_http_error("Header send failed (%d/%d).\n", rc, send_bytes);
-      rc = HTTP_ERR_SEND;
-    }
-    else
+    rc = http_transact(pCtx, response, req_buf, send_bytes, post_buffer, &can_retry);
+    if ((rc != HTTP_OK) && (can_retry == true) && (pCtx->connection_reused == true) && (pCtx->pool_slot >= 0))
     {
-      rc = HTTP_OK;
-      /* Send the POST body if applicable. */
-      if (post_buffer != NULL)
+      /* The idle connection was dropped by the server meanwhile: retry on a new one. */
+      msg_http_debug("Pooled connection is stale, retrying.\n");
+      pCtx->connection_reused = false;
+      rc = http_reconnect(pCtx);
+      if (rc == HTTP_OK)
       {
-        int offset = 0;
-        int size_left = post_buffer->len;
-        while(offset < post_buffer->len)
-        {
-          rc = net_send(pCtx->sock, post_buffer->data+offset, size_left, 0);
-          if (rc < 0)
-          {
-            msg_http_error("POST body send failed (%d/%d).\n", rc, post_buffer->len);
-            rc = HTTP_ERR_SEND;
-            break;
-          }
-          offset += rc;
-          size_left -= rc;
-
-          rc = HTTP_OK;
-        }
+        rc = http_transact(pCtx, response, req_buf, send_bytes, post_buffer, &can_retry);
       }
-
-      /* Get and parse the server response. */
-      msg_http_debug("After sending POST body rc (%d).\n", rc);
-#ifdef NET_PERF
-      uint32_t elapsed_time;
-      uint32_t start_time;
-      start_time = NET_TICK();
-#endif /* NET_PERF */
-      if (rc == HTTP_OK)
+      else
       {
-        http_roundtripper_t rt;
-        http_parser_init(&rt, responseFuncs, response);
-
-        bool needmore = true;
-        uint8_t buffer[HTTP_READ_BUFFER_SIZE];
-        while (needmore) {
-          const char* data = (char *)buffer;
-          int ndata = net_recv(pCtx->sock, buffer, sizeof(buffer), 0);
-          if (ndata < 0) {
-            msg_http_error("Error receiving data (ret=%d)\n", ndata);
-            http_parser_reset(&rt);
-            return HTTP_ERR_RECV;
-          }
-
-          while (needmore && ndata) {
-            int read;
-            needmore = http_parser_data(&rt, data, ndata, &read);
-            ndata -= read;
-            data += read;
-          }
-        }
-
-        if (http_parser_iserror(&rt)) {
-          msg_http_error("Error parsing data\n");
-          http_parser_reset(&rt);
-          return HTTP_ERR_PARSE;
-        }
-
-        http_parser_reset(&rt);
+        rc = HTTP_ERR_CLOSED;
       }
-#ifdef NET_PERF
-      elapsed_time = NET_TICK() - start_time;
-      msg_http_debug("Duration recv response %d ms \n", elapsed_time);
-#endif /* NET_PERF */
+    }
+
+    if (rc != HTTP_OK)
+    {
+      /* Do not give back a connection in an unknown state to the pool. */
+      pCtx->connection_is_open = false;
     }
   }
 
   msg_http_debug("Response: %d\n", response->code);
-  if (response->body->data) {
+  if ((response->body != NULL) && (response->body->data != NULL)) {
     msg_http_debug("response->body->len=%d\n%.*s\n", response->body->len, response->body->len, response->body->data);
   }
   return rc;
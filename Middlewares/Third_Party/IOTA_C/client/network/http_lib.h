@@ -31,6 +31,7 @@
 #include <stdbool.h>
 #include <stdarg.h>
 
+#include "client/client_service.h"
 #include "core/utils/byte_buffer.h"
 
 #include "http.h"
@@ -61,6 +62,10 @@
 #define HTTP_ERR_PARSE         -6  /**< HTTP PARSE error */
 #define HTTP_ERR_CLOSED        -7  /**< The HTTP connection was closed by the server. */
 
+#ifndef HTTP_POOL_SIZE
+#define HTTP_POOL_SIZE         2   /**< Number of keep-alive connections kept open by the connection pool. */
+#endif
+
 /**
  * @}
  */
@@ -81,6 +86,8 @@ typedef struct {
   uint16_t port;                /**< port to connect */
   bool use_tls;                 /**< Use TLS or not */
   bool connection_is_open;      /**< HTTP keep-alive connection status. */
+  bool connection_reused;       /**< The connection was taken over from the pool, it may have been closed by the server meanwhile. */
+  int8_t pool_slot;             /**< Connection pool slot, -1 if the connection is not pooled. */
 } http_context_t;
 
 typedef enum {
@@ -89,10 +96,14 @@ typedef enum {
   HTTP_PROTO_HTTPS
 } http_proto_t;
 
+typedef void (*http_body_func_t)(void* opaque, const char* data, int size);
+
 typedef struct
 {
-  byte_buf_t* body;
-  int code;
+  byte_buf_t* body;             /**< Response body, unused when body_func is set. */
+  int code;                     /**< HTTP status code. */
+  http_body_func_t body_func;   /**< Optional body consumer, called with each received chunk instead of buffering the body. */
+  void* body_opaque;            /**< Context passed to body_func. */
 } http_response_t;
 
 /**
@@ -107,6 +118,10 @@ typedef struct
 int http_open(http_context_t * const pCtx);
 int http_close(http_context_t * const pCtx);
 
+int http_pool_open(http_context_t * const pCtx);
+int http_pool_close(http_context_t * const pCtx);
+void http_pool_flush(void);
+
 int http_read(http_context_t * const pCtx,
               http_response_t* response,
               const char * const extra_headers,
@@ -14,32 +14,55 @@ int address_from_ed25519_pub(byte_t const pub_key[], byte_t addr[]) {
   return iota_blake2b_sum(pub_key, ED_PUBLIC_KEY_BYTES, addr, ED25519_ADDRESS_BYTES);
 }
 
-int address_keypair_from_path(byte_t seed[], size_t seed_len, char path[], iota_keypair_t* keypair) {
+int address_keypair_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len,
+                                 iota_keypair_t* keypair) {
   // derive key from seed
   slip10_key_t key;
   memset(&key, 0, sizeof(slip10_key_t));
   int ret = 0;
-  if ((ret = slip10_key_from_path(seed, seed_len, path, ED25519_CURVE, &key)) != 0) {
+  if ((ret = slip10_key_from_indices(seed, seed_len, path, path_len, ED25519_CURVE, &key)) != 0) {
     printf("[%s:%d] derive key from path failed, err: %d\n", __func__, __LINE__, ret);
     return ret;
   }
 
   // ed25519 keypair from slip10 private key
   iota_crypto_keypair(key.key, keypair);
+  memset(&key, 0, sizeof(slip10_key_t));
   return ret;
 }
 
-int address_from_path(byte_t seed[], size_t seed_len, char path[], byte_t out_addr[]) {
+int address_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len, byte_t out_addr[]) {
   // ed25519 keypair from slip10 private key
   iota_keypair_t addr_keypair;
   memset(&addr_keypair, 0, sizeof(iota_keypair_t));
   int ret = 0;
-  if ((ret = address_keypair_from_path(seed, seed_len, path, &addr_keypair)) == 0) {
-    return address_from_ed25519_pub(addr_keypair.pub, out_addr);
+  if ((ret = address_keypair_from_indices(seed, seed_len, path, path_len, &addr_keypair)) == 0) {
+    ret = address_from_ed25519_pub(addr_keypair.pub, out_addr);
   }
+  memset(&addr_keypair, 0, sizeof(iota_keypair_t));
   return ret;
 }
 
+int address_keypair_from_path(byte_t seed[], size_t seed_len, char path[], iota_keypair_t* keypair) {
+  bip32_path_t bip32_path;
+  memset(&bip32_path, 0, sizeof(bip32_path_t));
+  if (slip10_parse_path(path, &bip32_path) != 0) {
+    printf("[%s:%d] invalid path\n", __func__, __LINE__);
+    return -2;
+  }
+  return address_keypair_from_indices(seed, seed_len, bip32_path.path, (size_t)bip32_path.len, keypair);
+}
+
+int address_from_path(byte_t seed[], size_t seed_len, char path[], byte_t out_addr[]) {
+  bip32_path_t bip32_path;
+  memset(&bip32_path, 0, sizeof(bip32_path_t));
+  if (slip10_parse_path(path, &bip32_path) != 0) {
+    printf("[%s:%d] invalid path\n", __func__, __LINE__);
+    return -2;
+  }
+  return address_from_indices(seed, seed_len, bip32_path.path, (size_t)bip32_path.len, out_addr);
+}
+
 int address_from_bech32(char const* hrp, char const* bech32_str, byte_t out_addr[]) {
   size_t len = 0;
   int ret = iota_addr_bech32_decode(out_addr, &len, hrp, bech32_str);
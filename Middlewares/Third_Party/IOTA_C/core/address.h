@@ -65,6 +65,31 @@ extern "C" {
  */
 int address_from_ed25519_pub(byte_t const pub_key[], byte_t addr[]);
 
+/**
+ * @brief Get Ed25519 keypair from given seed and path indices
+ *
+ * @param[in] seed A seed
+ * @param[in] seed_len The length of seed
+ * @param[in] path The hardened path indices, ex: {44 | BIP32_HARDENED, 4218 | BIP32_HARDENED}
+ * @param[in] path_len The number of indices
+ * @param[out] keypair The ed25519 keypair
+ * @return int 0 on success
+ */
+int address_keypair_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len,
+                                 iota_keypair_t* keypair);
+
+/**
+ * @brief Get address from seed and path indices
+ *
+ * @param[in] seed An IOTA seed
+ * @param[in] seed_len The length of seed
+ * @param[in] path The hardened path indices, ex: {44 | BIP32_HARDENED, 4218 | BIP32_HARDENED}
+ * @param[in] path_len The number of indices
+ * @param[out] out_addr An ed25519 address
+ * @return int 0 on success
+ */
+int address_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len, byte_t out_addr[]);
+
 /**
  * @brief Get Ed25519 keypair from given seed and path
  *
@@ -2,100 +2,114 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "utxo_input.h"
 
 #define UTXO_INPUT_MIN_INDEX 0
 #define UTXO_INPUT_MAX_INDEX 126
 
-utxo_input_ht *utxo_inputs_new(void) {
-  return NULL;
-}
-
-utxo_input_ht *utxo_inputs_find_by_id(utxo_input_ht **inputs, byte_t const tx_id[]) {
-  utxo_input_ht *in = NULL;
-  HASH_FIND(hh, *inputs, tx_id, TRANSACTION_ID_BYTES, in);
-  return in;
-}
-
-uint16_t utxo_inputs_count(utxo_input_ht **ht) {
-  return (uint16_t)HASH_COUNT(*ht);
+// compares inputs as serialized, the transaction ID then the output index in little-endian
+static int input_cmp(utxo_input_t const *elm, byte_t const tx_id[], uint16_t index) {
+  int ret = memcmp(elm->tx_id, tx_id, TRANSACTION_ID_BYTES);
+  if (ret == 0) {
+    ret = (int)(elm->output_index & 0xFF) - (int)(index & 0xFF);
+  }
+  if (ret == 0) {
+    ret = (int)(elm->output_index >> 8) - (int)(index >> 8);
+  }
+  return ret;
 }
 
-void utxo_inputs_free(utxo_input_ht **ht) {
-  utxo_input_ht *curr_elm, *tmp;
-  HASH_ITER(hh, *ht, curr_elm, tmp) {
-    HASH_DEL(*ht, curr_elm);
-    free(curr_elm);
+// binary search, the position of the input or the insertion point if it is not found
+static uint16_t inputs_search(utxo_inputs_t const *inputs, byte_t const tx_id[], uint16_t index, bool *found) {
+  uint16_t low = 0, high = inputs->count;
+  *found = false;
+  while (low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    int cmp = input_cmp(&inputs->elm[mid], tx_id, index);
+    if (cmp == 0) {
+      *found = true;
+      return mid;
+    } else if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
   }
+  return low;
 }
 
-int utxo_inputs_add_with_key(utxo_input_ht **inputs, byte_t const tx_id[], uint16_t index, byte_t const pub[],
-                             byte_t const priv[]) {
+// inserts an input in order, returns NULL on failure
+static utxo_input_t *inputs_insert(utxo_inputs_t *inputs, byte_t const tx_id[], uint16_t index) {
+  bool found = false;
   if (index > UTXO_INPUT_MAX_INDEX) {
     printf("[%s:%d] invalid index\n", __func__, __LINE__);
-    return -1;
+    return NULL;
   }
 
-  if (utxo_inputs_count(inputs) >= UTXO_INPUT_MAX_INDEX) {
+  if (inputs->count >= UTXO_INPUT_MAX_COUNT) {
     printf("[%s:%d] inputs count must be < 127\n", __func__, __LINE__);
-    return -1;
+    return NULL;
   }
 
-  utxo_input_ht *elm = utxo_inputs_find_by_id(inputs, tx_id);
-  if (elm) {
-    printf("[%s:%d] transaction ID exists\n", __func__, __LINE__);
-    return -1;
+  if (inputs->count >= inputs->capacity) {
+    printf("[%s:%d] inputs are full\n", __func__, __LINE__);
+    return NULL;
   }
 
-  elm = malloc(sizeof(utxo_input_ht));
-  if (elm == NULL) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
-    return -1;
+  uint16_t pos = inputs_search(inputs, tx_id, index, &found);
+  if (found) {
+    printf("[%s:%d] output ID exists\n", __func__, __LINE__);
+    return NULL;
   }
+
+  memmove(&inputs->elm[pos + 1], &inputs->elm[pos], (inputs->count - pos) * sizeof(utxo_input_t));
+  inputs->count++;
+  utxo_input_t *elm = &inputs->elm[pos];
+  memset(elm, 0, sizeof(utxo_input_t));
   memcpy(elm->tx_id, tx_id, TRANSACTION_ID_BYTES);
-  memcpy(elm->keypair.pub_key, pub, ED_PUBLIC_KEY_BYTES);
-  memcpy(elm->keypair.priv, priv, ED_PRIVATE_KEY_BYTES);
   elm->output_index = index;
-  HASH_ADD(hh, *inputs, tx_id, TRANSACTION_ID_BYTES, elm);
-  return 0;
+  return elm;
 }
 
-int utxo_inputs_add(utxo_input_ht **inputs, byte_t id[], uint16_t index) {
-  if (index > UTXO_INPUT_MAX_INDEX) {
-    printf("[%s:%d] invalid index\n", __func__, __LINE__);
-    return -1;
-  }
+void utxo_inputs_init(utxo_inputs_t *inputs, utxo_input_t buf[], uint16_t capacity) {
+  inputs->count = 0;
+  inputs->capacity = capacity;
+  inputs->elm = buf;
+}
 
-  if (utxo_inputs_count(inputs) >= UTXO_INPUT_MAX_INDEX) {
-    printf("[%s:%d] inputs count must be < 127\n", __func__, __LINE__);
-    return -1;
-  }
+utxo_input_t *utxo_inputs_find_by_id(utxo_inputs_t const *inputs, byte_t const tx_id[], uint16_t index) {
+  bool found = false;
+  uint16_t pos = inputs_search(inputs, tx_id, index, &found);
+  return found ? &inputs->elm[pos] : NULL;
+}
 
-  utxo_input_ht *elm = utxo_inputs_find_by_id(inputs, id);
-  if (elm) {
-    printf("[%s:%d] transaction ID exists\n", __func__, __LINE__);
-    return -1;
-  }
+uint16_t utxo_inputs_count(utxo_inputs_t const *inputs) {
+  return inputs->count;
+}
 
-  elm = malloc(sizeof(utxo_input_ht));
+int utxo_inputs_add_with_key(utxo_inputs_t *inputs, byte_t const tx_id[], uint16_t index, byte_t const pub[],
+                             byte_t const priv[]) {
+  utxo_input_t *elm = inputs_insert(inputs, tx_id, index);
   if (elm == NULL) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
     return -1;
   }
-  memcpy(elm->tx_id, id, TRANSACTION_ID_BYTES);
-  elm->output_index = index;
-  HASH_ADD(hh, *inputs, tx_id, TRANSACTION_ID_BYTES, elm);
+  memcpy(elm->keypair.pub_key, pub, ED_PUBLIC_KEY_BYTES);
+  memcpy(elm->keypair.priv, priv, ED_PRIVATE_KEY_BYTES);
   return 0;
 }
 
-size_t utxo_inputs_serialization(utxo_input_ht **inputs, byte_t buf[]) {
-  utxo_input_ht *elm, *tmp;
+int utxo_inputs_add(utxo_inputs_t *inputs, byte_t id[], uint16_t index) {
+  return inputs_insert(inputs, id, index) == NULL ? -1 : 0;
+}
+
+size_t utxo_inputs_serialization(utxo_inputs_t const *inputs, byte_t buf[]) {
   size_t byte_count = 0;
-  uint8_t elm_count = 0;
-  HASH_ITER(hh, *inputs, elm, tmp) {
-    // byte_count += elm_count * UTXO_INPUT_SERIALIZED_BYTES;
+  for (uint16_t i = 0; i < inputs->count; i++) {
+    utxo_input_t const *elm = &inputs->elm[i];
     // input type, set to value 0 to denote an UTXO Input.
     memset(buf + byte_count, 0, sizeof(byte_t));
     byte_count += sizeof(byte_t);
@@ -107,24 +121,15 @@ size_t utxo_inputs_serialization(utxo_input_ht **inputs, byte_t buf[]) {
     // index
     memcpy(buf + byte_count, &elm->output_index, sizeof(elm->output_index));
     byte_count += sizeof(elm->output_index);
-
-    elm_count++;
-  }
-
-  if (byte_count != (elm_count * UTXO_INPUT_SERIALIZED_BYTES)) {
-    printf("[%s:%d] offset error\n", __func__, __LINE__);
-    return 0;
   }
-
   return byte_count;
 }
 
-void utxo_inputs_print(utxo_input_ht **inputs) {
-  utxo_input_ht *elm, *tmp;
+void utxo_inputs_print(utxo_inputs_t const *inputs) {
   printf("utxo_inputs: [\n");
-  HASH_ITER(hh, *inputs, elm, tmp) {
-    printf("\t[%d] ", elm->output_index);
-    dump_hex(elm->tx_id, TRANSACTION_ID_BYTES);
+  for (uint16_t i = 0; i < inputs->count; i++) {
+    printf("\t[%d] ", inputs->elm[i].output_index);
+    dump_hex(inputs->elm[i].tx_id, TRANSACTION_ID_BYTES);
   }
   printf("]\n");
 }
@@ -8,7 +8,6 @@
 
 #include "core/types.h"
 #include "crypto/iota_crypto.h"
-#include "uthash.h"
 
 /** @addtogroup IOTA_C
  * @{
@@ -33,6 +32,8 @@
 #define TRANSACTION_ID_BYTES 32
 // Serialized bytes = input type(uint8_t) + transaction id(32bytes) + index(uint16_t)
 #define UTXO_INPUT_SERIALIZED_BYTES (1 + TRANSACTION_ID_BYTES + 2)
+// The maximum number of inputs in a transaction
+#define UTXO_INPUT_MAX_COUNT 126
 
 /**
  * @}
@@ -59,8 +60,19 @@ typedef struct {
   byte_t tx_id[TRANSACTION_ID_BYTES];  ///< The transaction reference from which the UTXO comes from.
   uint16_t output_index;      ///< The index of the output on the referenced transaction to consume 0<= x < 127.
   ed25519_keypair_t keypair;  ///< ed25519 keypair of this input
-  UT_hash_handle hh;
-} utxo_input_ht;
+} utxo_input_t;
+
+/**
+ * @brief A fixed-capacity array of UTXO inputs
+ *
+ * Inputs are kept in lexicographical order of their serialized form, the buffer is owned by the caller.
+ *
+ */
+typedef struct {
+  uint16_t count;     ///< The number of inputs
+  uint16_t capacity;  ///< The number of inputs the buffer holds
+  utxo_input_t *elm;  ///< The sorted inputs
+} utxo_inputs_t;
 
 /**
  * @}
@@ -75,74 +87,70 @@ extern "C" {
  */
 
 /**
- * @brief Initialize an utxo input hash table.
+ * @brief Initialize an empty utxo input array on a buffer
  *
- * @return utxo_inputs_t* a NULL pointer
+ * @param[out] inputs An utxo input array
+ * @param[in] buf A buffer holds capacity inputs
+ * @param[in] capacity The number of inputs in buf
  */
-utxo_input_ht *utxo_inputs_new(void);
+void utxo_inputs_init(utxo_inputs_t *inputs, utxo_input_t buf[], uint16_t capacity);
 
 /**
- * @brief Find an utxo input by a given transaction ID
+ * @brief Find an utxo input by a given transaction ID and output index
  *
- * @param[in] inputs An utxo input hash table
+ * @param[in] inputs An utxo input array
  * @param[in] tx_id A transaction ID
- * @return utxo_input_ht*
+ * @param[in] index An output index
+ * @return utxo_input_t* NULL if not found
  */
-utxo_input_ht *utxo_inputs_find_by_id(utxo_input_ht **inputs, byte_t const tx_id[]);
+utxo_input_t *utxo_inputs_find_by_id(utxo_inputs_t const *inputs, byte_t const tx_id[], uint16_t index);
 
 /**
  * @brief Get the size of utxo inputs
  *
- * @param[in] ht An utxo input hash table.
+ * @param[in] inputs An utxo input array
  * @return uint16_t
  */
-uint16_t utxo_inputs_count(utxo_input_ht **ht);
-
-/**
- * @brief Free an utxo input hash table.
- *
- * @param[in] utxo_ins An utxo input hash table.
- */
-void utxo_inputs_free(utxo_input_ht **ht);
+uint16_t utxo_inputs_count(utxo_inputs_t const *inputs);
 
 /**
- * @brief Append an utxo input element to the list.
+ * @brief Insert an utxo input element in order
  *
- * @param[in] inputs An input hash table
+ * @param[in] inputs An utxo input array
  * @param[in] tx_id A transaction ID
  * @param[in] index An index
  * @return int 0 on success
  */
-int utxo_inputs_add(utxo_input_ht **inputs, byte_t tx_id[], uint16_t index);
+int utxo_inputs_add(utxo_inputs_t *inputs, byte_t tx_id[], uint16_t index);
 
 /**
- * @brief Append an utxo input with keypair to hash table
+ * @brief Insert an utxo input with keypair in order
  *
- * @param[in] inputs An input hash table
+ * @param[in] inputs An utxo input array
  * @param[in] tx_id A transaction ID
  * @param[in] index An index
  * @param[in] pub An ed25519 public key
  * @param[in] priv An ed25519 private key
  * @return int 0 on success
  */
-int utxo_inputs_add_with_key(utxo_input_ht **inputs, byte_t const tx_id[], uint16_t index, byte_t const pub[],
+int utxo_inputs_add_with_key(utxo_inputs_t *inputs, byte_t const tx_id[], uint16_t index, byte_t const pub[],
                              byte_t const priv[]);
 
 /**
  * @brief Serialize inputs to a buffer
  *
- * @param[in] inputs An utxo input hash table
+ * @param[in] inputs An utxo input array
  * @param[out] buf A buffer for serialization
  * @return size_t number of bytes write to the buffer
  */
-size_t utxo_inputs_serialization(utxo_input_ht **inputs, byte_t buf[]);
+size_t utxo_inputs_serialization(utxo_inputs_t const *inputs, byte_t buf[]);
 
 /**
- * @brief Print an utxo input hash table.
+ * @brief Print an utxo input array.
  *
- * @param[in] inputs An utxo input hash table.
+ * @param[in] inputs An utxo input array
  */
-void utxo_inputs_print(utxo_input_ht **inputs);
+void utxo_inputs_print(utxo_inputs_t const *inputs);
 
 /**
  * @}
@@ -1,6 +1,7 @@
 // Copyright 2020 IOTA Stiftung
 // SPDX-License-Identifier: Apache-2.0
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,6 +12,28 @@
 
 static const UT_icd ut_msg_id_icd = {sizeof(uint8_t) * IOTA_MESSAGE_ID_BYTES, NULL, NULL, NULL};
 
+// the maximum number of parents of a message
+#define MESSAGE_MAX_PARENTS 8
+
+static int msg_id_cmp(void const* a, void const* b) { return memcmp(a, b, IOTA_MESSAGE_ID_BYTES); }
+
+// the serialized length of the message payload
+static size_t core_message_payload_len(core_message_t* msg) {
+  if (msg->payload == NULL) {
+    return 0;
+  }
+  switch (msg->payload_type) {
+    case 0:
+      return tx_payload_serialize_length((transaction_payload_t*)msg->payload);
+    case 2:
+      return indexation_serialize_length((indexation_t*)msg->payload);
+    default:
+      // TODO support other payload
+      printf("[%s:%d] unsupported payload type\n", __func__, __LINE__);
+      return 0;
+  }
+}
+
 core_message_t* core_message_new(void) {
   core_message_t* msg = malloc(sizeof(core_message_t));
   if (msg) {
@@ -38,31 +61,15 @@ int core_message_sign_transaction(core_message_t* msg) {
   }
 
   transaction_payload_t* tx = (transaction_payload_t*)msg->payload;
-  // serialize transaction essence
-  size_t essence_len = tx_essence_serialize_length(tx->essence);
-  byte_t* b_essence = malloc(essence_len);
-  if (!b_essence) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
-    return -1;
-  }
-
-  size_t serialized_size = tx_essence_serialize(tx->essence, b_essence);
-  if (serialized_size != essence_len) {
-    printf("[%s:%d] serialize length miss match\n", __func__, __LINE__);
-    free(b_essence);
-    return -1;
-  }
-
   // essence hash
-  if (iota_blake2b_sum(b_essence, serialized_size, essence_hash, sizeof(essence_hash)) != 0) {
+  if (tx_essence_hash(tx->essence, essence_hash) != 0) {
     printf("[%s:%d] get essence hash failed\n", __func__, __LINE__);
-    free(b_essence);
     return -1;
   }
 
   // create unlocked blocks and sign tx essence
-  utxo_input_ht *elm, *tmp;
-  HASH_ITER(hh, tx->essence->inputs, elm, tmp) {
+  for (uint16_t i = 0; i < tx->essence->inputs.count; i++) {
+    utxo_input_t const* elm = &tx->essence->inputs.elm[i];
     // create a ref block, if public key exists in unlocked_sig
     int32_t pub_index = unlock_blocks_find_pub(tx->unlock_blocks, elm->keypair.pub_key);
     if (pub_index == -1) {
@@ -79,14 +86,14 @@ int core_message_sign_transaction(core_message_t* msg) {
       }
 
       // create a signature block
-      ret = unlock_blocks_add_signature(&tx->unlock_blocks, sig_block, ED25519_SIGNATURE_BLOCK_BYTES);
+      ret = unlock_blocks_add_signature(tx->unlock_blocks, sig_block, ED25519_SIGNATURE_BLOCK_BYTES);
       if (ret) {
         printf("[%s:%d] Add signature block failed\n", __func__, __LINE__);
         break;
       }
     } else {
       // public key is found in the unlocked block
-      ret = unlock_blocks_add_reference(&tx->unlock_blocks, (uint16_t)pub_index);
+      ret = unlock_blocks_add_reference(tx->unlock_blocks, (uint16_t)pub_index);
       if (ret) {
         printf("[%s:%d] Add reference block failed\n", __func__, __LINE__);
         break;
@@ -94,11 +101,76 @@ int core_message_sign_transaction(core_message_t* msg) {
     }
   }
 
-  if (b_essence) {
-    free(b_essence);
+  return ret;
+}
+
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+int core_message_verify_transaction(core_message_t* msg) {
+  int ret = -1;
+  byte_t essence_hash[CRYPTO_BLAKE2B_HASH_BYTES];
+  if (!msg) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (msg->payload_type != 0 || msg->payload == NULL) {
+    printf("[%s:%d] invalid payload\n", __func__, __LINE__);
+    return -1;
+  }
+
+  transaction_payload_t* tx = (transaction_payload_t*)msg->payload;
+  // each input is unlocked by a signature block or a reference to one
+  uint16_t blocks_count = unlock_blocks_count(tx->unlock_blocks);
+  if (blocks_count == 0 || blocks_count != utxo_inputs_count(&tx->essence->inputs)) {
+    printf("[%s:%d] unlock blocks do not match inputs\n", __func__, __LINE__);
+    return -1;
+  }
+
+  byte_t const** pub_keys = malloc(blocks_count * sizeof(byte_t const*));
+  byte_t const** sigs = malloc(blocks_count * sizeof(byte_t const*));
+  byte_t const** msgs = malloc(blocks_count * sizeof(byte_t const*));
+  size_t* msg_lens = malloc(blocks_count * sizeof(size_t));
+  if (!pub_keys || !sigs || !msgs || !msg_lens) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    goto end;
+  }
+
+  if (tx_essence_hash(tx->essence, essence_hash) != 0) {
+    printf("[%s:%d] get essence hash failed\n", __func__, __LINE__);
+    goto end;
+  }
+
+  // all signature blocks sign the same essence hash and are checked in one batch
+  size_t sig_count = 0;
+  unlock_block_elm_t const* blocks = tx->unlock_blocks->elm;
+  for (uint16_t i = 0; i < blocks_count; i++) {
+    if (blocks[i].type == 0) {
+      pub_keys[sig_count] = blocks[i].sig_block + 1;
+      sigs[sig_count] = blocks[i].sig_block + 1 + ED_PUBLIC_KEY_BYTES;
+      msgs[sig_count] = essence_hash;
+      msg_lens[sig_count] = sizeof(essence_hash);
+      sig_count++;
+    } else if (blocks[i].reference >= i || blocks[blocks[i].reference].type != 0) {
+      // a reference points to a previous signature block
+      printf("[%s:%d] invalid reference block\n", __func__, __LINE__);
+      goto end;
+    }
+  }
+
+  if (iota_crypto_verify_batch(pub_keys, msgs, msg_lens, sigs, sig_count, NULL) != 0) {
+    printf("[%s:%d] invalid signature\n", __func__, __LINE__);
+    goto end;
   }
+  ret = 0;
+
+end:
+  free(pub_keys);
+  free(sigs);
+  free(msgs);
+  free(msg_lens);
   return ret;
 }
+#endif /* CRYPTO_HAS_ED25519_VERIFY */
 
 void core_message_free(core_message_t* msg) {
   if (msg) {
@@ -128,3 +200,181 @@ size_t core_message_parent_len(core_message_t* msg) {
   }
   return 0;
 }
+
+size_t core_message_serialize_length(core_message_t* msg) {
+  if (!msg) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return 0;
+  }
+
+  size_t parents_count = utarray_len(msg->parents);
+  if (parents_count == 0 || parents_count > MESSAGE_MAX_PARENTS) {
+    printf("[%s:%d] invalid parent count %zu\n", __func__, __LINE__, parents_count);
+    return 0;
+  }
+
+  size_t payload_len = core_message_payload_len(msg);
+  if (msg->payload && payload_len == 0) {
+    return 0;
+  }
+
+  // network ID(uint64_t) + parents count(uint8_t) + parents + payload length(uint32_t) + payload + nonce(uint64_t)
+  return sizeof(uint64_t) + sizeof(uint8_t) + (IOTA_MESSAGE_ID_BYTES * parents_count) + sizeof(uint32_t) + payload_len +
+         sizeof(uint64_t);
+}
+
+size_t core_message_serialize(core_message_t* msg, byte_t buf[], size_t buf_len) {
+  if (!msg) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return 0;
+  }
+
+  // the required length, nothing is written in a smaller buffer
+  size_t len = core_message_serialize_length(msg);
+  if (len == 0 || !buf || buf_len < len) {
+    return len;
+  }
+
+  byte_t* offset = buf;
+  // network ID
+  memcpy(offset, &msg->network_id, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+
+  // parents must be in lexicographical order
+  utarray_sort(msg->parents, msg_id_cmp);
+  uint8_t parents_count = (uint8_t)utarray_len(msg->parents);
+  memcpy(offset, &parents_count, sizeof(uint8_t));
+  offset += sizeof(uint8_t);
+  byte_t* p = NULL;
+  while ((p = (byte_t*)utarray_next(msg->parents, p)) != NULL) {
+    memcpy(offset, p, IOTA_MESSAGE_ID_BYTES);
+    offset += IOTA_MESSAGE_ID_BYTES;
+  }
+
+  // payload length and payload
+  uint32_t payload_len = 0;
+  byte_t* payload_len_pos = offset;
+  offset += sizeof(uint32_t);
+  if (msg->payload) {
+    size_t remaining = len - (size_t)(offset - buf) - sizeof(uint64_t);
+    if (msg->payload_type == 0) {
+      payload_len = (uint32_t)tx_payload_serialize((transaction_payload_t*)msg->payload, offset, remaining);
+    } else {
+      payload_len = (uint32_t)indexation_payload_serialize((indexation_t*)msg->payload, offset, remaining);
+    }
+    if (payload_len == 0 || payload_len != remaining) {
+      printf("[%s:%d] serialize payload failed\n", __func__, __LINE__);
+      return 0;
+    }
+    offset += payload_len;
+  }
+  memcpy(payload_len_pos, &payload_len, sizeof(uint32_t));
+
+  // nonce
+  memcpy(offset, &msg->nonce, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+  return (offset - buf) / sizeof(byte_t);
+}
+
+core_message_t* core_message_deserialize(byte_t const buf[], size_t len) {
+  core_message_t* msg = NULL;
+  uint8_t parents_count = 0;
+  uint32_t payload_len = 0;
+  payload_t payload_type = 0;
+  size_t offset = 0;
+
+  // network ID(uint64_t) + parents count(uint8_t)
+  if (!buf || len < sizeof(uint64_t) + sizeof(uint8_t)) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  if ((msg = core_message_new()) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  memcpy(&msg->network_id, buf, sizeof(uint64_t));
+  offset += sizeof(uint64_t);
+
+  // parents
+  parents_count = buf[offset];
+  offset += sizeof(uint8_t);
+  if (parents_count == 0 || parents_count > MESSAGE_MAX_PARENTS ||
+      len < offset + (IOTA_MESSAGE_ID_BYTES * parents_count) + sizeof(uint32_t) + sizeof(uint64_t)) {
+    printf("[%s:%d] invalid parents\n", __func__, __LINE__);
+    goto err;
+  }
+  for (uint8_t i = 0; i < parents_count; i++) {
+    core_message_add_parent(msg, buf + offset);
+    offset += IOTA_MESSAGE_ID_BYTES;
+  }
+
+  // payload
+  memcpy(&payload_len, buf + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  if (len != offset + payload_len + sizeof(uint64_t)) {
+    printf("[%s:%d] invalid payload length\n", __func__, __LINE__);
+    goto err;
+  }
+  if (payload_len) {
+    if (payload_len < sizeof(payload_t)) {
+      printf("[%s:%d] invalid payload\n", __func__, __LINE__);
+      goto err;
+    }
+    memcpy(&payload_type, buf + offset, sizeof(payload_t));
+    switch (payload_type) {
+      case 0:
+        msg->payload = tx_payload_deserialize(buf + offset, payload_len);
+        break;
+      case 2:
+        msg->payload = indexation_payload_deserialize(buf + offset, payload_len);
+        break;
+      default:
+        // TODO support other payload
+        printf("[%s:%d] unsupported payload type %" PRIu32 "\n", __func__, __LINE__, payload_type);
+        break;
+    }
+    if (msg->payload == NULL) {
+      goto err;
+    }
+    msg->payload_type = payload_type;
+    offset += payload_len;
+  }
+
+  // nonce
+  memcpy(&msg->nonce, buf + offset, sizeof(uint64_t));
+  return msg;
+
+err:
+  core_message_free(msg);
+  return NULL;
+}
+
+int core_message_id(core_message_t* msg, byte_t id[]) {
+  int ret = -1;
+  if (!msg || !id) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t msg_len = core_message_serialize_length(msg);
+  if (msg_len == 0) {
+    return -1;
+  }
+
+  byte_t* b_msg = malloc(msg_len);
+  if (!b_msg) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (core_message_serialize(msg, b_msg, msg_len) != msg_len) {
+    printf("[%s:%d] serialize length miss match\n", __func__, __LINE__);
+  } else if ((ret = iota_blake2b_sum(b_msg, msg_len, id, IOTA_MESSAGE_ID_BYTES)) != 0) {
+    printf("[%s:%d] get message hash failed\n", __func__, __LINE__);
+  }
+
+  free(b_msg);
+  return ret;
+}
@@ -82,6 +82,20 @@ core_message_t* core_message_new(void);
  */
 int core_message_sign_transaction(core_message_t* msg);
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+/**
+ * @brief Verify the signatures of a transaction message
+ *
+ * Every signature unlock block must sign the essence hash, they are verified in a batch. Reference blocks must point
+ * to a previous block. The owner of the inputs is not checked, it needs the outputs being spent. Not available with
+ * CRYPTO_USE_STLIB.
+ *
+ * @param[in] msg A message with transaction payload
+ * @return int 0 if the signatures are valid
+ */
+int core_message_verify_transaction(core_message_t* msg);
+#endif
+
 /**
  * @brief Free a core message object
  *
@@ -105,6 +119,50 @@ void core_message_add_parent(core_message_t* msg, byte_t const msg_id[]);
  */
 size_t core_message_parent_len(core_message_t* msg);
 
+/**
+ * @brief Get the serialized length of a message
+ *
+ * @param[in] msg A message object
+ * @return size_t The number of bytes of the serialized message, 0 on failure
+ */
+size_t core_message_serialize_length(core_message_t* msg);
+
+/**
+ * @brief Serialize a message to the binary form accepted by the node
+ *
+ * Parents are sorted in lexicographical order as required by the protocol. The same buffer can be hashed for the
+ * message ID, searched for the nonce and sent, no heap is needed with a static or stack buffer.
+ *
+ * @param[in] msg A message object
+ * @param[out] buf A buffer holds the serialized message, NULL to get the length only
+ * @param[in] buf_len The size of the buffer
+ * @return size_t The serialized length, nothing is written if it is larger than buf_len, 0 on failure
+ */
+size_t core_message_serialize(core_message_t* msg, byte_t buf[], size_t buf_len);
+
+/**
+ * @brief Deserialize a message from its binary form
+ *
+ * Transaction and indexation payloads are supported.
+ *
+ * @param[in] buf The serialized message
+ * @param[in] len The length of the serialized message
+ * @return core_message_t* The message object, NULL on failure
+ */
+core_message_t* core_message_deserialize(byte_t const buf[], size_t len);
+
+/**
+ * @brief Compute the message ID, the BLAKE2b-256 hash of the serialized message
+ *
+ * The ID covers the nonce, it is final once the proof-of-work is done. A message sent with a zero nonce gets its
+ * nonce, and so its ID, from the node.
+ *
+ * @param[in] msg A message object
+ * @param[out] id A buffer of IOTA_MESSAGE_ID_BYTES bytes
+ * @return int 0 on success
+ */
+int core_message_id(core_message_t* msg, byte_t id[]);
+
 /**
  * @}
  */
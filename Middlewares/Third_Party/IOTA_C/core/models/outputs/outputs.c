@@ -2,69 +2,93 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "outputs.h"
 
 #define UTXO_OUTPUT_MIN_COUNT 0
-#define UTXO_OUTPUT_MAX_COUNT 126
 
-outputs_ht *utxo_outputs_new(void) {
-  return NULL;
+// compares outputs as serialized, the output type then the address, the address type is always ed25519
+static int output_cmp(utxo_output_t const *elm, output_type_t type, byte_t const addr[]) {
+  if (elm->output_type != type) {
+    return (int)elm->output_type - (int)type;
+  }
+  return memcmp(elm->address, addr, ED25519_ADDRESS_BYTES);
 }
 
-outputs_ht *utxo_outputs_find_by_addr(outputs_ht **ht, byte_t addr[]) {
-  outputs_ht *elm = NULL;
-  HASH_FIND(hh, *ht, addr, ED25519_ADDRESS_BYTES, elm);
-  return elm;
+// binary search, the position of the output or the insertion point if it is not found
+static uint16_t outputs_search(utxo_outputs_t const *outputs, output_type_t type, byte_t const addr[], bool *found) {
+  uint16_t low = 0, high = outputs->count;
+  *found = false;
+  while (low < high) {
+    uint16_t mid = low + (high - low) / 2;
+    int cmp = output_cmp(&outputs->elm[mid], type, addr);
+    if (cmp == 0) {
+      *found = true;
+      return mid;
+    } else if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
 }
 
-uint16_t utxo_outputs_count(outputs_ht **ht) {
-  return (uint16_t)HASH_COUNT(*ht);
+void utxo_outputs_init(utxo_outputs_t *outputs, utxo_output_t buf[], uint16_t capacity) {
+  outputs->count = 0;
+  outputs->capacity = capacity;
+  outputs->elm = buf;
 }
 
-void utxo_outputs_free(outputs_ht **ht) {
-  outputs_ht *curr_elm, *tmp;
-  HASH_ITER(hh, *ht, curr_elm, tmp) {
-    HASH_DEL(*ht, curr_elm);
-    free(curr_elm);
-  }
+utxo_output_t *utxo_outputs_find_by_addr(utxo_outputs_t const *outputs, output_type_t type, byte_t const addr[]) {
+  bool found = false;
+  uint16_t pos = outputs_search(outputs, type, addr, &found);
+  return found ? &outputs->elm[pos] : NULL;
 }
 
-int utxo_outputs_add(outputs_ht **ht, output_type_t type, byte_t addr[], uint64_t amount) {
+uint16_t utxo_outputs_count(utxo_outputs_t const *outputs) {
+  return outputs->count;
+}
+
+int utxo_outputs_add(utxo_outputs_t *outputs, output_type_t type, byte_t addr[], uint64_t amount) {
+  bool found = false;
   if (type == OUTPUT_DUST_ALLOWANCE && amount < 1000000) {
     printf("[%s:%d] dust allowance amount must at least 1Mi\n", __func__, __LINE__);
     return -1;
   }
 
-  if (utxo_outputs_count(ht) >= UTXO_OUTPUT_MAX_COUNT) {
+  if (outputs->count >= UTXO_OUTPUT_MAX_COUNT) {
     printf("[%s:%d] output count must be < 127\n", __func__, __LINE__);
     return -1;
   }
 
-  outputs_ht *elm = utxo_outputs_find_by_addr(ht, addr);
-  if (elm) {
-    printf("[%s:%d] address exists\n", __func__, __LINE__);
+  if (outputs->count >= outputs->capacity) {
+    printf("[%s:%d] outputs are full\n", __func__, __LINE__);
     return -1;
   }
 
-  elm = malloc(sizeof(outputs_ht));
-  if (elm == NULL) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
+  uint16_t pos = outputs_search(outputs, type, addr, &found);
+  if (found) {
+    printf("[%s:%d] address exists\n", __func__, __LINE__);
     return -1;
   }
+
+  memmove(&outputs->elm[pos + 1], &outputs->elm[pos], (outputs->count - pos) * sizeof(utxo_output_t));
+  outputs->count++;
+  utxo_output_t *elm = &outputs->elm[pos];
   elm->output_type = type;
   memcpy(elm->address, addr, ED25519_ADDRESS_BYTES);
   elm->amount = amount;
-  HASH_ADD(hh, *ht, address, ED25519_ADDRESS_BYTES, elm);
   return 0;
 }
 
-size_t utxo_outputs_serialization(outputs_ht **ht, byte_t buf[]) {
-  outputs_ht *elm, *tmp;
+size_t utxo_outputs_serialization(utxo_outputs_t const *outputs, byte_t buf[]) {
   size_t byte_count = 0;
-  uint8_t elm_count = 0;
-  HASH_ITER(hh, *ht, elm, tmp) {
+  for (uint16_t i = 0; i < outputs->count; i++) {
+    utxo_output_t const *elm = &outputs->elm[i];
     // output type
     memset(buf + byte_count, elm->output_type, sizeof(byte_t));
     byte_count += sizeof(byte_t);
@@ -80,22 +104,14 @@ size_t utxo_outputs_serialization(outputs_ht **ht, byte_t buf[]) {
     // amount
     memcpy(buf + byte_count, &elm->amount, sizeof(elm->amount));
     byte_count += sizeof(elm->amount);
-
-    elm_count++;
   }
-
-  if (byte_count != (elm_count * UTXO_OUTPUT_SERIALIZED_BYTES)) {
-    printf("[%s:%d] offset error\n", __func__, __LINE__);
-    return 0;
-  }
-
   return byte_count;
 }
 
-void utxo_outputs_print(outputs_ht **ht) {
-  outputs_ht *elm, *tmp;
+void utxo_outputs_print(utxo_outputs_t const *outputs) {
   printf("utxo_outputs: [\n");
-  HASH_ITER(hh, *ht, elm, tmp) {
+  for (uint16_t i = 0; i < outputs->count; i++) {
+    utxo_output_t const *elm = &outputs->elm[i];
     printf("\ttype: %d ", elm->output_type);
     printf("[%" PRIu64 "] ", elm->amount);
     dump_hex(elm->address, ED25519_ADDRESS_BYTES);
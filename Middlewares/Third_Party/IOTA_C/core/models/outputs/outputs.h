@@ -8,7 +8,6 @@
 
 #include "core/address.h"
 #include "core/types.h"
-#include "uthash.h"
 
 /** @addtogroup IOTA_C
  * @{
@@ -28,6 +27,8 @@
 
 // Serialized bytes = output type(uint8_t) + address type(uint8_t) + ed25519 address(32bytes) + amount(uint64_t)
 #define UTXO_OUTPUT_SERIALIZED_BYTES (1 + 1 + ED25519_ADDRESS_BYTES + 8)
+// The maximum number of outputs in a transaction
+#define UTXO_OUTPUT_MAX_COUNT 126
 
 /**
  * @}
@@ -54,15 +55,26 @@ typedef enum {
 } output_type_t;
 
 /**
- * @brief Stores deposit outputs in a hash table
+ * @brief A deposit output
  *
  */
 typedef struct {
   uint8_t output_type;                    ///< 0: SigLockedSingleOutput, 1: SigLockedDustAllowanceOutput
   byte_t address[ED25519_ADDRESS_BYTES];  ///< Ed25519 address
   uint64_t amount;                        ///< The amount of tokens to deposit with this output.
-  UT_hash_handle hh;
-} outputs_ht;
+} utxo_output_t;
+
+/**
+ * @brief A fixed-capacity array of deposit outputs
+ *
+ * Outputs are kept in lexicographical order of their serialized form, the buffer is owned by the caller.
+ *
+ */
+typedef struct {
+  uint16_t count;      ///< The number of outputs
+  uint16_t capacity;   ///< The number of outputs the buffer holds
+  utxo_output_t *elm;  ///< The sorted outputs
+} utxo_outputs_t;
 
 /**
  * @}
@@ -77,62 +89,60 @@ extern "C" {
  */
 
 /**
- * @brief Initialize an utxo output hash table.
+ * @brief Initialize an empty utxo output array on a buffer
  *
- * @return outputs_ht* a NULL pointer
+ * @param[out] outputs An utxo output array
+ * @param[in] buf A buffer holds capacity outputs
+ * @param[in] capacity The number of outputs in buf
  */
-outputs_ht *utxo_outputs_new(void);
+void utxo_outputs_init(utxo_outputs_t *outputs, utxo_output_t buf[], uint16_t capacity);
 
 /**
- * @brief Find an utxo output by a given address
+ * @brief Find an utxo output by a given output type and address
  *
- * @param[in] ht An utxo output hash table
+ * @param[in] outputs An utxo output array
+ * @param[in] type The output type
  * @param[in] addr An address for searching
- * @return outputs_ht*
+ * @return utxo_output_t* NULL if not found
  */
-outputs_ht *utxo_outputs_find_by_addr(outputs_ht **ht, byte_t addr[]);
+utxo_output_t *utxo_outputs_find_by_addr(utxo_outputs_t const *outputs, output_type_t type, byte_t const addr[]);
 
 /**
  * @brief Get the size of utxo outputs
  *
- * @param[in] ht An utxo output hash table.
+ * @param[in] outputs An utxo output array
  * @return uint16_t
  */
-uint16_t utxo_outputs_count(outputs_ht **ht);
+uint16_t utxo_outputs_count(utxo_outputs_t const *outputs);
 
 /**
- * @brief Free an utxo output hash table.
+ * @brief Insert an utxo output element in order
  *
- * @param[in] utxo_ins An utxo output hash table.
- */
-void utxo_outputs_free(outputs_ht **ht);
-
-/**
- * @brief Append an utxo output element to the table.
+ * An address is unique among the outputs of a type.
  *
- * @param[in] ht An utxo output hash table
+ * @param[in] outputs An utxo output array
  * @param[in] type output type
  * @param[in] addr An ED25519 address
  * @param[in] amount The amount of tokens to deposit
  * @return int 0 on success
  */
-int utxo_outputs_add(outputs_ht **ht, output_type_t type, byte_t addr[], uint64_t amount);
+int utxo_outputs_add(utxo_outputs_t *outputs, output_type_t type, byte_t addr[], uint64_t amount);
 
 /**
  * @brief Serialize outputs to a buffer
  *
- * @param[in] ht An utxo output hash table
+ * @param[in] outputs An utxo output array
  * @param[out] buf A buffer for serialization
  * @return size_t number of bytes write to the buffer
  */
-size_t utxo_outputs_serialization(outputs_ht **ht, byte_t buf[]);
+size_t utxo_outputs_serialization(utxo_outputs_t const *outputs, byte_t buf[]);
 
 /**
- * @brief Print an utxo output hash table.
+ * @brief Print an utxo output array.
  *
- * @param[in] ht An utxo output hash table.
+ * @param[in] outputs An utxo output array
  */
-void utxo_outputs_print(outputs_ht **ht);
+void utxo_outputs_print(utxo_outputs_t const *outputs);
 
 /**
  * @}
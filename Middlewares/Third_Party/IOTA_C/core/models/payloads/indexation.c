@@ -63,12 +63,18 @@ size_t indexation_serialize_length(indexation_t *idx) {
   return len;
 }
 
-size_t indexation_payload_serialize(indexation_t *idx, byte_t buf[]) {
+size_t indexation_payload_serialize(indexation_t *idx, byte_t buf[], size_t buf_len) {
   if (!idx) {
     printf("[%s:%d] NULL parameter\n", __func__, __LINE__);
     return 0;
   }
 
+  // the required length, nothing is written in a smaller buffer
+  size_t len = indexation_serialize_length(idx);
+  if (!buf || buf_len < len) {
+    return len;
+  }
+
   byte_t *offset = buf;
   // payload type, set to value 2 to denote an indexation payload.
   uint32_t idx_type = 2;
@@ -90,3 +96,64 @@ size_t indexation_payload_serialize(indexation_t *idx, byte_t buf[]) {
   offset += idx->data->len;
   return (offset - buf) / sizeof(byte_t);
 }
+
+indexation_t *indexation_payload_deserialize(byte_t const buf[], size_t len) {
+  indexation_t *idx = NULL;
+  uint32_t idx_type = 0;
+  uint16_t index_len = 0;
+  uint32_t data_len = 0;
+  size_t offset = 0;
+
+  if (!buf || len < sizeof(uint32_t) + sizeof(uint16_t)) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // payload type, 2 denotes an indexation payload.
+  memcpy(&idx_type, buf, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  if (idx_type != 2) {
+    printf("[%s:%d] not an indexation payload\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // index
+  memcpy(&index_len, buf + offset, sizeof(uint16_t));
+  offset += sizeof(uint16_t);
+  if (index_len == 0 || index_len > MAX_INDEXCATION_INDEX_BYTES || len < offset + index_len + sizeof(uint32_t)) {
+    printf("[%s:%d] invalid index\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  if ((idx = indexation_new()) == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // the index is kept as a string
+  if ((idx->index = byte_buf_new()) == NULL || !byte_buf_reserve(idx->index, index_len + 1)) {
+    printf("[%s:%d] allocate index failed\n", __func__, __LINE__);
+    indexation_free(idx);
+    return NULL;
+  }
+  memcpy(idx->index->data, buf + offset, index_len);
+  idx->index->data[index_len] = '\0';
+  idx->index->len = index_len + 1;
+  offset += index_len;
+
+  // data
+  memcpy(&data_len, buf + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  if (len != offset + data_len) {
+    printf("[%s:%d] invalid data length\n", __func__, __LINE__);
+    indexation_free(idx);
+    return NULL;
+  }
+
+  if ((idx->data = byte_buf_new_with_data((byte_t *)buf + offset, data_len)) == NULL) {
+    printf("[%s:%d] allocate data failed\n", __func__, __LINE__);
+    indexation_free(idx);
+    return NULL;
+  }
+  return idx;
+}
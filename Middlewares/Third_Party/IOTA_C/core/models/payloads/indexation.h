@@ -96,11 +96,21 @@ size_t indexation_serialize_length(indexation_t *idx);
 /**
  * @brief Serialize an indexation payload
  *
- * @param[in] idx
- * @param[out] buf
- * @return size_t
+ * @param[in] idx An indexation payload object
+ * @param[out] buf A buffer holds the serialized data, NULL to get the length only
+ * @param[in] buf_len The size of the buffer
+ * @return size_t The serialized length, nothing is written if it is larger than buf_len, 0 on failure
+ */
+size_t indexation_payload_serialize(indexation_t *idx, byte_t buf[], size_t buf_len);
+
+/**
+ * @brief Deserialize an indexation payload
+ *
+ * @param[in] buf The serialized payload, starting with the payload type
+ * @param[in] len The length of the serialized payload
+ * @return indexation_t* The payload object, NULL on failure
  */
-size_t indexation_payload_serialize(indexation_t *idx, byte_t buf[]);
+indexation_t *indexation_payload_deserialize(byte_t const buf[], size_t len);
 
 /**
  * @}
@@ -2,8 +2,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <inttypes.h>
-
-#include "utlist.h"
+#include <stdio.h>
+#include <string.h>
 
 #include "transaction.h"
 
@@ -14,32 +14,27 @@
 //  unlock_block_t + signature type + pub_key + signature
 #define SIGNATURE_SERIALIZE_BYTES (1 + (1 + ED_PUBLIC_KEY_BYTES + ED_SIGNATURE_BYTES))
 
-static int byte_cmp(const byte_t* p1, const byte_t* p2, size_t len) {
-  byte_t b1 = 0, b2 = 0;
-  for (size_t i = 0; i <= len; i++) {
-    b1 = p1[i];
-    b2 = p2[i];
-    if (b1 != b2) {
-      return b1 - b2;
-    }
-  }
-  return b1 - b2;
-}
+// outputs hold an uint64_t, they follow the essence at an aligned offset and the inputs follow them
+#define ESSENCE_ALIGN(x) (((x) + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1))
 
-static int sort_input_tx_id(utxo_input_ht* a, utxo_input_ht* b) {
-  return byte_cmp(a->tx_id, b->tx_id, TRANSACTION_ID_BYTES);
+transaction_essence_t* tx_essence_new(void) {
+  return tx_essence_new_with_capacity(UTXO_INPUT_MAX_COUNT, UTXO_OUTPUT_MAX_COUNT);
 }
 
-static int sort_output_address(outputs_ht* a, outputs_ht* b) {
-  return byte_cmp(a->address, b->address, ED25519_ADDRESS_BYTES);
-}
+transaction_essence_t* tx_essence_new_with_capacity(uint16_t inputs, uint16_t outputs) {
+  if (inputs > UTXO_INPUT_MAX_COUNT || outputs > UTXO_OUTPUT_MAX_COUNT) {
+    printf("[%s:%d] invalid capacity\n", __func__, __LINE__);
+    return NULL;
+  }
 
-transaction_essence_t* tx_essence_new(void) {
-  transaction_essence_t* es = malloc(sizeof(transaction_essence_t));
+  size_t outputs_offset = ESSENCE_ALIGN(sizeof(transaction_essence_t));
+  size_t inputs_offset = ESSENCE_ALIGN(outputs_offset + outputs * sizeof(utxo_output_t));
+  byte_t* arena = malloc(inputs_offset + inputs * sizeof(utxo_input_t));
+  transaction_essence_t* es = (transaction_essence_t*)arena;
   if (es) {
     es->tx_type = 0;  // 0 to denote a transaction essence.
-    es->inputs = utxo_inputs_new();
-    es->outputs = utxo_outputs_new();
+    utxo_inputs_init(&es->inputs, (utxo_input_t*)(arena + inputs_offset), inputs);
+    utxo_outputs_init(&es->outputs, (utxo_output_t*)(arena + outputs_offset), outputs);
     es->payload = NULL;
     es->payload_len = 0;
   }
@@ -76,13 +71,6 @@ int tx_essence_add_output(transaction_essence_t* es, output_type_t type, byte_t
   return utxo_outputs_add(&es->outputs, type, addr, amount);
 }
 
-void tx_essence_sort_input_output(transaction_essence_t* es) {
-  if (es) {
-    HASH_SORT(es->inputs, sort_input_tx_id);
-    HASH_SORT(es->outputs, sort_output_address);
-  }
-}
-
 int tx_essence_add_payload(transaction_essence_t* es, uint32_t type, void* payload) {
   if (!es || !payload) {
     return -1;
@@ -140,8 +128,7 @@ size_t tx_essence_serialize(transaction_essence_t* es, byte_t buf[]) {
   memset(offset, 0, sizeof(uint8_t));
   offset += sizeof(uint8_t);
 
-  // Inputs and Outputs must be in lexicographical order of their serialized form
-  tx_essence_sort_input_output(es);
+  // Inputs and Outputs are in lexicographical order of their serialized form
 
   // input counts
   memcpy(offset, &input_counts, sizeof(uint16_t));
@@ -159,7 +146,7 @@ size_t tx_essence_serialize(transaction_essence_t* es, byte_t buf[]) {
     // serialize indexation payload
     memcpy(offset, &es->payload_len, sizeof(es->payload_len));
     offset += sizeof(es->payload_len);
-    offset += indexation_payload_serialize((indexation_t*)es->payload, offset);
+    offset += indexation_payload_serialize((indexation_t*)es->payload, offset, es->payload_len);
   } else {
     memset(offset, 0, sizeof(uint32_t));
     offset += sizeof(uint32_t);
@@ -167,10 +154,83 @@ size_t tx_essence_serialize(transaction_essence_t* es, byte_t buf[]) {
   return (offset - buf) / sizeof(byte_t);
 }
 
+// hash an indexation payload field by field, the same layout as indexation_payload_serialize()
+static int indexation_hash_update(iota_hash_state_t* state, indexation_t* idx) {
+  int ret = 0;
+  uint32_t idx_type = 2;
+  uint16_t index_len = (uint16_t)strlen((char const*)idx->index->data);
+  uint32_t data_len = (uint32_t)idx->data->len;
+  ret |= iota_blake2b_update(state, (byte_t const*)&idx_type, sizeof(idx_type));
+  ret |= iota_blake2b_update(state, (byte_t const*)&index_len, sizeof(index_len));
+  ret |= iota_blake2b_update(state, idx->index->data, index_len);
+  ret |= iota_blake2b_update(state, (byte_t const*)&data_len, sizeof(data_len));
+  ret |= iota_blake2b_update(state, idx->data->data, data_len);
+  return ret;
+}
+
+int tx_essence_hash(transaction_essence_t* es, byte_t hash[]) {
+  int ret = 0;
+  byte_t elm_buf[UTXO_OUTPUT_SERIALIZED_BYTES > UTXO_INPUT_SERIALIZED_BYTES ? UTXO_OUTPUT_SERIALIZED_BYTES
+                                                                            : UTXO_INPUT_SERIALIZED_BYTES];
+
+  // validates the inputs and outputs count
+  if (!es || !hash || tx_essence_serialize_length(es) == 0) {
+    printf("[%s:%d] invalid essence\n", __func__, __LINE__);
+    return -1;
+  }
+
+  iota_hash_state_t* state = iota_hash_state_new();
+  if (!state) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // the same layout as tx_essence_serialize()
+  uint16_t input_counts = utxo_inputs_count(&es->inputs);
+  uint16_t output_counts = utxo_outputs_count(&es->outputs);
+  byte_t essence_type = 0;
+  ret |= iota_blake2b_init(state, CRYPTO_BLAKE2B_HASH_BYTES);
+  ret |= iota_blake2b_update(state, &essence_type, sizeof(essence_type));
+
+  ret |= iota_blake2b_update(state, (byte_t const*)&input_counts, sizeof(input_counts));
+  for (uint16_t i = 0; i < input_counts; i++) {
+    utxo_input_t const* in = &es->inputs.elm[i];
+    // input type 0 + transaction id + output index
+    elm_buf[0] = 0;
+    memcpy(elm_buf + 1, in->tx_id, TRANSACTION_ID_BYTES);
+    memcpy(elm_buf + 1 + TRANSACTION_ID_BYTES, &in->output_index, sizeof(in->output_index));
+    ret |= iota_blake2b_update(state, elm_buf, UTXO_INPUT_SERIALIZED_BYTES);
+  }
+
+  ret |= iota_blake2b_update(state, (byte_t const*)&output_counts, sizeof(output_counts));
+  for (uint16_t i = 0; i < output_counts; i++) {
+    utxo_output_t const* out = &es->outputs.elm[i];
+    // output type + address type + address + amount
+    elm_buf[0] = out->output_type;
+    elm_buf[1] = ADDRESS_VER_ED25519;
+    memcpy(elm_buf + 2, out->address, ED25519_ADDRESS_BYTES);
+    memcpy(elm_buf + 2 + ED25519_ADDRESS_BYTES, &out->amount, sizeof(out->amount));
+    ret |= iota_blake2b_update(state, elm_buf, UTXO_OUTPUT_SERIALIZED_BYTES);
+  }
+
+  uint32_t payload_len = es->payload ? es->payload_len : 0;
+  ret |= iota_blake2b_update(state, (byte_t const*)&payload_len, sizeof(payload_len));
+  if (es->payload) {
+    ret |= indexation_hash_update(state, (indexation_t*)es->payload);
+  }
+
+  if (ret == 0) {
+    ret = iota_blake2b_final(state, hash, CRYPTO_BLAKE2B_HASH_BYTES);
+  }
+
+  iota_hash_state_free(state);
+  return ret == 0 ? 0 : -1;
+}
+
 void tx_essence_free(transaction_essence_t* es) {
   if (es) {
-    utxo_inputs_free(&es->inputs);
-    utxo_outputs_free(&es->outputs);
+    // the keypairs of the inputs
+    memset(es->inputs.elm, 0, es->inputs.capacity * sizeof(utxo_input_t));
 
     if (es->payload) {
       // TODO support other payloads
@@ -188,12 +248,17 @@ void tx_essence_print(transaction_essence_t* es) {
 }
 
 transaction_payload_t* tx_payload_new(void) {
+  return tx_payload_new_with_capacity(UTXO_INPUT_MAX_COUNT, UTXO_OUTPUT_MAX_COUNT);
+}
+
+transaction_payload_t* tx_payload_new_with_capacity(uint16_t inputs, uint16_t outputs) {
   transaction_payload_t* tx = malloc(sizeof(transaction_payload_t));
   if (tx) {
     tx->type = 0;  // 0 to denote a Transaction payload.
-    tx->essence = tx_essence_new();
-    tx->unlock_blocks = unlock_blocks_new();
-    if (tx->essence == NULL) {
+    tx->essence = tx_essence_new_with_capacity(inputs, outputs);
+    // an unlock block per input
+    tx->unlock_blocks = unlock_blocks_new(inputs);
+    if (tx->essence == NULL || tx->unlock_blocks == NULL) {
       tx_payload_free(tx);
       return NULL;
     }
@@ -225,14 +290,14 @@ int tx_payload_add_output(transaction_payload_t* tx, output_type_t type, byte_t
 
 int tx_payload_add_sig_block(transaction_payload_t* tx, byte_t* sig_block, size_t sig_len) {
   if (tx) {
-    return unlock_blocks_add_signature(&tx->unlock_blocks, sig_block, sig_len);
+    return unlock_blocks_add_signature(tx->unlock_blocks, sig_block, sig_len);
   }
   return -1;
 }
 
 int tx_payload_add_ref_block(transaction_payload_t* tx, uint16_t ref) {
   if (tx) {
-    return unlock_blocks_add_reference(&tx->unlock_blocks, ref);
+    return unlock_blocks_add_reference(tx->unlock_blocks, ref);
   }
   return -1;
 }
@@ -248,11 +313,17 @@ size_t tx_payload_serialize_length(transaction_payload_t* tx) {
   return sizeof(payload_t) + essence_len + blocks_len;
 }
 
-size_t tx_payload_serialize(transaction_payload_t* tx, byte_t buf[]) {
+size_t tx_payload_serialize(transaction_payload_t* tx, byte_t buf[], size_t buf_len) {
   if (tx == NULL) {
     return 0;
   }
 
+  // the required length, nothing is written in a smaller buffer
+  size_t len = tx_payload_serialize_length(tx);
+  if (len == 0 || !buf || buf_len < len) {
+    return len;
+  }
+
   byte_t* offset = buf;
   // write payload type
   memset(offset, 0, sizeof(payload_t));
@@ -264,6 +335,131 @@ size_t tx_payload_serialize(transaction_payload_t* tx, byte_t buf[]) {
   return (offset - buf) / sizeof(byte_t);
 }
 
+// deserialize a transaction essence into es, returns the number of bytes read or 0 on failure
+static size_t tx_essence_deserialize(transaction_essence_t* es, byte_t const buf[], size_t len) {
+  size_t offset = 0;
+  uint16_t count = 0;
+  uint32_t payload_len = 0;
+
+  // transaction type(uint8_t) + input count(uint16_t)
+  if (len < sizeof(uint8_t) + sizeof(uint16_t) || buf[0] != 0) {
+    printf("[%s:%d] invalid transaction essence\n", __func__, __LINE__);
+    return 0;
+  }
+  offset += sizeof(uint8_t);
+
+  // inputs
+  memcpy(&count, buf + offset, sizeof(uint16_t));
+  offset += sizeof(uint16_t);
+  if (len < offset + (UTXO_INPUT_SERIALIZED_BYTES * count) + sizeof(uint16_t)) {
+    printf("[%s:%d] truncated inputs\n", __func__, __LINE__);
+    return 0;
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    uint16_t index = 0;
+    // input type, 0 denotes an UTXO Input.
+    if (buf[offset] != 0) {
+      printf("[%s:%d] unsupported input type\n", __func__, __LINE__);
+      return 0;
+    }
+    memcpy(&index, buf + offset + 1 + TRANSACTION_ID_BYTES, sizeof(uint16_t));
+    if (utxo_inputs_add(&es->inputs, (byte_t*)buf + offset + 1, index) != 0) {
+      return 0;
+    }
+    offset += UTXO_INPUT_SERIALIZED_BYTES;
+  }
+
+  // outputs
+  memcpy(&count, buf + offset, sizeof(uint16_t));
+  offset += sizeof(uint16_t);
+  if (len < offset + (UTXO_OUTPUT_SERIALIZED_BYTES * count) + sizeof(uint32_t)) {
+    printf("[%s:%d] truncated outputs\n", __func__, __LINE__);
+    return 0;
+  }
+  for (uint16_t i = 0; i < count; i++) {
+    uint64_t amount = 0;
+    // output type + address type, only ed25519 addresses are supported.
+    if (buf[offset + 1] != ADDRESS_VER_ED25519) {
+      printf("[%s:%d] unsupported address type\n", __func__, __LINE__);
+      return 0;
+    }
+    memcpy(&amount, buf + offset + 2 + ED25519_ADDRESS_BYTES, sizeof(uint64_t));
+    if (utxo_outputs_add(&es->outputs, (output_type_t)buf[offset], (byte_t*)buf + offset + 2, amount) != 0) {
+      return 0;
+    }
+    offset += UTXO_OUTPUT_SERIALIZED_BYTES;
+  }
+
+  // optional payload
+  memcpy(&payload_len, buf + offset, sizeof(uint32_t));
+  offset += sizeof(uint32_t);
+  if (payload_len) {
+    if (len < offset + payload_len) {
+      printf("[%s:%d] truncated payload\n", __func__, __LINE__);
+      return 0;
+    }
+    // TODO support other payloads
+    indexation_t* idx = indexation_payload_deserialize(buf + offset, payload_len);
+    if (idx == NULL) {
+      return 0;
+    }
+    tx_essence_add_payload(es, 2, idx);
+    offset += payload_len;
+  }
+  return offset;
+}
+
+transaction_payload_t* tx_payload_deserialize(byte_t const buf[], size_t len) {
+  transaction_payload_t* tx = NULL;
+  payload_t type = 0;
+  size_t offset = 0;
+  size_t read = 0;
+
+  if (buf == NULL || len < sizeof(payload_t)) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // payload type, 0 denotes a transaction payload.
+  memcpy(&type, buf, sizeof(payload_t));
+  offset += sizeof(payload_t);
+  if (type != 0) {
+    printf("[%s:%d] not a transaction payload\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // the essence holds the counts found in the buffer, the inputs and outputs are checked by tx_essence_deserialize()
+  uint16_t inputs = 0, outputs = 0;
+  size_t outputs_offset = offset + sizeof(uint8_t) + sizeof(uint16_t);
+  if (len >= outputs_offset) {
+    memcpy(&inputs, buf + offset + sizeof(uint8_t), sizeof(uint16_t));
+    outputs_offset += UTXO_INPUT_SERIALIZED_BYTES * inputs;
+  }
+  if (len >= outputs_offset + sizeof(uint16_t)) {
+    memcpy(&outputs, buf + outputs_offset, sizeof(uint16_t));
+  }
+
+  if ((tx = tx_payload_new_with_capacity(inputs, outputs)) == NULL) {
+    printf("[%s:%d] allocate tx payload failed\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  if ((read = tx_essence_deserialize(tx->essence, buf + offset, len - offset)) == 0) {
+    printf("[%s:%d] deserialize essence failed\n", __func__, __LINE__);
+    tx_payload_free(tx);
+    return NULL;
+  }
+  offset += read;
+
+  if ((read = unlock_blocks_deserialize(buf + offset, len - offset, &tx->unlock_blocks)) == 0 ||
+      offset + read != len) {
+    printf("[%s:%d] deserialize unlocked blocks failed\n", __func__, __LINE__);
+    tx_payload_free(tx);
+    return NULL;
+  }
+  return tx;
+}
+
 void tx_payload_free(transaction_payload_t* tx) {
   if (tx) {
     if (tx->essence) {
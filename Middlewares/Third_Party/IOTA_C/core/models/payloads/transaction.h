@@ -49,15 +49,18 @@ static const uint64_t MAX_IOTA_SUPPLY = 2779530283277761;
  * optional payload.
  *
  * Based on protocol design, we can have different types of input and output in a transaction.
- * At this moment, we have only utxo_input_ht for intput and SigLockedSingleOutput for output.
+ * At this moment, we have only utxo_input_t for intput and SigLockedSingleOutput for output.
+ *
+ * Inputs and outputs are stored in the same allocation as the essence, with a capacity fixed at creation. They are
+ * kept in lexicographical order as they are added.
  *
  */
 typedef struct {
-  uint8_t tx_type;        ///< Set to value 0 to denote a Transaction Essence.
-  uint32_t payload_len;   ///< The length in bytes of the optional payload.
-  utxo_input_ht* inputs;  ///< any of UTXO input
-  outputs_ht* outputs;    ///< any of UTXO output
-  void* payload;          ///< an indexation payload at this moment
+  uint8_t tx_type;         ///< Set to value 0 to denote a Transaction Essence.
+  uint32_t payload_len;    ///< The length in bytes of the optional payload.
+  utxo_inputs_t inputs;    ///< any of UTXO input
+  utxo_outputs_t outputs;  ///< any of UTXO output
+  void* payload;           ///< an indexation payload at this moment
 } transaction_essence_t;
 
 /**
@@ -89,10 +92,22 @@ extern "C" {
 /**
  * @brief Allocate a transaction essence object
  *
+ * It holds UTXO_INPUT_MAX_COUNT inputs and UTXO_OUTPUT_MAX_COUNT outputs, tx_essence_new_with_capacity() takes less
+ * memory when the counts are known.
+ *
  * @return transaction_essence_t*
  */
 transaction_essence_t* tx_essence_new(void);
 
+/**
+ * @brief Allocate a transaction essence object with the inputs and outputs in a single allocation
+ *
+ * @param[in] inputs The maximum number of inputs, up to UTXO_INPUT_MAX_COUNT
+ * @param[in] outputs The maximum number of outputs, up to UTXO_OUTPUT_MAX_COUNT
+ * @return transaction_essence_t*
+ */
+transaction_essence_t* tx_essence_new_with_capacity(uint16_t inputs, uint16_t outputs);
+
 /**
  * @brief Add an input element to the essence
  *
@@ -156,6 +171,17 @@ size_t tx_essence_serialize_length(transaction_essence_t* es);
  */
 size_t tx_essence_serialize(transaction_essence_t* es, byte_t buf[]);
 
+/**
+ * @brief Compute the BLAKE2b-256 hash of the serialized essence
+ *
+ * The serialized form is hashed as it is written, the essence is not serialized to a buffer first.
+ *
+ * @param[in] es An essence object
+ * @param[out] hash The essence hash, CRYPTO_BLAKE2B_HASH_BYTES
+ * @return int 0 on success
+ */
+int tx_essence_hash(transaction_essence_t* es, byte_t hash[]);
+
 /**
  * @brief Free an essence object
  *
@@ -171,18 +197,22 @@ void tx_essence_free(transaction_essence_t* es);
 void tx_essence_print(transaction_essence_t* es);
 
 /**
- * @brief Sort inputs and outputs in lexicographical order
+ * @brief Allocate a tansaction payload object
  *
- * @param[in] es An essence object
+ * The essence holds UTXO_INPUT_MAX_COUNT inputs and UTXO_OUTPUT_MAX_COUNT outputs.
+ *
+ * @return transaction_payload_t*
  */
-void tx_essence_sort_input_output(transaction_essence_t* es);
+transaction_payload_t* tx_payload_new(void);
 
 /**
- * @brief Allocate a tansaction payload object
+ * @brief Allocate a tansaction payload object with the given essence capacity
  *
+ * @param[in] inputs The maximum number of inputs, up to UTXO_INPUT_MAX_COUNT
+ * @param[in] outputs The maximum number of outputs, up to UTXO_OUTPUT_MAX_COUNT
  * @return transaction_payload_t*
  */
-transaction_payload_t* tx_payload_new(void);
+transaction_payload_t* tx_payload_new_with_capacity(uint16_t inputs, uint16_t outputs);
 
 /**
  * @brief Add an input to the transaction payload
@@ -249,10 +279,20 @@ size_t tx_payload_serialize_length(transaction_payload_t* tx);
  * @brief Serialize a transaction payload
  *
  * @param[in] tx A transaction payload
- * @param[out] buf A buffer holds the serialized data
- * @return size_t number of bytes written to the buffer
+ * @param[out] buf A buffer holds the serialized data, NULL to get the length only
+ * @param[in] buf_len The size of the buffer
+ * @return size_t The serialized length, nothing is written if it is larger than buf_len, 0 on failure
+ */
+size_t tx_payload_serialize(transaction_payload_t* tx, byte_t buf[], size_t buf_len);
+
+/**
+ * @brief Deserialize a transaction payload
+ *
+ * @param[in] buf The serialized payload, starting with the payload type
+ * @param[in] len The length of the serialized payload
+ * @return transaction_payload_t* The payload object, NULL on failure
  */
-size_t tx_payload_serialize(transaction_payload_t* tx, byte_t buf[]);
+transaction_payload_t* tx_payload_deserialize(byte_t const buf[], size_t len);
 
 /**
  * @brief Free a transaction payload object
@@ -6,40 +6,76 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "utlist.h"
-
 #include "unlock_block.h"
 
 #define UNLOCKED_BLOCKS_MAX_COUNT 126
 
-unlock_blocks_t* unlock_blocks_new(void) { return NULL; }
+// the map slot of a public key, ed25519 public keys are uniformly distributed
+static uint16_t pub_slot(unlock_blocks_t const* blocks, byte_t const* const pub_key) {
+  return (uint16_t)(pub_key[0] | (pub_key[1] << 8)) & blocks->map_mask;
+}
+
+unlock_blocks_t* unlock_blocks_new(uint16_t capacity) {
+  if (capacity > UNLOCKED_BLOCKS_MAX_COUNT) {
+    printf("[%s:%d] invalid capacity\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  // at most half of the slots are used
+  uint16_t map_size = 1;
+  while (map_size < capacity * 2) {
+    map_size <<= 1;
+  }
+
+  size_t map_offset = sizeof(unlock_blocks_t) + capacity * sizeof(unlock_block_elm_t);
+  byte_t* arena = calloc(1, map_offset + map_size * sizeof(uint16_t));
+  unlock_blocks_t* blocks = (unlock_blocks_t*)arena;
+  if (blocks == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  blocks->count = 0;
+  blocks->capacity = capacity;
+  blocks->map_mask = map_size - 1;
+  blocks->elm = (unlock_block_elm_t*)(arena + sizeof(unlock_blocks_t));
+  blocks->pub_map = (uint16_t*)(arena + map_offset);
+  return blocks;
+}
 
-int unlock_blocks_add_signature(unlock_blocks_t** blocks, byte_t* sig, size_t sig_len) {
-  if (sig == NULL || sig_len != ED25519_SIGNATURE_BLOCK_BYTES) {
+int unlock_blocks_add_signature(unlock_blocks_t* blocks, byte_t* sig, size_t sig_len) {
+  if (blocks == NULL || sig == NULL || sig_len != ED25519_SIGNATURE_BLOCK_BYTES) {
     printf("[%s:%d] invalid signature\n", __func__, __LINE__);
     return -1;
   }
-  unlock_blocks_t* b = malloc(sizeof(unlock_blocks_t));
-  if (b == NULL) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
+
+  if (blocks->count >= blocks->capacity) {
+    printf("[%s:%d] unlock blocks are full\n", __func__, __LINE__);
     return -1;
   }
 
+  unlock_block_elm_t* b = &blocks->elm[blocks->count];
   b->type = 0;  // signature block
   b->reference = 0;
-  b->sig_block = malloc(ED25519_SIGNATURE_BLOCK_BYTES);
-  if (b->sig_block) {
-    memcpy(b->sig_block, sig, ED25519_SIGNATURE_BLOCK_BYTES);
-    LL_APPEND(*blocks, b);
-    return 0;
-  }
+  memcpy(b->sig_block, sig, ED25519_SIGNATURE_BLOCK_BYTES);
 
-  printf("[%s:%d] allocate signature block failed\n", __func__, __LINE__);
-  free(b);
-  return -1;
+  // the first signature block of a key is the one referenced
+  if (unlock_blocks_find_pub(blocks, sig + 1) == -1) {
+    uint16_t slot = pub_slot(blocks, sig + 1);
+    while (blocks->pub_map[slot] != 0) {
+      slot = (slot + 1) & blocks->map_mask;
+    }
+    blocks->pub_map[slot] = blocks->count + 1;
+  }
+  blocks->count++;
+  return 0;
 }
 
-int unlock_blocks_add_reference(unlock_blocks_t** blocks, uint16_t ref) {
+int unlock_blocks_add_reference(unlock_blocks_t* blocks, uint16_t ref) {
+  if (blocks == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
   // Unlock Blocks Count must match the amount of inputs. Must be 0 < x < 127.
   if (ref > UNLOCKED_BLOCKS_MAX_COUNT) {
     printf("[%s:%d] reference out of range \n", __func__, __LINE__);
@@ -48,32 +84,31 @@ int unlock_blocks_add_reference(unlock_blocks_t** blocks, uint16_t ref) {
 
   // TODO checking if the reference index points to a valid signature block
 
-  unlock_blocks_t* b = malloc(sizeof(unlock_blocks_t));
-  if (b == NULL) {
-    printf("[%s:%d] OOM\n", __func__, __LINE__);
+  if (blocks->count >= blocks->capacity) {
+    printf("[%s:%d] unlock blocks are full\n", __func__, __LINE__);
     return -1;
   }
 
+  unlock_block_elm_t* b = &blocks->elm[blocks->count];
   b->type = 1;  // reference block
   b->reference = ref;
-  b->sig_block = NULL;
-  LL_APPEND(*blocks, b);
+  blocks->count++;
   return 0;
 }
 
 size_t unlock_blocks_serialize_length(unlock_blocks_t* blocks) {
-  unlock_blocks_t* elm = NULL;
   size_t serialized_size = 0;
 
   // empty unlocked blocks
-  if (blocks == NULL) {
+  if (blocks == NULL || blocks->count == 0) {
     return 0;
   }
 
   // bytes of Unlock Blocks Count
   serialized_size += sizeof(uint16_t);
   // calculate serialized bytes of unlocked blocks
-  LL_FOREACH(blocks, elm) {
+  for (uint16_t i = 0; i < blocks->count; i++) {
+    unlock_block_elm_t const* elm = &blocks->elm[i];
     if (elm->type == 0) {
       serialized_size += UNLOCK_SIGNATURE_SERIALIZE_BYTES;
     } else if (elm->type == 1) {
@@ -87,7 +122,6 @@ size_t unlock_blocks_serialize_length(unlock_blocks_t* blocks) {
 }
 
 size_t unlock_blocks_serialize(unlock_blocks_t* blocks, byte_t buf[]) {
-  unlock_blocks_t* elm = NULL;
   byte_t* offset = buf;
 
   uint16_t block_count = unlock_blocks_count(blocks);
@@ -97,7 +131,8 @@ size_t unlock_blocks_serialize(unlock_blocks_t* blocks, byte_t buf[]) {
   offset += sizeof(block_count);
 
   // serializing unlocked blocks
-  LL_FOREACH(blocks, elm) {
+  for (uint16_t i = 0; i < block_count; i++) {
+    unlock_block_elm_t const* elm = &blocks->elm[i];
     if (elm->type == 0) {  // signature block
       memcpy(offset, &elm->type, sizeof(elm->type));
       offset += sizeof(elm->type);
@@ -114,49 +149,95 @@ size_t unlock_blocks_serialize(unlock_blocks_t* blocks, byte_t buf[]) {
   return (offset - buf) / sizeof(byte_t);
 }
 
-uint16_t unlock_blocks_count(unlock_blocks_t* blocks) {
-  unlock_blocks_t* elm = NULL;
-  uint16_t count = 0;
-  if (blocks) {
-    LL_COUNT(blocks, elm, count);
+size_t unlock_blocks_deserialize(byte_t const buf[], size_t len, unlock_blocks_t** blocks) {
+  uint16_t block_count = 0;
+  size_t offset = 0;
+
+  if (buf == NULL || blocks == NULL || len < sizeof(uint16_t)) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return 0;
   }
-  return count;
-}
 
-int32_t unlock_blocks_find_pub(unlock_blocks_t* blocks, byte_t const* const pub_key) {
-  unlock_blocks_t* elm;
-  int32_t count = 0;
-  if (blocks) {
-    LL_FOREACH(blocks, elm) {
+  memcpy(&block_count, buf, sizeof(uint16_t));
+  offset += sizeof(uint16_t);
+
+  uint16_t count = unlock_blocks_count(*blocks);
+  if (*blocks == NULL || (*blocks)->capacity < count + block_count) {
+    // a larger object holding the current blocks
+    if (count + block_count > UNLOCKED_BLOCKS_MAX_COUNT) {
+      printf("[%s:%d] too many unlocked blocks\n", __func__, __LINE__);
+      return 0;
+    }
+    unlock_blocks_t* b = unlock_blocks_new(count + block_count);
+    if (b == NULL) {
+      return 0;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+      unlock_block_elm_t const* elm = &(*blocks)->elm[i];
       if (elm->type == 0) {
-        if (memcmp(elm->sig_block + 1, pub_key, ED_PUBLIC_KEY_BYTES) == 0) {
-          return count;
-        }
+        unlock_blocks_add_signature(b, (byte_t*)elm->sig_block, ED25519_SIGNATURE_BLOCK_BYTES);
+      } else {
+        unlock_blocks_add_reference(b, elm->reference);
       }
-      count++;
     }
+    unlock_blocks_free(*blocks);
+    *blocks = b;
   }
-  return -1;
-}
 
-void unlock_blocks_free(unlock_blocks_t* blocks) {
-  unlock_blocks_t *elm, *tmp;
-  if (blocks) {
-    LL_FOREACH_SAFE(blocks, elm, tmp) {
-      if (elm->sig_block) {
-        free(elm->sig_block);
+  for (uint16_t i = 0; i < block_count; i++) {
+    if (offset + UNLOCK_REFERENCE_SERIALIZE_BYTES > len) {
+      printf("[%s:%d] truncated unlocked blocks\n", __func__, __LINE__);
+      return 0;
+    }
+    unlock_block_t type = buf[offset];
+    offset += sizeof(unlock_block_t);
+    if (type == 0 && offset + ED25519_SIGNATURE_BLOCK_BYTES <= len) {  // signature block
+      if (unlock_blocks_add_signature(*blocks, (byte_t*)buf + offset, ED25519_SIGNATURE_BLOCK_BYTES) != 0) {
+        return 0;
       }
-      LL_DELETE(blocks, elm);
-      free(elm);
+      offset += ED25519_SIGNATURE_BLOCK_BYTES;
+    } else if (type == 1) {  // reference block
+      uint16_t ref = 0;
+      memcpy(&ref, buf + offset, sizeof(uint16_t));
+      if (unlock_blocks_add_reference(*blocks, ref) != 0) {
+        return 0;
+      }
+      offset += sizeof(uint16_t);
+    } else {
+      printf("[%s:%d] invalid unlocked block\n", __func__, __LINE__);
+      return 0;
     }
   }
+  return offset;
+}
+
+uint16_t unlock_blocks_count(unlock_blocks_t* blocks) {
+  return blocks ? blocks->count : 0;
+}
+
+int32_t unlock_blocks_find_pub(unlock_blocks_t* blocks, byte_t const* const pub_key) {
+  if (blocks == NULL) {
+    return -1;
+  }
+  for (uint16_t slot = pub_slot(blocks, pub_key); blocks->pub_map[slot] != 0; slot = (slot + 1) & blocks->map_mask) {
+    uint16_t index = blocks->pub_map[slot] - 1;
+    if (memcmp(blocks->elm[index].sig_block + 1, pub_key, ED_PUBLIC_KEY_BYTES) == 0) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+void unlock_blocks_free(unlock_blocks_t* blocks) {
+  // blocks and the map are in the same allocation
+  free(blocks);
 }
 
 void unlock_blocks_print(unlock_blocks_t* blocks) {
-  unlock_blocks_t* elm;
   if (blocks) {
     printf("unlocked blocks[\n");
-    LL_FOREACH(blocks, elm) {
+    for (uint16_t i = 0; i < blocks->count; i++) {
+      unlock_block_elm_t const* elm = &blocks->elm[i];
       if (elm->type == 0) {  // signature block
         printf("\tSignautre block[ ");
         printf("Type: %s\n", (byte_t)elm->sig_block[0] ? "UNKNOW" : "ED25519");
@@ -32,14 +32,28 @@
 #define UNLOCK_SIGNATURE_SERIALIZE_BYTES (1 + ED25519_SIGNATURE_BLOCK_BYTES)
 
 /**
- * @brief An unlock block list object
+ * @brief An unlock block
  *
  */
-typedef struct unlock_blocks {
-  unlock_block_t type;         ///< 0 denotes a Signature Unlock Block, 1 denotes a Reference Unlock Block.
-  uint16_t reference;          ///< Represents the index of a pervious unlock block
-  byte_t* sig_block;           ///< signature type + public key + signature
-  struct unlock_blocks* next;  ///< point to next block
+typedef struct {
+  unlock_block_t type;                              ///< 0 denotes a Signature Unlock Block, 1 denotes a Reference
+                                                    ///< Unlock Block.
+  uint16_t reference;                               ///< Represents the index of a pervious unlock block
+  byte_t sig_block[ED25519_SIGNATURE_BLOCK_BYTES];  ///< signature type + public key + signature
+} unlock_block_elm_t;
+
+/**
+ * @brief A fixed-capacity array of unlock blocks
+ *
+ * Blocks and the public key map are in a single allocation, the map gives the signature block of a public key.
+ *
+ */
+typedef struct {
+  uint16_t count;           ///< The number of blocks
+  uint16_t capacity;        ///< The number of blocks the object holds
+  uint16_t map_mask;        ///< The number of map slots minus one, the slots are a power of two
+  unlock_block_elm_t* elm;  ///< The blocks in order of the inputs
+  uint16_t* pub_map;        ///< Open addressing map of public keys, the signature block index plus one, 0 if empty
 } unlock_blocks_t;
 
 /**
@@ -56,35 +70,36 @@ extern "C" {
  */
 
 /**
- * @brief Initialize a unlock block list object
+ * @brief Allocate an unlock block object
  *
- * @return unlock_blocks_t* a NULL pointer
+ * @param[in] capacity The maximum number of blocks, up to the number of inputs of a transaction
+ * @return unlock_blocks_t* NULL on failure
  */
-unlock_blocks_t* unlock_blocks_new(void);
+unlock_blocks_t* unlock_blocks_new(uint16_t capacity);
 
 /**
  * @brief Add an ed25519 signature block
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @param[in] sig An ed25519 signature block
  * @param[in] sig_len The length of signature block
  * @return int 0 on success
  */
-int unlock_blocks_add_signature(unlock_blocks_t** blocks, byte_t* sig, size_t sig_len);
+int unlock_blocks_add_signature(unlock_blocks_t* blocks, byte_t* sig, size_t sig_len);
 
 /**
  * @brief Add a reference block
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @param[in] ref The index of reference
  * @return int 0 on success.
  */
-int unlock_blocks_add_reference(unlock_blocks_t** blocks, uint16_t ref);
+int unlock_blocks_add_reference(unlock_blocks_t* blocks, uint16_t ref);
 
 /**
  * @brief Get the length of unlock blocks
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @return uint16_t
  */
 uint16_t unlock_blocks_count(unlock_blocks_t* blocks);
@@ -92,16 +107,16 @@ uint16_t unlock_blocks_count(unlock_blocks_t* blocks);
 /**
  * @brief Get the block index of a given public key
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @param[in] pub_key A ed25519 public key
- * @return int32_t if not found return -1 else retrun the index
+ * @return int32_t if not found return -1 else retrun the index of the first signature block of the key
  */
 int32_t unlock_blocks_find_pub(unlock_blocks_t* blocks, byte_t const* const pub_key);
 
 /**
  * @brief Get the serialized length of unlocked blocks
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @return size_t 0 on failed
  */
 size_t unlock_blocks_serialize_length(unlock_blocks_t* blocks);
@@ -109,14 +124,26 @@ size_t unlock_blocks_serialize_length(unlock_blocks_t* blocks);
 /**
  * @brief Serialize unlock blocks
  *
- * @param[in] blocks The head of list
+ * @param[in] blocks An unlock block object
  * @param[out] buf A buffer holds serialized data
  * @return size_t number of bytes written to the buffer
  */
 size_t unlock_blocks_serialize(unlock_blocks_t* blocks, byte_t buf[]);
 
 /**
- * @brief Free an unlock block list
+ * @brief Deserialize unlock blocks and append them to an unlock block object
+ *
+ * The object is replaced by a larger one if it cannot hold the deserialized blocks.
+ *
+ * @param[in] buf The serialized blocks, starting with the block count
+ * @param[in] len The length of the buffer, it can hold more data after the blocks
+ * @param[in,out] blocks An unlock block object, it can be NULL
+ * @return size_t number of bytes read from the buffer, 0 on failure
+ */
+size_t unlock_blocks_deserialize(byte_t const buf[], size_t len, unlock_blocks_t** blocks);
+
+/**
+ * @brief Free an unlock block object
  *
  * @param[in] blocks An unlock block object
  */
@@ -0,0 +1,278 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/pow.h"
+#include "crypto/iota_crypto.h"
+
+// Curl-P-81 parameters
+#define CURL_HASH_TRITS 243
+#define CURL_STATE_TRITS (CURL_HASH_TRITS * 3)
+#define CURL_ROUNDS 81
+
+// b1t6 encodes a byte in 6 trits
+#define POW_DIGEST_TRITS (CRYPTO_BLAKE2B_HASH_BYTES * 6)
+#define POW_NONCE_TRITS (POW_NONCE_BYTES * 6)
+
+// one lane per bit, the native word size gives the most nonces per hash
+#if UINTPTR_MAX > 0xFFFFFFFFu
+typedef uint64_t pow_lanes_t;
+#else
+typedef uint32_t pow_lanes_t;
+#endif
+#define POW_LANES (sizeof(pow_lanes_t) * 8)
+
+// bit-sliced trits: 0 is (1, 1), 1 is (0, 1) and -1 is (1, 0) in (low, high)
+typedef struct {
+  pow_lanes_t low[2][CURL_STATE_TRITS];
+  pow_lanes_t high[2][CURL_STATE_TRITS];
+} curl_state_t;
+
+// balanced trits of a tryte value in [-13, 13], least significant first
+static void tryte_to_trits(int v, int8_t trits[3]) {
+  for (int i = 0; i < 3; i++) {
+    int r = ((v % 3) + 3) % 3;
+    if (r == 2) {
+      r = -1;
+    }
+    trits[i] = (int8_t)r;
+    v = (v - r) / 3;
+  }
+}
+
+// b1t6 encoding, each byte as a signed value is split in two trytes
+static void b1t6_encode(byte_t const bytes[], size_t len, int8_t trits[]) {
+  for (size_t i = 0; i < len; i++) {
+    int v = (int)(int8_t)bytes[i] + 364;
+    tryte_to_trits((v % 27) - 13, trits + (i * 6));
+    tryte_to_trits((v / 27) - 13, trits + (i * 6) + 3);
+  }
+}
+
+static void trit_set(curl_state_t *st, size_t i, int8_t trit, pow_lanes_t lanes) {
+  if (trit == 1) {
+    st->low[0][i] &= ~lanes;
+    st->high[0][i] |= lanes;
+  } else if (trit == -1) {
+    st->low[0][i] |= lanes;
+    st->high[0][i] &= ~lanes;
+  } else {
+    st->low[0][i] |= lanes;
+    st->high[0][i] |= lanes;
+  }
+}
+
+// absorbs the digest and a nonce per lane into a zero state
+static void curl_init(curl_state_t *st, int8_t const digest_trits[], uint64_t base_nonce) {
+  int8_t nonce_trits[POW_NONCE_TRITS];
+  byte_t nonce_bytes[POW_NONCE_BYTES];
+
+  for (size_t i = 0; i < CURL_STATE_TRITS; i++) {
+    st->low[0][i] = ~(pow_lanes_t)0;
+    st->high[0][i] = ~(pow_lanes_t)0;
+  }
+  for (size_t i = 0; i < POW_DIGEST_TRITS; i++) {
+    trit_set(st, i, digest_trits[i], ~(pow_lanes_t)0);
+  }
+  for (size_t lane = 0; lane < POW_LANES; lane++) {
+    uint64_t nonce = base_nonce + lane;
+    // little endian, as in the serialized message
+    for (size_t i = 0; i < POW_NONCE_BYTES; i++) {
+      nonce_bytes[i] = (byte_t)(nonce >> (8 * i));
+    }
+    b1t6_encode(nonce_bytes, POW_NONCE_BYTES, nonce_trits);
+    for (size_t i = 0; i < POW_NONCE_TRITS; i++) {
+      trit_set(st, POW_DIGEST_TRITS + i, nonce_trits[i], (pow_lanes_t)1 << lane);
+    }
+  }
+}
+
+// Curl-P-81 transform of all lanes at once, returns the index of the buffers holding the result
+static int curl_transform(curl_state_t *st) {
+  int from = 0;
+  for (int round = 0; round < CURL_ROUNDS; round++) {
+    pow_lanes_t const *from_low = st->low[from];
+    pow_lanes_t const *from_high = st->high[from];
+    pow_lanes_t *to_low = st->low[from ^ 1];
+    pow_lanes_t *to_high = st->high[from ^ 1];
+    size_t index = 0;
+    for (size_t i = 0; i < CURL_STATE_TRITS; i++) {
+      pow_lanes_t alpha = from_low[index];
+      pow_lanes_t beta = from_high[index];
+      index = (index < 365) ? (index + 364) : (index - 365);
+      pow_lanes_t gamma = from_high[index];
+      pow_lanes_t delta = (alpha | ~gamma) & (from_low[index] ^ beta);
+      to_low[i] = ~delta;
+      to_high[i] = (alpha ^ gamma) | delta;
+    }
+    from ^= 1;
+  }
+  return from;
+}
+
+// lanes whose hash ends with at least target zero trits
+static pow_lanes_t curl_match(curl_state_t const *st, int buf, uint8_t target_zeros) {
+  pow_lanes_t match = ~(pow_lanes_t)0;
+  for (size_t i = 0; i < target_zeros && match; i++) {
+    match &= st->low[buf][CURL_HASH_TRITS - 1 - i] & st->high[buf][CURL_HASH_TRITS - 1 - i];
+  }
+  return match;
+}
+
+uint8_t pow_target_zeros(size_t msg_len, uint64_t min_score) {
+  uint8_t zeros = 0;
+  uint64_t pow3 = 1;
+  uint64_t target = (uint64_t)msg_len * min_score;
+  while (pow3 < target && zeros < CURL_HASH_TRITS) {
+    if (pow3 > UINT64_MAX / 3) {
+      // 3^41 is beyond any target
+      zeros++;
+      break;
+    }
+    pow3 *= 3;
+    zeros++;
+  }
+  return zeros;
+}
+
+uint8_t pow_trailing_zeros(byte_t const msg[], size_t msg_len) {
+  byte_t digest[CRYPTO_BLAKE2B_HASH_BYTES];
+  int8_t digest_trits[POW_DIGEST_TRITS];
+  uint64_t nonce = 0;
+  uint8_t zeros = 0;
+
+  if (msg == NULL || msg_len < POW_NONCE_BYTES) {
+    return 0;
+  }
+
+  curl_state_t *st = malloc(sizeof(curl_state_t));
+  if (st == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return 0;
+  }
+
+  if (iota_blake2b_sum(msg, msg_len - POW_NONCE_BYTES, digest, sizeof(digest)) == 0) {
+    for (size_t i = 0; i < POW_NONCE_BYTES; i++) {
+      nonce |= (uint64_t)msg[msg_len - POW_NONCE_BYTES + i] << (8 * i);
+    }
+    b1t6_encode(digest, sizeof(digest), digest_trits);
+    curl_init(st, digest_trits, nonce);
+    int buf = curl_transform(st);
+    // the nonce of the message is in the first lane
+    while (zeros < CURL_HASH_TRITS && (curl_match(st, buf, zeros + 1) & 1)) {
+      zeros++;
+    }
+  }
+
+  free(st);
+  return zeros;
+}
+
+int pow_search(byte_t const data[], size_t data_len, uint8_t target_zeros, pow_worker_t const *worker,
+               uint64_t *nonce) {
+  int ret = -1;
+  byte_t digest[CRYPTO_BLAKE2B_HASH_BYTES];
+  int8_t digest_trits[POW_DIGEST_TRITS];
+
+  if (data == NULL || nonce == NULL || target_zeros > CURL_HASH_TRITS) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  uint64_t worker_id = worker ? worker->worker_id : 0;
+  uint64_t worker_count = (worker && worker->worker_count) ? worker->worker_count : 1;
+  if (worker_id >= worker_count) {
+    printf("[%s:%d] invalid worker\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (iota_blake2b_sum(data, data_len, digest, sizeof(digest)) != 0) {
+    printf("[%s:%d] PoW digest failed\n", __func__, __LINE__);
+    return -1;
+  }
+  b1t6_encode(digest, sizeof(digest), digest_trits);
+
+  curl_state_t *st = malloc(sizeof(curl_state_t));
+  if (st == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // workers take every worker_count-th batch of nonces
+  for (uint64_t batch = worker_id; batch <= (UINT64_MAX / POW_LANES) - 1; batch += worker_count) {
+    if (worker && worker->cancel && worker->cancel(worker->opaque)) {
+      break;
+    }
+    uint64_t base = batch * POW_LANES;
+    curl_init(st, digest_trits, base);
+    pow_lanes_t match = curl_match(st, curl_transform(st), target_zeros);
+    if (base == 0) {
+      // a zero nonce asks the node for the proof-of-work, the message ID would change
+      match &= ~(pow_lanes_t)1;
+    }
+    if (match) {
+      // the lowest nonce of the batch
+      uint64_t lane = 0;
+      while ((match & 1) == 0) {
+        match >>= 1;
+        lane++;
+      }
+      *nonce = base + lane;
+      ret = 0;
+      break;
+    }
+  }
+
+  free(st);
+  return ret;
+}
+
+int core_message_pow(core_message_t *msg, uint64_t min_score, pow_worker_t const *worker) {
+  if (msg == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t msg_len = core_message_serialize_length(msg);
+  if (msg_len == 0) {
+    return -1;
+  }
+
+  byte_t *b_msg = malloc(msg_len);
+  if (b_msg == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  int ret = core_message_pow_buf(msg, min_score, worker, b_msg, msg_len);
+  free(b_msg);
+  return ret;
+}
+
+int core_message_pow_buf(core_message_t *msg, uint64_t min_score, pow_worker_t const *worker, byte_t buf[],
+                         size_t buf_len) {
+  uint64_t nonce = 0;
+
+  if (msg == NULL || buf == NULL) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  size_t msg_len = core_message_serialize(msg, buf, buf_len);
+  if (msg_len == 0 || msg_len > buf_len) {
+    printf("[%s:%d] serialize message failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (pow_search(buf, msg_len - POW_NONCE_BYTES, pow_target_zeros(msg_len, min_score), worker, &nonce) != 0) {
+    return -1;
+  }
+
+  // the nonce is the last field of the message
+  msg->nonce = nonce;
+  memcpy(buf + msg_len - POW_NONCE_BYTES, &nonce, POW_NONCE_BYTES);
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __CORE_POW_H__
+#define __CORE_POW_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core/models/models_message.h"
+#include "core/types.h"
+
+/** @addtogroup IOTA_C
+ * @{
+ */
+
+/** @addtogroup CORE
+ * @{
+ */
+
+/** @defgroup CORE_POW Proof of Work
+ * @{
+ */
+
+/** @defgroup CORE_POW_EXPORTED_CONSTANTS Exported Constants
+ * @{
+ */
+
+// The nonce is the last field of a serialized message
+#define POW_NONCE_BYTES 8
+
+/**
+ * @}
+ */
+
+/** @defgroup CORE_POW_EXPORTED_TYPES Exported Types
+ * @{
+ */
+
+/**
+ * @brief Cancel callback, polled between two batches of nonces
+ *
+ * @param[in] opaque The user context
+ * @return bool true to stop the search
+ */
+typedef bool (*pow_cancel_t)(void *opaque);
+
+/**
+ * @brief Partition and control of a nonce search
+ *
+ * Workers with the same worker_count and distinct worker_id test disjoint nonces, so the search can be spread over
+ * several tasks or cores. The first worker that finds a nonce should make the cancel callback of the others return
+ * true.
+ *
+ */
+typedef struct {
+  uint32_t worker_id;     ///< The index of this worker, from 0 to worker_count - 1
+  uint32_t worker_count;  ///< The number of workers sharing the search, 0 or 1 for a single worker
+  pow_cancel_t cancel;    ///< Optional, the search stops when it returns true
+  void *opaque;           ///< The context of the cancel callback
+} pow_worker_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup CORE_POW_EXPORTED_FUNCTIONS Exported Functions
+ * @{
+ */
+
+/**
+ * @brief Get the number of trailing zero trits needed to reach a PoW score
+ *
+ * The score of a message is 3^trailing_zeros / message_length.
+ *
+ * @param[in] msg_len The length of the serialized message, nonce included
+ * @param[in] min_score The minimum PoW score of the network
+ * @return uint8_t The number of trailing zero trits
+ */
+uint8_t pow_target_zeros(size_t msg_len, uint64_t min_score);
+
+/**
+ * @brief Get the number of trailing zero trits of a serialized message
+ *
+ * @param[in] msg The serialized message, ending with the nonce
+ * @param[in] msg_len The length of the message
+ * @return uint8_t The number of trailing zero trits of the Curl-P-81 hash
+ */
+uint8_t pow_trailing_zeros(byte_t const msg[], size_t msg_len);
+
+/**
+ * @brief Search a nonce for serialized message data
+ *
+ * The BLAKE2b-256 digest of the data and the nonce are encoded to trits and hashed with Curl-P-81, a batch of nonces
+ * is tested with each bit-sliced hash.
+ *
+ * @param[in] data The serialized message without its nonce
+ * @param[in] data_len The length of the data
+ * @param[in] target_zeros The number of trailing zero trits to reach
+ * @param[in] worker The search partition and cancel callback, NULL for a single worker
+ * @param[out] nonce The nonce found, never 0 as a zero nonce asks the node for the proof-of-work
+ * @return int 0 on success, -1 on failure or if cancelled
+ */
+int pow_search(byte_t const data[], size_t data_len, uint8_t target_zeros, pow_worker_t const *worker,
+               uint64_t *nonce);
+
+/**
+ * @brief Do the proof-of-work of a message and set its nonce
+ *
+ * Parents and network ID must be set, the nonce is the only field that changes.
+ *
+ * @param[in] msg A message object
+ * @param[in] min_score The minimum PoW score of the network, see get_node_info()
+ * @param[in] worker The search partition and cancel callback, NULL for a single worker
+ * @return int 0 on success, -1 on failure or if cancelled
+ */
+int core_message_pow(core_message_t *msg, uint64_t min_score, pow_worker_t const *worker);
+
+/**
+ * @brief Do the proof-of-work of a message in a caller buffer and set its nonce
+ *
+ * The buffer holds the complete serialized message on success, ready to be hashed for its ID and sent.
+ *
+ * @param[in] msg A message object
+ * @param[in] min_score The minimum PoW score of the network, see get_node_info()
+ * @param[in] worker The search partition and cancel callback, NULL for a single worker
+ * @param[out] buf A buffer of core_message_serialize_length() bytes at least
+ * @param[in] buf_len The size of the buffer
+ * @return int 0 on success, -1 on failure, if cancelled or if the buffer is too small
+ */
+int core_message_pow_buf(core_message_t *msg, uint64_t min_score, pow_worker_t const *worker, byte_t buf[],
+                         size_t buf_len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif
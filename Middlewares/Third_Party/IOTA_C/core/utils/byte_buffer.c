@@ -8,6 +8,25 @@
 
 static char const* const hex_table = "0123456789ABCDEF";
 
+// smallest capacity allocated when an append grows the buffer
+#define BYTE_BUF_MIN_GROWTH 64
+
+// grows the capacity by half of the current one at least, so that a sequence of appends is amortized
+static bool byte_buf_grow(byte_buf_t* buf, size_t len) {
+  if (buf->cap >= len) {
+    return true;
+  }
+
+  size_t new_cap = buf->cap + (buf->cap / 2);
+  if (new_cap < BYTE_BUF_MIN_GROWTH) {
+    new_cap = BYTE_BUF_MIN_GROWTH;
+  }
+  if (new_cap < len) {
+    new_cap = len;
+  }
+  return byte_buf_reserve(buf, new_cap);
+}
+
 static int char2int(char input) {
   if (input >= '0' && input <= '9') return input - '0';
   if (input >= 'A' && input <= 'F') return input - 'A' + 10;
@@ -164,7 +183,7 @@ bool byte_buf_append(byte_buf_t* buf, byte_t const data[], size_t len) {
   // needed capacity
   size_t needed_cap = buf->len + len;
 
-  if (byte_buf_reserve(buf, needed_cap) == false) {
+  if (byte_buf_grow(buf, needed_cap) == false) {
     return false;
   }
 
@@ -208,13 +227,24 @@ bool byte_buf2str(byte_buf_t* buf) {
   bool ret = true;
   byte_t null_char = '\0';
   if (buf && buf->data) {
-    if (buf->data[buf->len - 1] != null_char) {
+    // an empty buffer gets the terminator at data[0]
+    if (buf->len == 0 || buf->data[buf->len - 1] != null_char) {
       ret = byte_buf_append(buf, &null_char, 1);
     }
   }
   return ret;
 }
 
+size_t byte_buf_str_len(byte_buf_t const* buf) {
+  size_t len = 0;
+  if (buf && buf->data) {
+    while (len < buf->len && buf->data[len] != '\0') {
+      len++;
+    }
+  }
+  return len;
+}
+
 byte_buf_t* byte_buf_str2hex(byte_buf_t* buf) {
   byte_buf_t* hex_str = byte_buf_new();
   byte_buf_reserve(hex_str, (buf->len * 2) + 1);
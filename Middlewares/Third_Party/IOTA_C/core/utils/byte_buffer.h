@@ -70,6 +70,8 @@ byte_buf_t* byte_buf_new_with_data(byte_t data[], size_t len);
 /**
  * @brief Appends data to buffer
  *
+ * The capacity grows geometrically, call byte_buf_reserve() first when the final size is known.
+ *
  * @param[in] buf A buffer object
  * @param[in] data The data for appending
  * @param[in] len The size of data
@@ -105,6 +107,14 @@ void byte_buf_free(byte_buf_t* buf);
  */
 bool byte_buf2str(byte_buf_t* buf);
 
+/**
+ * @brief The length of a string kept in a byte buffer, the terminator is optional
+ *
+ * @param[in] buf A byte buffer
+ * @return size_t The number of bytes before the first terminator or the end of the buffer
+ */
+size_t byte_buf_str_len(byte_buf_t const* buf);
+
 /**
  * @brief Duplicates N bytes from buffer
  *
@@ -125,6 +135,8 @@ byte_buf_t* byte_buf_clone(byte_buf_t* buf);
 /**
  * @brief Changes the buffer capacity
  *
+ * The capacity is set to the exact requested size, it is never reduced.
+ *
  * @param[in] buf A byte buffer
  * @param[in] len The expect size of this buffer
  * @return true On success
@@ -7,7 +7,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "core/utils/iota_str.h"
 #include "core/utils/slip10.h"
 #include "crypto/iota_crypto.h"
 
@@ -97,25 +96,28 @@ int slip10_parse_path(char str[], bip32_path_t* path) {
     return -1;
   }
 
-  int ret = 0;
-  iota_str_t* path_buf = iota_str_new(str + 2);
-  char* token = strtok(path_buf->buf, "/");
+  // tokens are read in place, no copy of the string is needed for strtok
+  char const* token = str + 2;
   path->len = 0;
-  while (token != NULL) {
+  while (*token != '\0') {
+    if (*token == '/') {
+      // an empty token, as skipped by strtok
+      token++;
+      continue;
+    }
+
     char* ptr = NULL;
     // check token format
     if (strncmp(token, "\'", 1) == 0 || strncmp(token, "H", 1) == 0) {
       // invalid format
-      ret = -1;
-      goto end;
+      return -1;
     }
 
     // get value
     unsigned long value = strtoul(token, &ptr, 10);
     if (value >= BIP32_HARDENED) {
       // out of range
-      ret = -2;
-      goto end;
+      return -2;
     }
 
     // hardened
@@ -123,48 +125,80 @@ int slip10_parse_path(char str[], bip32_path_t* path) {
       value |= BIP32_HARDENED;
     }
     path->path[path->len] = value;
-
-    // gets next token
-    token = strtok(NULL, "/");
     path->len += 1;
 
     if (path->len >= MAX_BIP32_PATH) {
       // path too long
-      ret = -3;
-      goto end;
+      return -3;
+    }
+
+    // gets next token
+    if ((token = strchr(token, '/')) == NULL) {
+      break;
     }
   }
-end:
-  iota_str_destroy(path_buf);
-  return ret;
+  return 0;
 }
 
-int slip10_key_from_path(byte_t seed[], size_t seed_len, char path[], slip10_curve_t curve, slip10_key_t* key) {
+int slip10_key_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len,
+                            slip10_curve_t curve, slip10_key_t* key) {
   if (curve == SECP256K1_CURVE || curve == NIST_P256_CURVE) {
     // TODO: support secp256k1 and NIST P-256 curves
     return -1;
   }
 
-  bip32_path_t bip32_path;
-  memset(&bip32_path, 0, sizeof(bip32_path_t));
-  if (slip10_parse_path(path, &bip32_path) != 0) {
+  if (path_len > MAX_BIP32_PATH || (path_len && path == NULL)) {
     // invalid path
     return -2;
   }
 
   master_key_generation(seed, seed_len, curve, key);
 
-  for (int i = 0; i < bip32_path.len; i++) {
-    if (curve == ED25519_CURVE && bip32_path.path[i] < BIP32_HARDENED) {
+  for (size_t i = 0; i < path_len; i++) {
+    if (curve == ED25519_CURVE && path[i] < BIP32_HARDENED) {
       // ed25519 only supports hardened indices
       return -3;
     }
-    child_key_derivation(bip32_path.path[i], key);
+    child_key_derivation(path[i], key);
   }
 
   return 0;
 }
 
+int slip10_key_from_path(byte_t seed[], size_t seed_len, char path[], slip10_curve_t curve, slip10_key_t* key) {
+  if (curve == SECP256K1_CURVE || curve == NIST_P256_CURVE) {
+    // TODO: support secp256k1 and NIST P-256 curves
+    return -1;
+  }
+
+  bip32_path_t bip32_path;
+  memset(&bip32_path, 0, sizeof(bip32_path_t));
+  if (slip10_parse_path(path, &bip32_path) != 0) {
+    // invalid path
+    return -2;
+  }
+
+  return slip10_key_from_indices(seed, seed_len, bip32_path.path, (size_t)bip32_path.len, curve, key);
+}
+
+int slip10_key_derive_child(slip10_curve_t curve, slip10_key_t const* parent, uint32_t index, slip10_key_t* child) {
+  if (curve == SECP256K1_CURVE || curve == NIST_P256_CURVE) {
+    // TODO: support secp256k1 and NIST P-256 curves
+    return -1;
+  }
+
+  if (index < BIP32_HARDENED) {
+    // ed25519 only supports hardened indices
+    return -3;
+  }
+
+  if (child != parent) {
+    memcpy(child, parent, sizeof(slip10_key_t));
+  }
+  child_key_derivation(index, child);
+  return 0;
+}
+
 int slip10_public_key(slip10_curve_t curve, slip10_key_t* key, byte_t pub_key[]) {
   if (curve == SECP256K1_CURVE || curve == NIST_P256_CURVE) {
     // TODO: support secp256k1 and NIST P-256 curves
@@ -75,6 +75,22 @@ extern "C" {
  */
 int slip10_parse_path(char str[], bip32_path_t* path);
 
+/**
+ * @brief Derives key from given seed and path indices
+ *
+ * The binary form of slip10_key_from_path(), no string is formatted or parsed.
+ *
+ * @param[in] seed A seed in byte array
+ * @param[in] seed_len The length of seed
+ * @param[in] path The path indices, hardened indices have the BIP32_HARDENED bit set
+ * @param[in] path_len The number of indices, up to MAX_BIP32_PATH
+ * @param[in] curve The type of curve, only support ed25519
+ * @param[out] key The derived key
+ * @return int 0 on successful
+ */
+int slip10_key_from_indices(byte_t seed[], size_t seed_len, uint32_t const path[], size_t path_len,
+                            slip10_curve_t curve, slip10_key_t* key);
+
 /**
  * @brief Derives key from given seed and path
  *
@@ -87,6 +103,20 @@ int slip10_parse_path(char str[], bip32_path_t* path);
  */
 int slip10_key_from_path(byte_t seed[], size_t seed_len, char path[], slip10_curve_t curve, slip10_key_t* key);
 
+/**
+ * @brief Derives a child key from a parent extended key
+ *
+ * A parent node kept by the caller, e.g. m/44'/4218'/Account'/Change', makes the derivation of its children cost a
+ * single HMAC-SHA512 instead of one per level of the path.
+ *
+ * @param[in] curve The type of curve, only support ed25519
+ * @param[in] parent The parent key
+ * @param[in] index The child index, hardened for ed25519
+ * @param[out] child The derived key, can be the parent
+ * @return int 0 on successful
+ */
+int slip10_key_derive_child(slip10_curve_t curve, slip10_key_t const* parent, uint32_t index, slip10_key_t* child);
+
 /**
  * @brief Get public key from the derived key
  *
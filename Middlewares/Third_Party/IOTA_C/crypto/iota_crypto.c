@@ -9,6 +9,7 @@
 #include "mbedtls/entropy.h"
 #include "mbedtls/md.h"
 #include "mbedtls/pkcs5.h"
+#include "mbedtls/platform_util.h"
 #include "mbedtls/sha256.h"
 #include "mbedtls/sha512.h"
 #elif CRYPTO_USE_OPENSSL
@@ -44,6 +45,13 @@
 
 #include "crypto/iota_crypto.h"
 
+// hosted builds run the libsodium CPU feature detection, it replaces the portable BLAKE2b compression with the
+// SSE4.1 or AVX2 one. sodium_init() needs an OS entropy source, bare-metal targets keep the portable code.
+#if defined(CRYPTO_USE_SODIUM) && (defined(__linux__) || defined(__APPLE__) || defined(_WIN32))
+#define CRYPTO_SODIUM_RUNTIME_INIT
+static bool crypto_initialized = false;
+#endif
+
 #ifdef CRYPTO_USE_SODIUM
 // store 32 bits in big-endian
 static inline void store32_be(uint8_t dst[4], uint32_t w) {
@@ -64,8 +72,85 @@ static inline void store32_be(uint8_t dst[4], uint32_t w) {
 extern struct __RNG_HandleTypeDef hrng;
 int iota_rng_raw(void *data, uint8_t *output, size_t len);
 
+#if defined(CRYPTO_USE_SODIUM)
+// refills of the pool are ChaCha20 keystream, small requests such as nonces are served from it
+#define CRYPTO_RNG_POOL_BYTES 256
+
+static struct {
+  uint8_t key[crypto_stream_chacha20_KEYBYTES];
+  uint8_t pool[CRYPTO_RNG_POOL_BYTES];
+  size_t avail;      // unused bytes at the end of the pool
+  uint32_t streams;  // keystreams since the last reseed
+  bool seeded;
+} rng_ctx;
+
+// mix fresh hardware entropy into the key, the previous key is kept so a bad read does not weaken the state
+static int rng_reseed(void) {
+  uint8_t entropy[crypto_stream_chacha20_KEYBYTES];
+  uint8_t key[crypto_stream_chacha20_KEYBYTES];
+
+  if (iota_rng_raw(&hrng, entropy, sizeof(entropy)) != 0) {
+    return -1;
+  }
+  crypto_generichash(key, sizeof(key), entropy, sizeof(entropy), rng_ctx.seeded ? rng_ctx.key : NULL,
+                     rng_ctx.seeded ? sizeof(rng_ctx.key) : 0);
+  memcpy(rng_ctx.key, key, sizeof(key));
+  sodium_memzero(entropy, sizeof(entropy));
+  sodium_memzero(key, sizeof(key));
+  // the pool was drawn from the previous key
+  sodium_memzero(rng_ctx.pool, sizeof(rng_ctx.pool));
+  rng_ctx.avail = 0;
+  rng_ctx.streams = 0;
+  rng_ctx.seeded = true;
+  return 0;
+}
+
+// the first keystream block is the next key, so past outputs can not be recovered from the state
+static void rng_stream(uint8_t *out, size_t len) {
+  static uint8_t const nonce[crypto_stream_chacha20_NONCEBYTES] = {0};
+  uint8_t key[crypto_stream_chacha20_KEYBYTES];
+
+  memset(out, 0, len);
+  crypto_stream_chacha20_xor_ic(out, out, len, nonce, 1, rng_ctx.key);
+  crypto_stream_chacha20(key, sizeof(key), nonce, rng_ctx.key);
+  memcpy(rng_ctx.key, key, sizeof(key));
+  sodium_memzero(key, sizeof(key));
+  rng_ctx.streams++;
+}
+#elif defined(CRYPTO_USE_MBEDTLS) && !defined(__ZEPHYR__)
+static mbedtls_ctr_drbg_context rng_drbg;
+static mbedtls_entropy_context rng_entropy;
+static bool rng_seeded = false;
+static bool rng_reseed_pending = false;
+#endif
+
 void iota_crypto_randombytes(uint8_t *const buf, const size_t len) {
-#if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
+#if defined(CRYPTO_USE_SODIUM)
+  CRYPTO_RNG_LOCK();
+  if (!rng_ctx.seeded || rng_ctx.streams >= CRYPTO_RNG_RESEED_INTERVAL) {
+    if (rng_reseed() != 0) {
+      // hardware entropy only, as without a generator
+      CRYPTO_RNG_UNLOCK();
+      iota_rng_raw(&hrng, buf, len);
+      return;
+    }
+  }
+
+  if (len > sizeof(rng_ctx.pool)) {
+    rng_stream(buf, len);
+  } else {
+    if (len > rng_ctx.avail) {
+      rng_stream(rng_ctx.pool, sizeof(rng_ctx.pool));
+      rng_ctx.avail = sizeof(rng_ctx.pool);
+    }
+    // bytes are taken from the end of the pool and wiped
+    uint8_t *p = rng_ctx.pool + sizeof(rng_ctx.pool) - rng_ctx.avail;
+    memcpy(buf, p, len);
+    sodium_memzero(p, len);
+    rng_ctx.avail -= len;
+  }
+  CRYPTO_RNG_UNLOCK();
+#elif defined(CRYPTO_USE_STLIB)
   iota_rng_raw(&hrng, buf, len);
 
 // TODO: validate on Mbed OS
@@ -82,20 +167,36 @@ void iota_crypto_randombytes(uint8_t *const buf, const size_t len) {
   sys_csrand_get(buf, len);
 #endif
 #elif defined(CRYPTO_USE_MBEDTLS)
-  int ret = 0;
-  mbedtls_ctr_drbg_context drbg;
-  mbedtls_entropy_context ent;
-
-  mbedtls_ctr_drbg_init(&drbg);
-  mbedtls_entropy_init(&ent);
-
-  ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &ent, (unsigned char const *)"CTR_DRBG", 8);
-  if (ret == 0) {
-    mbedtls_ctr_drbg_random(&drbg, buf, len);
+  CRYPTO_RNG_LOCK();
+  // seeded on first use and kept for all callers
+  if (!rng_seeded) {
+    mbedtls_ctr_drbg_init(&rng_drbg);
+    mbedtls_entropy_init(&rng_entropy);
+    if (mbedtls_ctr_drbg_seed(&rng_drbg, mbedtls_entropy_func, &rng_entropy, (unsigned char const *)"CTR_DRBG", 8) !=
+        0) {
+      mbedtls_entropy_free(&rng_entropy);
+      mbedtls_ctr_drbg_free(&rng_drbg);
+      CRYPTO_RNG_UNLOCK();
+      return;
+    }
+    mbedtls_ctr_drbg_set_reseed_interval(&rng_drbg, CRYPTO_RNG_RESEED_INTERVAL);
+    rng_seeded = true;
+  } else if (rng_reseed_pending) {
+    mbedtls_ctr_drbg_reseed(&rng_drbg, NULL, 0);
   }
+  rng_reseed_pending = false;
 
-  mbedtls_entropy_free(&ent);
-  mbedtls_ctr_drbg_free(&drbg);
+  // a request is limited to MBEDTLS_CTR_DRBG_MAX_REQUEST bytes
+  for (size_t offset = 0; offset < len; offset += MBEDTLS_CTR_DRBG_MAX_REQUEST) {
+    size_t chunk = len - offset;
+    if (chunk > MBEDTLS_CTR_DRBG_MAX_REQUEST) {
+      chunk = MBEDTLS_CTR_DRBG_MAX_REQUEST;
+    }
+    if (mbedtls_ctr_drbg_random(&rng_drbg, buf + offset, chunk) != 0) {
+      break;
+    }
+  }
+  CRYPTO_RNG_UNLOCK();
 #elif defined(CRYPTO_USE_OPENSSL)
   RAND_bytes(buf, len);
 #else
@@ -103,6 +204,18 @@ void iota_crypto_randombytes(uint8_t *const buf, const size_t len) {
 #endif
 }
 
+void iota_crypto_rng_reseed(void) {
+#if defined(CRYPTO_USE_SODIUM)
+  CRYPTO_RNG_LOCK();
+  rng_ctx.streams = CRYPTO_RNG_RESEED_INTERVAL;
+  CRYPTO_RNG_UNLOCK();
+#elif defined(CRYPTO_USE_MBEDTLS) && !defined(__ZEPHYR__)
+  CRYPTO_RNG_LOCK();
+  rng_reseed_pending = true;
+  CRYPTO_RNG_UNLOCK();
+#endif
+}
+
 // get ed25519 public and private key from address
 void iota_crypto_keypair(uint8_t const seed[], iota_keypair_t *keypair) {
 #if defined(CRYPTO_USE_SODIUM)
@@ -170,6 +283,49 @@ int iota_crypto_sign(uint8_t const priv_key[], uint8_t msg[], size_t msg_len, ui
 #endif
 }
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+int iota_crypto_verify(uint8_t const pub_key[], uint8_t const msg[], size_t msg_len, uint8_t const signature[]) {
+#if defined(CRYPTO_USE_SODIUM)
+  return crypto_sign_ed25519_verify_detached(signature, msg, msg_len, pub_key) == 0 ? 0 : -1;
+#elif defined(CRYPTO_USE_ED25519_DONNA)
+  return ed25519_sign_open(msg, msg_len, pub_key, signature) == 0 ? 0 : -1;
+#else
+#error ed25519 is not defined
+#endif
+}
+
+int iota_crypto_verify_batch(uint8_t const *pub_keys[], uint8_t const *msgs[], size_t msg_lens[],
+                             uint8_t const *signatures[], size_t count, bool valid[]) {
+  int ret = 0;
+#if defined(CRYPTO_USE_ED25519_DONNA)
+  // signatures are checked together with a random linear combination, a failing batch is checked one by one
+  int *res = malloc(count * sizeof(int));
+  if (res == NULL) {
+    return -1;
+  }
+  ret = ed25519_sign_open_batch(msgs, msg_lens, pub_keys, signatures, count, res) == 0 ? 0 : -1;
+  for (size_t i = 0; valid && i < count; i++) {
+    valid[i] = res[i] == 1;
+  }
+  free(res);
+#else
+  for (size_t i = 0; i < count; i++) {
+    bool ok = iota_crypto_verify(pub_keys[i], msgs[i], msg_lens[i], signatures[i]) == 0;
+    if (valid) {
+      valid[i] = ok;
+    }
+    if (!ok) {
+      ret = -1;
+      if (!valid) {
+        break;
+      }
+    }
+  }
+#endif
+  return ret;
+}
+#endif /* CRYPTO_HAS_ED25519_VERIFY */
+
 int iota_crypto_hmacsha256(uint8_t const secret_key[], uint8_t msg[], size_t msg_len, uint8_t auth[]) {
 #if defined(CRYPTO_USE_SODIUM)
   return crypto_auth_hmacsha256(auth, msg, msg_len, secret_key);
@@ -240,7 +396,27 @@ int iota_crypto_hmacsha512(uint8_t const secret_key[], uint8_t msg[], size_t msg
 #endif
 }
 
+int iota_crypto_init(void) {
+#if defined(CRYPTO_SODIUM_RUNTIME_INIT)
+  if (!crypto_initialized) {
+    // 1 if it was already done by the application
+    if (sodium_init() < 0) {
+      return -1;
+    }
+    crypto_initialized = true;
+  }
+#else
+  // nothing to select on the target, libsodium has SIMD BLAKE2b for x86 only and Cortex-M builds the portable one
+#endif
+  return 0;
+}
+
 int iota_blake2b_sum(uint8_t const msg[], size_t msg_len, uint8_t out[], size_t out_len) {
+#if defined(CRYPTO_SODIUM_RUNTIME_INIT)
+  if (!crypto_initialized && iota_crypto_init() != 0) {
+    return -1;
+  }
+#endif
 #if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
   return crypto_generichash_blake2b(out, out_len, msg, msg_len, NULL, 0);
 #elif defined(CRYPTO_USE_BLAKE2B_REF)
@@ -250,6 +426,237 @@ int iota_blake2b_sum(uint8_t const msg[], size_t msg_len, uint8_t out[], size_t
 #endif
 }
 
+typedef enum { HASH_NONE = 0, HASH_BLAKE2B, HASH_SHA256, HASH_SHA512 } hash_algo_t;
+
+struct iota_hash_state {
+  union {
+#if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
+    crypto_generichash_blake2b_state blake2b;
+#elif defined(CRYPTO_USE_BLAKE2B_REF)
+    blake2b_state blake2b;
+#endif
+#if defined(CRYPTO_USE_SODIUM)
+    crypto_hash_sha256_state sha256;
+    crypto_hash_sha512_state sha512;
+#elif defined(CRYPTO_USE_STLIB)
+    cmox_sha256_handle_t sha256;
+    cmox_sha512_handle_t sha512;
+#elif defined(CRYPTO_USE_MBEDTLS)
+    mbedtls_sha256_context sha256;
+    mbedtls_sha512_context sha512;
+#elif defined(CRYPTO_USE_OPENSSL)
+    EVP_MD_CTX *md;
+#endif
+  } u;
+#if defined(CRYPTO_USE_STLIB)
+  cmox_hash_handle_t *handle;
+#endif
+  void *mem;         // the allocation, the state is aligned for SIMD code
+  hash_algo_t algo;  // the hash in progress
+  size_t out_len;
+};
+
+// the largest alignment a backend state needs
+#define HASH_STATE_ALIGN 64
+
+iota_hash_state_t *iota_hash_state_new(void) {
+  void *mem = malloc(sizeof(iota_hash_state_t) + HASH_STATE_ALIGN - 1);
+  if (mem == NULL) {
+    return NULL;
+  }
+  iota_hash_state_t *state =
+      (iota_hash_state_t *)(((uintptr_t)mem + HASH_STATE_ALIGN - 1) & ~(uintptr_t)(HASH_STATE_ALIGN - 1));
+  memset(state, 0, sizeof(iota_hash_state_t));
+  state->mem = mem;
+  return state;
+}
+
+// release the backend resources of an unfinished hash
+static void hash_state_clear(iota_hash_state_t *state) {
+#if defined(CRYPTO_USE_STLIB)
+  if (state->algo == HASH_SHA256 || state->algo == HASH_SHA512) {
+    cmox_hash_cleanup(state->handle);
+  }
+#elif defined(CRYPTO_USE_MBEDTLS)
+  if (state->algo == HASH_SHA256) {
+    mbedtls_sha256_free(&state->u.sha256);
+  } else if (state->algo == HASH_SHA512) {
+    mbedtls_sha512_free(&state->u.sha512);
+  }
+#elif defined(CRYPTO_USE_OPENSSL)
+  if (state->algo == HASH_SHA256 || state->algo == HASH_SHA512) {
+    EVP_MD_CTX_free(state->u.md);
+  }
+#endif
+  state->algo = HASH_NONE;
+  memset(&state->u, 0, sizeof(state->u));
+}
+
+void iota_hash_state_free(iota_hash_state_t *state) {
+  if (state) {
+    hash_state_clear(state);
+    free(state->mem);
+  }
+}
+
+int iota_blake2b_init(iota_hash_state_t *state, size_t out_len) {
+  if (state == NULL) {
+    return -1;
+  }
+  hash_state_clear(state);
+#if defined(CRYPTO_SODIUM_RUNTIME_INIT)
+  if (!crypto_initialized && iota_crypto_init() != 0) {
+    return -1;
+  }
+#endif
+#if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
+  if (crypto_generichash_blake2b_init(&state->u.blake2b, NULL, 0, out_len) != 0) {
+    return -1;
+  }
+#elif defined(CRYPTO_USE_BLAKE2B_REF)
+  if (blake2b_init(&state->u.blake2b, out_len) != 0) {
+    return -1;
+  }
+#else
+#error blake2b is not defined
+#endif
+  state->algo = HASH_BLAKE2B;
+  state->out_len = out_len;
+  return 0;
+}
+
+int iota_blake2b_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len) {
+  if (state == NULL || state->algo != HASH_BLAKE2B) {
+    return -1;
+  }
+#if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
+  return crypto_generichash_blake2b_update(&state->u.blake2b, msg, msg_len);
+#elif defined(CRYPTO_USE_BLAKE2B_REF)
+  return blake2b_update(&state->u.blake2b, msg, msg_len);
+#endif
+}
+
+int iota_blake2b_final(iota_hash_state_t *state, uint8_t out[], size_t out_len) {
+  int ret = -1;
+  if (state == NULL || state->algo != HASH_BLAKE2B || out_len != state->out_len) {
+    return -1;
+  }
+#if defined(CRYPTO_USE_SODIUM) || defined(CRYPTO_USE_STLIB)
+  ret = crypto_generichash_blake2b_final(&state->u.blake2b, out, out_len);
+#elif defined(CRYPTO_USE_BLAKE2B_REF)
+  ret = blake2b_final(&state->u.blake2b, out, out_len);
+#endif
+  hash_state_clear(state);
+  return ret;
+}
+
+// SHA-256 and SHA-512 share the same steps, with different backend states
+static int sha2_init(iota_hash_state_t *state, hash_algo_t algo) {
+  if (state == NULL) {
+    return -1;
+  }
+  hash_state_clear(state);
+#if defined(CRYPTO_USE_SODIUM)
+  if ((algo == HASH_SHA256 ? crypto_hash_sha256_init(&state->u.sha256) : crypto_hash_sha512_init(&state->u.sha512)) !=
+      0) {
+    return -1;
+  }
+#elif defined(CRYPTO_USE_STLIB)
+  state->handle = (algo == HASH_SHA256) ? cmox_sha256_construct(&state->u.sha256)
+                                        : cmox_sha512_construct(&state->u.sha512);
+  if (state->handle == NULL) {
+    return -1;
+  }
+  if (cmox_hash_init(state->handle) != CMOX_HASH_SUCCESS ||
+      cmox_hash_setTagLen(state->handle, algo == HASH_SHA256 ? CMOX_SHA256_SIZE : CMOX_SHA512_SIZE) !=
+          CMOX_HASH_SUCCESS) {
+    cmox_hash_cleanup(state->handle);
+    return -1;
+  }
+#elif defined(CRYPTO_USE_MBEDTLS)
+  if (algo == HASH_SHA256) {
+    mbedtls_sha256_init(&state->u.sha256);
+    if (mbedtls_sha256_starts_ret(&state->u.sha256, 0) != 0) {
+      mbedtls_sha256_free(&state->u.sha256);
+      return -1;
+    }
+  } else {
+    mbedtls_sha512_init(&state->u.sha512);
+    if (mbedtls_sha512_starts_ret(&state->u.sha512, 0) != 0) {
+      mbedtls_sha512_free(&state->u.sha512);
+      return -1;
+    }
+  }
+#elif defined(CRYPTO_USE_OPENSSL)
+  if ((state->u.md = EVP_MD_CTX_new()) == NULL) {
+    return -1;
+  }
+  if (1 != EVP_DigestInit_ex(state->u.md, algo == HASH_SHA256 ? EVP_sha256() : EVP_sha512(), NULL)) {
+    EVP_MD_CTX_free(state->u.md);
+    return -1;
+  }
+#else
+#error crypto lib is not defined
+#endif
+  state->algo = algo;
+  state->out_len = (algo == HASH_SHA256) ? CRYPTO_SHA256_HASH_BYTES : CRYPTO_SHA512_HASH_BYTES;
+  return 0;
+}
+
+static int sha2_update(iota_hash_state_t *state, hash_algo_t algo, uint8_t const msg[], size_t msg_len) {
+  if (state == NULL || state->algo != algo) {
+    return -1;
+  }
+#if defined(CRYPTO_USE_SODIUM)
+  return (algo == HASH_SHA256) ? crypto_hash_sha256_update(&state->u.sha256, msg, msg_len)
+                               : crypto_hash_sha512_update(&state->u.sha512, msg, msg_len);
+#elif defined(CRYPTO_USE_STLIB)
+  return cmox_hash_append(state->handle, msg, msg_len) == CMOX_HASH_SUCCESS ? 0 : -1;
+#elif defined(CRYPTO_USE_MBEDTLS)
+  return (algo == HASH_SHA256) ? mbedtls_sha256_update_ret(&state->u.sha256, msg, msg_len)
+                               : mbedtls_sha512_update_ret(&state->u.sha512, msg, msg_len);
+#elif defined(CRYPTO_USE_OPENSSL)
+  return 1 == EVP_DigestUpdate(state->u.md, (void const *)msg, msg_len) ? 0 : -1;
+#endif
+}
+
+static int sha2_final(iota_hash_state_t *state, hash_algo_t algo, uint8_t hash[]) {
+  int ret = -1;
+  if (state == NULL || state->algo != algo) {
+    return -1;
+  }
+#if defined(CRYPTO_USE_SODIUM)
+  ret = (algo == HASH_SHA256) ? crypto_hash_sha256_final(&state->u.sha256, hash)
+                              : crypto_hash_sha512_final(&state->u.sha512, hash);
+#elif defined(CRYPTO_USE_STLIB)
+  ret = cmox_hash_generateTag(state->handle, hash, NULL) == CMOX_HASH_SUCCESS ? 0 : -1;
+#elif defined(CRYPTO_USE_MBEDTLS)
+  ret = (algo == HASH_SHA256) ? mbedtls_sha256_finish_ret(&state->u.sha256, hash)
+                              : mbedtls_sha512_finish_ret(&state->u.sha512, hash);
+#elif defined(CRYPTO_USE_OPENSSL)
+  unsigned int hash_len = (unsigned int)state->out_len;
+  ret = 1 == EVP_DigestFinal_ex(state->u.md, hash, &hash_len) ? 0 : -1;
+#endif
+  hash_state_clear(state);
+  return ret;
+}
+
+int iota_sha256_init(iota_hash_state_t *state) { return sha2_init(state, HASH_SHA256); }
+
+int iota_sha256_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len) {
+  return sha2_update(state, HASH_SHA256, msg, msg_len);
+}
+
+int iota_sha256_final(iota_hash_state_t *state, uint8_t hash[]) { return sha2_final(state, HASH_SHA256, hash); }
+
+int iota_sha512_init(iota_hash_state_t *state) { return sha2_init(state, HASH_SHA512); }
+
+int iota_sha512_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len) {
+  return sha2_update(state, HASH_SHA512, msg, msg_len);
+}
+
+int iota_sha512_final(iota_hash_state_t *state, uint8_t hash[]) { return sha2_final(state, HASH_SHA512, hash); }
+
 int iota_crypto_sha256(uint8_t const msg[], size_t msg_len, uint8_t hash[]) {
 #if defined(CRYPTO_USE_SODIUM)
   return crypto_hash_sha256(hash, msg, msg_len);
@@ -326,17 +733,88 @@ int iota_crypto_sha512(uint8_t const msg[], size_t msg_len, uint8_t hash[]) {
 #endif
 }
 
+#if defined(CRYPTO_USE_MBEDTLS)
+// SHA-512 states with the HMAC inner and outer pads of a key absorbed
+static int hmac_sha512_pads(mbedtls_sha512_context *ictx, mbedtls_sha512_context *octx, uint8_t const key[],
+                            size_t key_len) {
+  int ret = 0;
+  uint8_t pad[128];
+  uint8_t key_hash[CRYPTO_SHA512_HASH_BYTES];
+
+  // keys longer than a block are hashed first
+  if (key_len > sizeof(pad)) {
+    if ((ret = mbedtls_sha512_ret(key, key_len, key_hash, 0)) != 0) {
+      return ret;
+    }
+    key = key_hash;
+    key_len = sizeof(key_hash);
+  }
+
+  memset(pad, 0x36, sizeof(pad));
+  for (size_t i = 0; i < key_len; i++) {
+    pad[i] ^= key[i];
+  }
+  if ((ret = mbedtls_sha512_starts_ret(ictx, 0)) == 0) {
+    ret = mbedtls_sha512_update_ret(ictx, pad, sizeof(pad));
+  }
+
+  memset(pad, 0x5C, sizeof(pad));
+  for (size_t i = 0; i < key_len; i++) {
+    pad[i] ^= key[i];
+  }
+  if (ret == 0 && (ret = mbedtls_sha512_starts_ret(octx, 0)) == 0) {
+    ret = mbedtls_sha512_update_ret(octx, pad, sizeof(pad));
+  }
+
+  mbedtls_platform_zeroize(pad, sizeof(pad));
+  mbedtls_platform_zeroize(key_hash, sizeof(key_hash));
+  return ret;
+}
+
+// HMAC-SHA-512 of msg1 || msg2 from the padded states, out can alias msg1
+static int hmac_sha512_padded(mbedtls_sha512_context const *ictx, mbedtls_sha512_context const *octx,
+                              uint8_t const msg1[], size_t msg1_len, uint8_t const msg2[], size_t msg2_len,
+                              uint8_t out[]) {
+  int ret = 0;
+  uint8_t inner[CRYPTO_SHA512_HASH_BYTES];
+  mbedtls_sha512_context ctx;
+
+  mbedtls_sha512_init(&ctx);
+  mbedtls_sha512_clone(&ctx, ictx);
+  ret = mbedtls_sha512_update_ret(&ctx, msg1, msg1_len);
+  if (ret == 0 && msg2_len) {
+    ret = mbedtls_sha512_update_ret(&ctx, msg2, msg2_len);
+  }
+  if (ret == 0) {
+    ret = mbedtls_sha512_finish_ret(&ctx, inner);
+  }
+
+  if (ret == 0) {
+    mbedtls_sha512_clone(&ctx, octx);
+    if ((ret = mbedtls_sha512_update_ret(&ctx, inner, sizeof(inner))) == 0) {
+      ret = mbedtls_sha512_finish_ret(&ctx, out);
+    }
+  }
+
+  mbedtls_sha512_free(&ctx);
+  mbedtls_platform_zeroize(inner, sizeof(inner));
+  return ret;
+}
+#endif
+
 int iota_crypto_pbkdf2_hmac_sha512(char const pwd[], size_t pwd_len, char const salt[], size_t salt_len,
                                    int32_t iterations, uint8_t dk[], size_t dk_len) {
 #if defined(CRYPTO_USE_SODIUM)
-  crypto_auth_hmacsha512_state PShctx, hctx;
+  crypto_auth_hmacsha512_state key_ctx, PShctx, hctx;
   size_t i, j, k;
   uint8_t ivec[4];
   uint8_t U[crypto_auth_hmacsha512_BYTES];
   uint8_t T[crypto_auth_hmacsha512_BYTES];
   size_t clen;
 
-  crypto_auth_hmacsha512_init(&PShctx, (uint8_t const *)pwd, pwd_len);
+  // the inner and outer pads of the password are absorbed once, each iteration starts from a copy
+  crypto_auth_hmacsha512_init(&key_ctx, (uint8_t const *)pwd, pwd_len);
+  memcpy(&PShctx, &key_ctx, sizeof(crypto_auth_hmacsha512_state));
   crypto_auth_hmacsha512_update(&PShctx, (uint8_t const *)salt, salt_len);
 
   // DK = T1 + T2 + ... + T(dklen/hlen)
@@ -348,7 +826,7 @@ int iota_crypto_pbkdf2_hmac_sha512(char const pwd[], size_t pwd_len, char const
     memcpy(T, U, crypto_auth_hmacsha512_BYTES);
 
     for (j = 2; j <= iterations; j++) {
-      crypto_auth_hmacsha512_init(&hctx, (uint8_t const *)pwd, pwd_len);
+      memcpy(&hctx, &key_ctx, sizeof(crypto_auth_hmacsha512_state));
       crypto_auth_hmacsha512_update(&hctx, U, crypto_auth_hmacsha512_BYTES);
       crypto_auth_hmacsha512_final(&hctx, U);
 
@@ -365,23 +843,53 @@ int iota_crypto_pbkdf2_hmac_sha512(char const pwd[], size_t pwd_len, char const
     memcpy(&dk[i * crypto_auth_hmacsha512_BYTES], T, clen);
   }
 
+  sodium_memzero((void *)&key_ctx, sizeof key_ctx);
   sodium_memzero((void *)&PShctx, sizeof PShctx);
+  sodium_memzero((void *)&hctx, sizeof hctx);
+  sodium_memzero(U, sizeof U);
+  sodium_memzero(T, sizeof T);
   return 0;
 #elif defined(CRYPTO_USE_STLIB)
   // TODO
   return -1;
 #elif defined(CRYPTO_USE_MBEDTLS)
-  int ret = -1;
-  mbedtls_md_context_t ctx;
-  const mbedtls_md_info_t *md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA512);
+  // mbedtls_pkcs5_pbkdf2_hmac() absorbs the pads again in each HMAC, they are absorbed once here
+  int ret = 0;
+  mbedtls_sha512_context ictx, octx;
+  uint8_t ivec[4];
+  uint8_t U[CRYPTO_SHA512_HASH_BYTES];
+  uint8_t T[CRYPTO_SHA512_HASH_BYTES];
+
+  mbedtls_sha512_init(&ictx);
+  mbedtls_sha512_init(&octx);
+  ret = hmac_sha512_pads(&ictx, &octx, (uint8_t const *)pwd, pwd_len);
+
+  for (size_t i = 0; ret == 0 && i * CRYPTO_SHA512_HASH_BYTES < dk_len; i++) {
+    ivec[0] = (uint8_t)((i + 1) >> 24);
+    ivec[1] = (uint8_t)((i + 1) >> 16);
+    ivec[2] = (uint8_t)((i + 1) >> 8);
+    ivec[3] = (uint8_t)(i + 1);
+    ret = hmac_sha512_padded(&ictx, &octx, (uint8_t const *)salt, salt_len, ivec, sizeof(ivec), U);
+    memcpy(T, U, sizeof(T));
+
+    for (int32_t j = 2; ret == 0 && j <= iterations; j++) {
+      ret = hmac_sha512_padded(&ictx, &octx, U, sizeof(U), NULL, 0, U);
+      for (size_t k = 0; k < sizeof(T); k++) {
+        T[k] ^= U[k];
+      }
+    }
 
-  mbedtls_md_init(&ctx);
-  ret = mbedtls_md_setup(&ctx, md_info, 1);
-  if (ret == 0) {
-    ret = mbedtls_pkcs5_pbkdf2_hmac(&ctx, (unsigned char const *)pwd, pwd_len, (unsigned char const *)salt, salt_len,
-                                    iterations, dk_len, dk);
+    size_t clen = dk_len - i * CRYPTO_SHA512_HASH_BYTES;
+    if (clen > CRYPTO_SHA512_HASH_BYTES) {
+      clen = CRYPTO_SHA512_HASH_BYTES;
+    }
+    memcpy(&dk[i * CRYPTO_SHA512_HASH_BYTES], T, clen);
   }
-  mbedtls_md_free(&ctx);
+
+  mbedtls_sha512_free(&ictx);
+  mbedtls_sha512_free(&octx);
+  mbedtls_platform_zeroize(U, sizeof(U));
+  mbedtls_platform_zeroize(T, sizeof(T));
   return ret;
 #elif defined(CRYPTO_USE_OPENSSL)
   PKCS5_PBKDF2_HMAC(pwd, pwd_len, (unsigned char const *)salt, salt_len, iterations, EVP_sha512(), dk_len, dk);
@@ -31,6 +31,24 @@
 #define CRYPTO_SHA256_HASH_BYTES 32   // crypto_auth_hmacsha256_BYTES
 #define CRYPTO_BLAKE2B_HASH_BYTES 32  // crypto_generichash_blake2b_BYTES
 
+// Ed25519 verification, the cryptolib build in use provides EdDSA key generation and signing only
+#if !defined(CRYPTO_USE_STLIB)
+#define CRYPTO_HAS_ED25519_VERIFY
+#endif
+
+// random requests served by the generator before fresh entropy is mixed in
+#ifndef CRYPTO_RNG_RESEED_INTERVAL
+#define CRYPTO_RNG_RESEED_INTERVAL 1024
+#endif
+
+// the generator state is shared, an RTOS port maps these to a mutex
+#ifndef CRYPTO_RNG_LOCK
+#define CRYPTO_RNG_LOCK()
+#endif
+#ifndef CRYPTO_RNG_UNLOCK
+#define CRYPTO_RNG_UNLOCK()
+#endif
+
 /**
  * @}
  */
@@ -48,6 +66,12 @@ typedef struct {
   uint8_t priv[ED_PRIVATE_KEY_BYTES];  ///< 64 bytes private key
 } iota_keypair_t;
 
+/**
+ * @brief The state of an incremental hash, the backend state is private
+ *
+ */
+typedef struct iota_hash_state iota_hash_state_t;
+
 /**
  * @}
  */
@@ -60,14 +84,34 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief select the fastest implementations for the running CPU
+ *
+ * With libsodium on a hosted OS it runs the CPU feature detection, BLAKE2b then uses the SSE4.1 or AVX2 compression.
+ * It is called on the first hash, an application can call it at startup. It does nothing on bare-metal targets on
+ * purpose: libsodium only has x86 SIMD variants, the portable BLAKE2b is the only one for Cortex-M.
+ *
+ * @return int 0 on success
+ */
+int iota_crypto_init(void);
+
 /**
  * @brief fill-in random bytes into the given byte buffer.
  *
+ * A generator is seeded from the entropy source on first use and shared by all callers, it is reseeded every
+ * CRYPTO_RNG_RESEED_INTERVAL requests.
+ *
  * @param[out] buf A buffer holds random bytes
  * @param[in] len The length of byte buffer
  */
 void iota_crypto_randombytes(uint8_t *const buf, const size_t len);
 
+/**
+ * @brief mix fresh entropy into the generator before the next request
+ *
+ */
+void iota_crypto_rng_reseed(void);
+
 /**
  * @brief derives key pair from a given seed(IOTA_SEED_BYTES)
  *
@@ -87,6 +131,36 @@ void iota_crypto_keypair(uint8_t const seed[], iota_keypair_t *keypair);
  */
 int iota_crypto_sign(uint8_t const priv_key[], uint8_t msg[], size_t msg_len, uint8_t signature[]);
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+/**
+ * @brief verifies a signature of a message
+ *
+ * @param[in] pub_key The public key
+ * @param[in] msg A byte buffer holds the message data
+ * @param[in] msg_len The length of the message
+ * @param[in] signature The signature
+ * @return int 0 if the signature is valid
+ */
+int iota_crypto_verify(uint8_t const pub_key[], uint8_t const msg[], size_t msg_len, uint8_t const signature[]);
+
+/**
+ * @brief verifies a set of signatures
+ *
+ * With ed25519-donna the signatures are checked together by a randomized linear combination, at a fraction of the
+ * cost of single checks. Other backends check them one by one. Not available with CRYPTO_USE_STLIB.
+ *
+ * @param[in] pub_keys The public keys
+ * @param[in] msgs The messages
+ * @param[in] msg_lens The lengths of the messages
+ * @param[in] signatures The signatures
+ * @param[in] count The number of signatures
+ * @param[out] valid The result of each signature, can be NULL
+ * @return int 0 if all signatures are valid
+ */
+int iota_crypto_verify_batch(uint8_t const *pub_keys[], uint8_t const *msgs[], size_t msg_lens[],
+                             uint8_t const *signatures[], size_t count, bool valid[]);
+#endif
+
 /**
  * @brief HMAC-SHA-256 interface
  *
@@ -140,6 +214,105 @@ int iota_crypto_sha256(uint8_t const msg[], size_t msg_len, uint8_t hash[]);
  */
 int iota_crypto_sha512(uint8_t const msg[], size_t msg_len, uint8_t hash[]);
 
+/**
+ * @brief Allocate a state for incremental hashing
+ *
+ * A state can be reused for any number of hashes, of any algorithm.
+ *
+ * @return iota_hash_state_t* NULL on failure
+ */
+iota_hash_state_t *iota_hash_state_new(void);
+
+/**
+ * @brief Free a hash state
+ *
+ * @param[in] state A hash state
+ */
+void iota_hash_state_free(iota_hash_state_t *state);
+
+/**
+ * @brief Start a Blake2b hash
+ *
+ * @param[in] state A hash state
+ * @param[in] out_len The length of the output hash
+ * @return int 0 on success
+ */
+int iota_blake2b_init(iota_hash_state_t *state, size_t out_len);
+
+/**
+ * @brief Add data to a Blake2b hash
+ *
+ * @param[in] state A hash state started with iota_blake2b_init()
+ * @param[in] msg The data
+ * @param[in] msg_len The length of data
+ * @return int 0 on success
+ */
+int iota_blake2b_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len);
+
+/**
+ * @brief Complete a Blake2b hash
+ *
+ * @param[in] state A hash state started with iota_blake2b_init()
+ * @param[out] out An output hash
+ * @param[in] out_len The length of output hash, as given to iota_blake2b_init()
+ * @return int 0 on success
+ */
+int iota_blake2b_final(iota_hash_state_t *state, uint8_t out[], size_t out_len);
+
+/**
+ * @brief Start a SHA-256 hash
+ *
+ * @param[in] state A hash state
+ * @return int 0 on success
+ */
+int iota_sha256_init(iota_hash_state_t *state);
+
+/**
+ * @brief Add data to a SHA-256 hash
+ *
+ * @param[in] state A hash state started with iota_sha256_init()
+ * @param[in] msg The data
+ * @param[in] msg_len The length of data
+ * @return int 0 on success
+ */
+int iota_sha256_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len);
+
+/**
+ * @brief Complete a SHA-256 hash
+ *
+ * @param[in] state A hash state started with iota_sha256_init()
+ * @param[out] hash the output hash
+ * @return int 0 on success
+ */
+int iota_sha256_final(iota_hash_state_t *state, uint8_t hash[]);
+
+/**
+ * @brief Start a SHA-512 hash
+ *
+ * @param[in] state A hash state
+ * @return int 0 on success
+ */
+int iota_sha512_init(iota_hash_state_t *state);
+
+/**
+ * @brief Add data to a SHA-512 hash
+ *
+ * @param[in] state A hash state started with iota_sha512_init()
+ * @param[in] msg The data
+ * @param[in] msg_len The length of data
+ * @return int 0 on success
+ */
+int iota_sha512_update(iota_hash_state_t *state, uint8_t const msg[], size_t msg_len);
+
+/**
+ * @brief Complete a SHA-512 hash
+ *
+ * @param[in] state A hash state started with iota_sha512_init()
+ * @param[out] hash the output hash
+ * @return int 0 on success
+ */
+int iota_sha512_final(iota_hash_state_t *state, uint8_t hash[]);
+
 /**
  * @brief PBKDF2 HMAC SHA512
  *
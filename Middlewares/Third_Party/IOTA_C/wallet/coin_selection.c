@@ -0,0 +1,182 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wallet/coin_selection.h"
+
+// the selection covers the target without a change below the minimum, which the node would reject as dust
+static bool change_is_valid(uint64_t total, uint64_t target, uint64_t min_change) {
+  return total >= target && (total == target || total - target >= min_change);
+}
+
+// indices of the amounts, largest first
+static void sort_by_amount(uint64_t const amounts[], size_t order[], size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    order[i] = i;
+  }
+  // insertion sort, the outputs of a wallet are a few hundreds at most
+  for (size_t i = 1; i < count; i++) {
+    size_t idx = order[i];
+    size_t j = i;
+    while (j > 0 && amounts[order[j - 1]] < amounts[idx]) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = idx;
+  }
+}
+
+// the first outputs of the sorted order until the target is covered, the fewest inputs possible
+static size_t largest_first(uint64_t const amounts[], size_t const order[], size_t count, uint64_t target,
+                            uint64_t min_change, size_t max_inputs, uint64_t* total) {
+  size_t n = 0;
+  *total = 0;
+  while (n < count && n < max_inputs && !change_is_valid(*total, target, min_change)) {
+    *total += amounts[order[n]];
+    n++;
+  }
+  return n;
+}
+
+// keeps the number of inputs of largest_first and swaps inputs for smaller outputs to reduce the change
+static void reduce_change(uint64_t const amounts[], size_t order[], size_t count, size_t n, uint64_t target,
+                          uint64_t min_change, uint64_t* total) {
+  for (size_t i = n; i-- > 0;) {
+    size_t best = count;
+    for (size_t j = n; j < count; j++) {
+      uint64_t replaced = *total - amounts[order[i]] + amounts[order[j]];
+      if (amounts[order[j]] < amounts[order[i]] && change_is_valid(replaced, target, min_change) &&
+          (best == count || amounts[order[j]] < amounts[order[best]])) {
+        best = j;
+      }
+    }
+    if (best != count) {
+      *total = *total - amounts[order[i]] + amounts[order[best]];
+      size_t tmp = order[i];
+      order[i] = order[best];
+      order[best] = tmp;
+    }
+  }
+}
+
+// depth-first search of a subset summing exactly to the target, the selected outputs are moved to the front of order
+static int branch_and_bound(uint64_t const amounts[], size_t order[], size_t count, uint64_t target,
+                            size_t max_inputs, size_t* selected_count) {
+  int ret = -1;
+  uint64_t curr = 0;
+  size_t depth = 0, n = 0;
+
+  if (count == 0) {
+    return -1;
+  }
+
+  bool* included = calloc(count, sizeof(bool));
+  // remaining[i] is the sum of the outputs from i in the sorted order
+  uint64_t* remaining = malloc((count + 1) * sizeof(uint64_t));
+  if (included == NULL || remaining == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    free(included);
+    free(remaining);
+    return -1;
+  }
+
+  remaining[count] = 0;
+  for (size_t i = count; i-- > 0;) {
+    remaining[i] = remaining[i + 1] + amounts[order[i]];
+  }
+
+  for (uint32_t tries = 0; tries < COIN_SELECT_BNB_MAX_TRIES; tries++) {
+    if (curr == target) {
+      ret = 0;
+      break;
+    }
+
+    if (curr < target && depth < count && n < max_inputs && curr + remaining[depth] >= target) {
+      // include the next output
+      included[depth] = true;
+      curr += amounts[order[depth]];
+      n++;
+      depth++;
+      continue;
+    }
+
+    // backtrack to the last included output and exclude it
+    while (depth > 0 && !included[depth - 1]) {
+      depth--;
+    }
+    if (depth == 0) {
+      // the whole tree is explored
+      break;
+    }
+    depth--;
+    included[depth] = false;
+    curr -= amounts[order[depth]];
+    n--;
+    depth++;
+  }
+
+  if (ret == 0) {
+    size_t front = 0;
+    for (size_t i = 0; i < depth; i++) {
+      if (included[i]) {
+        size_t tmp = order[front];
+        order[front] = order[i];
+        order[i] = tmp;
+        front++;
+      }
+    }
+    *selected_count = n;
+  }
+
+  free(included);
+  free(remaining);
+  return ret;
+}
+
+int coin_select(uint64_t const amounts[], size_t count, uint64_t target, uint64_t min_change,
+                coin_select_strategy_t strategy, size_t max_inputs, size_t selected[], size_t* selected_count,
+                uint64_t* total) {
+  int ret = -1;
+  size_t n = 0;
+  uint64_t sum = 0;
+
+  if (amounts == NULL || selected == NULL || selected_count == NULL || total == NULL || target == 0 ||
+      max_inputs == 0) {
+    printf("[%s:%d] invalid parameter\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // at least one element, malloc(0) may return NULL
+  size_t* order = malloc((count ? count : 1) * sizeof(size_t));
+  if (order == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return -1;
+  }
+  sort_by_amount(amounts, order, count);
+
+  if (strategy == COIN_SELECT_BRANCH_AND_BOUND &&
+      branch_and_bound(amounts, order, count, target, max_inputs, &n) == 0) {
+    sum = target;
+    ret = 0;
+  } else {
+    n = largest_first(amounts, order, count, target, min_change, max_inputs, &sum);
+    if (change_is_valid(sum, target, min_change)) {
+      if (strategy != COIN_SELECT_LARGEST_FIRST) {
+        reduce_change(amounts, order, count, n, target, min_change, &sum);
+      }
+      ret = 0;
+    }
+  }
+
+  if (ret == 0) {
+    memcpy(selected, order, n * sizeof(size_t));
+    *selected_count = n;
+    *total = sum;
+  }
+  free(order);
+  return ret;
+}
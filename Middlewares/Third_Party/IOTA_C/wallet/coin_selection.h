@@ -0,0 +1,106 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __WALLET_COIN_SELECTION_H__
+#define __WALLET_COIN_SELECTION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @addtogroup IOTA_C
+ * @{
+ */
+
+/** @addtogroup WALLET
+ * @{
+ */
+
+/** @defgroup COIN_SELECTION Coin Selection
+ * @{
+ */
+
+/** @defgroup COIN_SELECTION_EXPORTED_CONSTANTS Exported Constants
+ * @{
+ */
+
+// The number of search steps of the branch and bound strategy before it falls back to COIN_SELECT_MIN_INPUTS
+#ifndef COIN_SELECT_BNB_MAX_TRIES
+#define COIN_SELECT_BNB_MAX_TRIES 100000
+#endif
+
+// The smallest change output accepted by the node without a dust allowance on its address, in iotas
+#ifndef COIN_SELECT_MIN_CHANGE
+#define COIN_SELECT_MIN_CHANGE 1000000
+#endif
+
+/**
+ * @}
+ */
+
+/** @defgroup COIN_SELECTION_EXPORTED_TYPES Exported Types
+ * @{
+ */
+
+/**
+ * @brief Coin selection strategies
+ *
+ */
+typedef enum {
+  COIN_SELECT_BRANCH_AND_BOUND = 0,  ///< An exact match without change output, COIN_SELECT_MIN_INPUTS if none is found
+  COIN_SELECT_LARGEST_FIRST,         ///< The largest outputs until the target is reached
+  COIN_SELECT_MIN_INPUTS,            ///< The fewest inputs, swapped for smaller outputs to reduce the change
+} coin_select_strategy_t;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup COIN_SELECTION_EXPORTED_FUNCTIONS Exported Functions
+ * @{
+ */
+
+/**
+ * @brief Select outputs covering a target amount
+ *
+ * The change, the selected amount above the target, is either 0 or min_change at least.
+ *
+ * @param[in] amounts The amounts of the available outputs
+ * @param[in] count The number of available outputs
+ * @param[in] target The amount to cover
+ * @param[in] min_change The smallest change allowed, e.g. COIN_SELECT_MIN_CHANGE
+ * @param[in] strategy The selection strategy
+ * @param[in] max_inputs The maximum number of selected outputs
+ * @param[out] selected A buffer of count indices into amounts, the selected outputs
+ * @param[out] selected_count The number of selected outputs
+ * @param[out] total The sum of the selected amounts
+ * @return int 0 on success, -1 if the outputs cannot cover the target without a dust change
+ */
+int coin_select(uint64_t const amounts[], size_t count, uint64_t target, uint64_t min_change,
+                coin_select_strategy_t strategy, size_t max_inputs, size_t selected[], size_t* selected_count,
+                uint64_t* total);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#include <stdio.h>
+#include <string.h>
+
+#include "wallet/utxo_cache.h"
+
+utxo_cache_ht *utxo_cache_new(void) { return NULL; }
+
+void utxo_cache_output_id(byte_t const tx_id[], uint16_t index, byte_t output_id[]) {
+  memcpy(output_id, tx_id, TRANSACTION_ID_BYTES);
+  output_id[TRANSACTION_ID_BYTES] = (byte_t)(index & 0xFF);
+  output_id[TRANSACTION_ID_BYTES + 1] = (byte_t)(index >> 8);
+}
+
+utxo_cache_ht *utxo_cache_find(utxo_cache_ht **cache, byte_t const output_id[]) {
+  utxo_cache_ht *elm = NULL;
+  HASH_FIND(hh, *cache, output_id, UTXO_OUTPUT_ID_BYTES, elm);
+  return elm;
+}
+
+utxo_cache_ht *utxo_cache_add(utxo_cache_ht **cache, byte_t const output_id[], uint64_t amount, bool change,
+                              uint32_t addr_index) {
+  if (utxo_cache_find(cache, output_id)) {
+    printf("[%s:%d] output ID exists\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  utxo_cache_ht *elm = malloc(sizeof(utxo_cache_ht));
+  if (elm == NULL) {
+    printf("[%s:%d] OOM\n", __func__, __LINE__);
+    return NULL;
+  }
+  memcpy(elm->output_id, output_id, UTXO_OUTPUT_ID_BYTES);
+  elm->output_index = (uint16_t)(output_id[TRANSACTION_ID_BYTES] | (output_id[TRANSACTION_ID_BYTES + 1] << 8));
+  elm->amount = amount;
+  elm->addr_index = addr_index;
+  elm->change = change;
+  elm->is_spent = false;
+  elm->spent_msg_id[0] = '\0';
+  elm->listed = true;
+  HASH_ADD(hh, *cache, output_id, UTXO_OUTPUT_ID_BYTES, elm);
+  return elm;
+}
+
+void utxo_cache_remove(utxo_cache_ht **cache, utxo_cache_ht *elm) {
+  if (elm) {
+    HASH_DEL(*cache, elm);
+    free(elm);
+  }
+}
+
+int utxo_cache_set_spent(utxo_cache_ht **cache, byte_t const tx_id[], uint16_t index, char const msg_id[]) {
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  utxo_cache_output_id(tx_id, index, output_id);
+  utxo_cache_ht *elm = utxo_cache_find(cache, output_id);
+  if (elm == NULL) {
+    return -1;
+  }
+  elm->is_spent = true;
+  strncpy(elm->spent_msg_id, msg_id, IOTA_MESSAGE_ID_HEX_BYTES);
+  elm->spent_msg_id[IOTA_MESSAGE_ID_HEX_BYTES] = '\0';
+  return 0;
+}
+
+int utxo_cache_set_unspent(utxo_cache_ht **cache, byte_t const tx_id[], uint16_t index) {
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  utxo_cache_output_id(tx_id, index, output_id);
+  utxo_cache_ht *elm = utxo_cache_find(cache, output_id);
+  if (elm == NULL) {
+    return -1;
+  }
+  elm->is_spent = false;
+  elm->spent_msg_id[0] = '\0';
+  return 0;
+}
+
+bool utxo_cache_msg_failed(char const inclusion_state[], uint64_t referenced_milestone) {
+  return strcmp(inclusion_state, "conflicting") == 0 ||
+         (referenced_milestone != 0 && strcmp(inclusion_state, "included") != 0);
+}
+
+size_t utxo_cache_clear_spent(utxo_cache_ht **cache, char const msg_id[]) {
+  utxo_cache_ht *elm, *tmp;
+  size_t count = 0;
+  HASH_ITER(hh, *cache, elm, tmp) {
+    if (elm->is_spent && strcmp(elm->spent_msg_id, msg_id) == 0) {
+      elm->is_spent = false;
+      elm->spent_msg_id[0] = '\0';
+      count++;
+    }
+  }
+  return count;
+}
+
+size_t utxo_cache_count(utxo_cache_ht **cache) { return HASH_COUNT(*cache); }
+
+void utxo_cache_free(utxo_cache_ht **cache) {
+  utxo_cache_ht *curr_elm, *tmp;
+  HASH_ITER(hh, *cache, curr_elm, tmp) {
+    HASH_DEL(*cache, curr_elm);
+    free(curr_elm);
+  }
+}
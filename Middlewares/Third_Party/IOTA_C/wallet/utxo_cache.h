@@ -0,0 +1,192 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef __WALLET_UTXO_CACHE_H__
+#define __WALLET_UTXO_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "core/models/inputs/utxo_input.h"
+#include "core/models/models_message.h"
+#include "core/types.h"
+#include "uthash.h"
+
+/** @addtogroup IOTA_C
+ * @{
+ */
+
+/** @addtogroup WALLET
+ * @{
+ */
+
+/** @defgroup UTXO_CACHE UTXO Cache
+ * @{
+ */
+
+/** @defgroup UTXO_CACHE_EXPORTED_CONSTANTS Exported Constants
+ * @{
+ */
+
+// An output ID is the transaction ID followed by the output index in little-endian
+#define UTXO_OUTPUT_ID_BYTES (TRANSACTION_ID_BYTES + sizeof(uint16_t))
+
+/**
+ * @}
+ */
+
+/** @defgroup UTXO_CACHE_EXPORTED_TYPES Exported Types
+ * @{
+ */
+
+/**
+ * @brief An unspent output of the wallet, keyed by its output ID
+ *
+ */
+typedef struct {
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];            ///< The transaction ID and the output index
+  uint16_t output_index;                             ///< The index of the output in its transaction
+  uint64_t amount;                                   ///< The amount of the output
+  uint32_t addr_index;                               ///< The index of the address holding the output
+  bool change;                                       ///< The address is on the change chain
+  bool is_spent;                                     ///< The output is an input of a transaction sent by this wallet
+  char spent_msg_id[IOTA_MESSAGE_ID_HEX_BYTES + 1];  ///< The message spending the output, if is_spent
+  bool listed;                                       ///< Listed by the node at the last refresh of its address
+  UT_hash_handle hh;
+} utxo_cache_ht;
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup UTXO_CACHE_EXPORTED_FUNCTIONS Exported Functions
+ * @{
+ */
+
+/**
+ * @brief Initialize an UTXO cache hash table.
+ *
+ * @return utxo_cache_ht* a NULL pointer
+ */
+utxo_cache_ht *utxo_cache_new(void);
+
+/**
+ * @brief Get the output ID of a transaction output
+ *
+ * @param[in] tx_id A transaction ID
+ * @param[in] index The output index
+ * @param[out] output_id A buffer holds UTXO_OUTPUT_ID_BYTES
+ */
+void utxo_cache_output_id(byte_t const tx_id[], uint16_t index, byte_t output_id[]);
+
+/**
+ * @brief Find an output by a given output ID
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] output_id An output ID
+ * @return utxo_cache_ht* NULL if not found
+ */
+utxo_cache_ht *utxo_cache_find(utxo_cache_ht **cache, byte_t const output_id[]);
+
+/**
+ * @brief Add an unspent output to the cache
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] output_id An output ID
+ * @param[in] amount The amount of the output
+ * @param[in] change The address is on the change chain
+ * @param[in] addr_index The index of the address
+ * @return utxo_cache_ht* The new element, NULL on failure or if the output exists
+ */
+utxo_cache_ht *utxo_cache_add(utxo_cache_ht **cache, byte_t const output_id[], uint64_t amount, bool change,
+                              uint32_t addr_index);
+
+/**
+ * @brief Remove an output from the cache
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] elm An element of the cache
+ */
+void utxo_cache_remove(utxo_cache_ht **cache, utxo_cache_ht *elm);
+
+/**
+ * @brief Mark an output as spent, it is not selected again until the node drops it or the message fails
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] tx_id A transaction ID
+ * @param[in] index The output index
+ * @param[in] msg_id The hex encoded ID of the message spending the output
+ * @return int 0 on success, -1 if the output is not in the cache
+ */
+int utxo_cache_set_spent(utxo_cache_ht **cache, byte_t const tx_id[], uint16_t index, char const msg_id[]);
+
+/**
+ * @brief Make an output available again, e.g. if the message spending it was not sent
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] tx_id A transaction ID
+ * @param[in] index The output index
+ * @return int 0 on success, -1 if the output is not in the cache
+ */
+int utxo_cache_set_unspent(utxo_cache_ht **cache, byte_t const tx_id[], uint16_t index);
+
+/**
+ * @brief Tell whether a message will never spend its inputs from its metadata
+ *
+ * The message is conflicting, or referenced by a milestone without being included.
+ *
+ * @param[in] inclusion_state The ledger inclusion state of the message
+ * @param[in] referenced_milestone The milestone referencing the message, 0 if none
+ * @return true if the outputs spent by the message can be released
+ */
+bool utxo_cache_msg_failed(char const inclusion_state[], uint64_t referenced_milestone);
+
+/**
+ * @brief Make the outputs spent by a message available again, e.g. if the message is conflicting
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @param[in] msg_id The hex encoded ID of the message
+ * @return size_t The number of outputs released
+ */
+size_t utxo_cache_clear_spent(utxo_cache_ht **cache, char const msg_id[]);
+
+/**
+ * @brief Get the number of outputs in the cache
+ *
+ * @param[in] cache An UTXO cache hash table
+ * @return size_t
+ */
+size_t utxo_cache_count(utxo_cache_ht **cache);
+
+/**
+ * @brief Free an UTXO cache hash table.
+ *
+ * @param[in] cache An UTXO cache hash table
+ */
+void utxo_cache_free(utxo_cache_ht **cache);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#endif
@@ -6,12 +6,14 @@
 #include <string.h>
 
 #include "client/api/v1/get_balance.h"
+#include "client/api/v1/get_message_metadata.h"
 #include "client/api/v1/get_node_info.h"
 #include "client/api/v1/get_output.h"
 #include "client/api/v1/get_outputs_from_address.h"
 #include "client/api/v1/send_message.h"
 #include "core/models/models_message.h"
 #include "core/utils/byte_buffer.h"
+#include "wallet/utxo_cache.h"
 #include "wallet/wallet.h"
 
 #include "core/utils/slip10.h"
@@ -19,6 +21,11 @@
 
 // max length of m/44'/4218'/Account'/Change'
 #define IOTA_ACCOUNT_PATH_MAX 128
+// the maximum number of inputs of a transaction
+#define WALLET_MAX_INPUTS UTXO_INPUT_MAX_COUNT
+// the first levels of IOTA BIP44 paths, m/44'/4218'
+#define IOTA_BIP44_PURPOSE 44
+#define IOTA_BIP44_COIN_TYPE 4218
 
 // TODO: move to utils?
 // validate path: m/44',/4218',/Account',/Change'
@@ -79,124 +86,300 @@ int validate_pib44_path(char const path[]) {
   return ret;
 }
 
-/**
- * @brief Get the address path
- *
- * @param[in] account The account index
- * @param[in] change change index which is {0, 1}, also known as wallet chain.
- * @param[in] index Address index
- * @param[in] buf The buffer holds BIP44 path
- * @param[in] buf_len the length of the buffer
- */
-static void get_address_path(uint32_t account, bool change, uint32_t index, char* buf, size_t buf_len) {
-  int ret_size = 0;
-  // IOTA BIP44 Paths: m/44'/4128'/Account'/Change'/Index'
-  // https://github.com/satoshilabs/slips/blob/master/slip-0044.md
-  ret_size = snprintf(buf, buf_len, "m/44'/4218'/%" PRIu32 "'/%d'/%" PRIu32 "'", account, change, index);
-  if (ret_size >= buf_len) {
-    buf[buf_len - 1] = '\0';
-    printf("[%s:%d] path is truncated\n", __func__, __LINE__);
+// the cached m/44'/4218'/Account'/Change' node, derived again if the account index has changed
+static slip10_key_t const* wallet_chain_node(iota_wallet_t* w, bool change) {
+  wallet_chain_node_t* node = &w->chain_nodes[change ? 1 : 0];
+
+  if (!node->valid || node->account != w->account_index) {
+    node->valid = false;
+    if (w->account_index >= BIP32_HARDENED) {
+      printf("[%s:%d] Err: account index is out of range\n", __func__, __LINE__);
+      return NULL;
+    }
+
+    // IOTA BIP44 Paths: m/44'/4218'/Account'/Change'/Index'
+    // https://github.com/satoshilabs/slips/blob/master/slip-0044.md
+    uint32_t const chain_path[] = {IOTA_BIP44_PURPOSE | BIP32_HARDENED, IOTA_BIP44_COIN_TYPE | BIP32_HARDENED,
+                                   w->account_index | BIP32_HARDENED, (change ? 1 : 0) | BIP32_HARDENED};
+    if (slip10_key_from_indices(w->seed, sizeof(w->seed), chain_path, sizeof(chain_path) / sizeof(chain_path[0]),
+                                ED25519_CURVE, &node->key) != 0) {
+      printf("[%s:%d] derive chain key failed\n", __func__, __LINE__);
+      return NULL;
+    }
+    node->account = w->account_index;
+    node->valid = true;
   }
+  return &node->key;
 }
 
-static transaction_payload_t* wallet_build_transaction(iota_wallet_t* w, bool change, uint32_t sender_index,
-                                                       byte_t receiver[], uint64_t balance, char const index[],
-                                                       byte_t data[], size_t data_len) {
-  char tmp_addr[IOTA_ADDRESS_HEX_BYTES + 1];
-  memset(tmp_addr, 0, sizeof(tmp_addr));
-  char addr_path[IOTA_ACCOUNT_PATH_MAX];
-  memset(addr_path, 0, sizeof(addr_path));
-  byte_t send_addr[ED25519_ADDRESS_BYTES];
-  memset(send_addr, 0, sizeof(send_addr));
-  byte_t tmp_tx_id[TRANSACTION_ID_BYTES];
-  memset(tmp_tx_id, 0, sizeof(tmp_tx_id));
-  iota_keypair_t addr_keypair;
-  memset(&addr_keypair, 0, sizeof(iota_keypair_t));
+// the keypair of m/44'/4218'/Account'/Change'/Index', a single child derivation from the chain node
+static int wallet_keypair_from_index(iota_wallet_t* w, bool change, uint32_t index, iota_keypair_t* keypair) {
+  slip10_key_t key;
+  slip10_key_t const* node = NULL;
+
+  if (index >= BIP32_HARDENED) {
+    printf("[%s:%d] Err: address index is out of range\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if ((node = wallet_chain_node(w, change)) == NULL) {
+    return -1;
+  }
+
+  if (slip10_key_derive_child(ED25519_CURVE, node, index | BIP32_HARDENED, &key) != 0) {
+    printf("[%s:%d] derive address key failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // ed25519 keypair from slip10 private key
+  iota_crypto_keypair(key.key, keypair);
+  memset(&key, 0, sizeof(slip10_key_t));
+  return 0;
+}
+
+// a message that will never spend its inputs: unknown to the node, conflicting, or referenced without being included
+static bool wallet_msg_failed(iota_wallet_t* w, char const msg_id[]) {
+  bool failed = false;
+  res_msg_meta_t* meta_res = res_msg_meta_new();
+  if (meta_res == NULL) {
+    printf("[%s:%d] Err: OOM\n", __func__, __LINE__);
+    return false;
+  }
+
+  // a request failure says nothing about the message
+  if (get_message_metadata(&w->endpoint, msg_id, meta_res) == 0) {
+    if (meta_res->is_error) {
+      failed = true;
+    } else if (meta_res->u.meta) {
+      failed = utxo_cache_msg_failed(meta_res->u.meta->inclusion_state, meta_res->u.meta->referenced_milestone);
+    }
+  }
+  res_msg_meta_free(meta_res);
+  return failed;
+}
+
+// fetches the outputs of an address that are not in the UTXO cache, and drops the cached ones the node no longer lists
+static int wallet_refresh_utxos(iota_wallet_t* w, bool change, uint32_t addr_index, byte_t const addr[]) {
+  char hex_addr[IOTA_ADDRESS_HEX_BYTES + 1] = {0};
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
   res_outputs_address_t* outputs_res = NULL;
-  transaction_payload_t* tx_payload = NULL;
-  size_t out_counts;
-  uint64_t total_balance;
-  uint64_t remainder;
+  utxo_cache_ht *elm, *tmp;
   int ret = -1;
 
-  // TODO loop over start and end addresses
-  // get address keypair and address
-  
-  get_address_path(w->account_index, change, sender_index, addr_path, sizeof(addr_path));
+  if (bin_2_hex(addr, ED25519_ADDRESS_BYTES, hex_addr, sizeof(hex_addr))) {
+    printf("[%s:%d] Err: Convert ed25519 address to hex string failed\n", __func__, __LINE__);
+    return -1;
+  }
 
-  if (address_keypair_from_path(w->seed, sizeof(w->seed), addr_path, &addr_keypair) != 0) {
-    printf("[%s:%d] Cannot get address keypair\n", __func__, __LINE__);
-  } else {
-    ret = 0;
+  if ((outputs_res = res_outputs_address_new()) == NULL) {
+    printf("[%s:%d] Err: OOM\n", __func__, __LINE__);
+    return -1;
   }
 
-  if (ret == 0) {
-    if (address_from_ed25519_pub(addr_keypair.pub, send_addr) != 0) {
-      printf("[%s:%d] Cannot get sending address \n", __func__, __LINE__);
-      ret = -1;
+  if (get_outputs_from_address(&w->endpoint, false, hex_addr, outputs_res) != 0) {
+    printf("[%s:%d] Err: get outputs from address failed\n", __func__, __LINE__);
+    goto done;
+  }
+
+  if (outputs_res->is_error) {
+    printf("[%s:%d] Error get outputs from addr: %s\n", __func__, __LINE__, outputs_res->u.error->msg);
+    goto done;
+  }
+
+  HASH_ITER(hh, w->utxos, elm, tmp) {
+    if (elm->change == change && elm->addr_index == addr_index) {
+      elm->listed = false;
     }
   }
 
-  if (ret == 0) {
-    // get outputs
-    bin_2_hex(send_addr, sizeof(send_addr), tmp_addr, sizeof(tmp_addr));
-    outputs_res = res_outputs_address_new();
-    if (!outputs_res) {
-      printf("[%s:%d] Err: invalid length of path\n", __func__, __LINE__);
+  ret = 0;
+  size_t out_counts = res_outputs_address_output_id_count(outputs_res);
+  for (size_t i = 0; i < out_counts && ret == 0; i++) {
+    char* id_str = res_outputs_address_output_id(outputs_res, i);
+    if (hex_2_bin(id_str, UTXO_OUTPUT_ID_BYTES * 2, output_id, sizeof(output_id)) != 0) {
+      printf("[%s:%d] Err: invalid output ID\n", __func__, __LINE__);
       ret = -1;
+      break;
     }
-  }
 
-  if (ret == 0) {
-    if (get_outputs_from_address(&w->endpoint, false, tmp_addr, outputs_res) != 0) {
-      printf("[%s:%d] Err: get outputs from address failed\n", __func__, __LINE__);
+    if ((elm = utxo_cache_find(&w->utxos, output_id)) != NULL) {
+      elm->listed = true;
+      // still unspent on the ledger, the message spending it may have failed
+      if (elm->is_spent && wallet_msg_failed(w, elm->spent_msg_id)) {
+        // the ID is copied, it is cleared in the outputs
+        char spent_msg_id[IOTA_MESSAGE_ID_HEX_BYTES + 1];
+        memcpy(spent_msg_id, elm->spent_msg_id, sizeof(spent_msg_id));
+        utxo_cache_clear_spent(&w->utxos, spent_msg_id);
+      }
+      continue;
+    }
+
+    // only unknown outputs are fetched
+    res_output_t out_res;
+    memset(&out_res, 0, sizeof(res_output_t));
+    if (get_output(&w->endpoint, id_str, &out_res) != 0) {
+      printf("[%s:%d] Err: get output failed\n", __func__, __LINE__);
       ret = -1;
+    } else if (out_res.is_error) {
+      printf("[%s:%d] Error response: %s\n", __func__, __LINE__, out_res.u.error->msg);
+      res_err_free(out_res.u.error);
+      ret = -1;
+    } else if (!out_res.u.output.is_spent) {
+      if (out_res.u.output.address_type == ADDRESS_VER_ED25519) {
+        if (utxo_cache_add(&w->utxos, output_id, out_res.u.output.amount, change, addr_index) == NULL) {
+          ret = -1;
+        }
+      } else {
+        printf("Unknow address type\n");
+      }
     }
   }
 
   if (ret == 0) {
-    if (outputs_res->is_error) {
-      printf("[%s:%d] Error get outputs from addr: %s\n", __func__, __LINE__, outputs_res->u.error->msg);
-      ret = -1;
+    // consumed on the ledger
+    HASH_ITER(hh, w->utxos, elm, tmp) {
+      if (elm->change == change && elm->addr_index == addr_index && !elm->listed) {
+        utxo_cache_remove(&w->utxos, elm);
+      }
+    }
+  }
+
+done:
+  res_outputs_address_free(outputs_res);
+  return ret;
+}
+
+// creates a transaction holding outputs outputs, with the cached outputs picked by the coin selection of the wallet as
+// inputs
+static transaction_payload_t* wallet_select_inputs(iota_wallet_t* w, uint64_t amount, uint16_t outputs,
+                                                   uint64_t* total) {
+  size_t count = 0, selected_count = 0;
+  utxo_cache_ht *elm, *tmp;
+  iota_keypair_t keypair;
+  utxo_cache_ht const* keypair_of = NULL;
+  transaction_payload_t* tx = NULL;
+  int ret = -1;
+
+  *total = 0;
+  size_t cache_count = utxo_cache_count(&w->utxos);
+  if (cache_count == 0) {
+    printf("[%s:%d] Err: input not found\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  utxo_cache_ht** candidates = malloc(cache_count * sizeof(utxo_cache_ht*));
+  uint64_t* amounts = malloc(cache_count * sizeof(uint64_t));
+  size_t* selected = malloc(cache_count * sizeof(size_t));
+  if (candidates == NULL || amounts == NULL || selected == NULL) {
+    printf("[%s:%d] Err: OOM\n", __func__, __LINE__);
+    goto done;
+  }
+
+  HASH_ITER(hh, w->utxos, elm, tmp) {
+    if (!elm->is_spent) {
+      candidates[count] = elm;
+      amounts[count] = elm->amount;
+      count++;
+    }
+  }
+
+  if (coin_select(amounts, count, amount, COIN_SELECT_MIN_CHANGE, w->coin_selection, WALLET_MAX_INPUTS, selected,
+                  &selected_count, total) != 0) {
+    printf("[%s:%d] Err: balance is not sufficient or leaves a dust change, send balance:%" PRIu64 "\n", __func__,
+           __LINE__, amount);
+    goto done;
+  }
+
+  // the essence is allocated for the selected inputs
+  if ((tx = tx_payload_new_with_capacity((uint16_t)selected_count, outputs)) == NULL) {
+    printf("[%s:%d] allocate tx payload failed\n", __func__, __LINE__);
+    goto done;
+  }
+
+  ret = 0;
+  for (size_t i = 0; i < selected_count && ret == 0; i++) {
+    elm = candidates[selected[i]];
+    // inputs of the same address share a keypair
+    if (keypair_of == NULL || keypair_of->change != elm->change || keypair_of->addr_index != elm->addr_index) {
+      if ((ret = wallet_keypair_from_index(w, elm->change, elm->addr_index, &keypair)) != 0) {
+        printf("[%s:%d] Cannot get address keypair\n", __func__, __LINE__);
+        break;
+      }
+      keypair_of = elm;
+    }
+    ret = tx_payload_add_input_with_key(tx, elm->output_id, elm->output_index, keypair.pub, keypair.priv);
+  }
+  memset(&keypair, 0, sizeof(iota_keypair_t));
+
+done:
+  if (ret != 0) {
+    tx_payload_free(tx);
+    tx = NULL;
+  }
+  free(candidates);
+  free(amounts);
+  free(selected);
+  return tx;
+}
+
+// adds a payment to the transaction outputs, payments to the same address are merged since outputs are keyed by address
+static int wallet_add_payment(transaction_payload_t* tx, byte_t const addr[], uint64_t amount) {
+  utxo_output_t* elm = utxo_outputs_find_by_addr(&tx->essence->outputs, OUTPUT_SINGLE_OUTPUT, addr);
+  if (elm == NULL) {
+    return tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, (byte_t*)addr, amount);
+  }
+  if (amount > MAX_IOTA_SUPPLY - elm->amount) {
+    printf("[%s:%d] Err: invalid amount\n", __func__, __LINE__);
+    return -1;
+  }
+  elm->amount += amount;
+  return 0;
+}
+
+// creates a transaction paying payments with the cached outputs, the outputs of the sender must be refreshed
+static transaction_payload_t* wallet_build_transaction(iota_wallet_t* w, bool change, uint32_t sender_index,
+                                                       wallet_payment_t const payments[], size_t count,
+                                                       char const index[], byte_t data[], size_t data_len) {
+  byte_t send_addr[ED25519_ADDRESS_BYTES];
+  memset(send_addr, 0, sizeof(send_addr));
+  iota_keypair_t addr_keypair;
+  memset(&addr_keypair, 0, sizeof(iota_keypair_t));
+  transaction_payload_t* tx_payload = NULL;
+  uint64_t total_balance = 0;
+  uint64_t balance = 0;
+  int ret = -1;
+
+  if (count == 0 || count > WALLET_BATCH_MAX_PAYMENTS) {
+    printf("[%s:%d] Err: invalid payment count\n", __func__, __LINE__);
+    return NULL;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    if (payments[i].amount == 0 || payments[i].amount > MAX_IOTA_SUPPLY - balance) {
+      printf("[%s:%d] Err: invalid amount\n", __func__, __LINE__);
+      return NULL;
     }
+    balance += payments[i].amount;
+  }
+
+  // get address keypair and address
+  if (wallet_keypair_from_index(w, change, sender_index, &addr_keypair) != 0) {
+    printf("[%s:%d] Cannot get address keypair\n", __func__, __LINE__);
+  } else {
+    ret = 0;
   }
 
   if (ret == 0) {
-    if ((tx_payload = tx_payload_new()) == NULL) {
-      printf("[%s:%d] allocate tx payload failed\n", __func__, __LINE__);
+    if (address_from_ed25519_pub(addr_keypair.pub, send_addr) != 0) {
+      printf("[%s:%d] Cannot get sending address \n", __func__, __LINE__);
       ret = -1;
     }
   }
 
   if (ret == 0) {
-    out_counts = res_outputs_address_output_id_count(outputs_res);
-    // get outputs and tx id and tx output index from genesis
-    total_balance = 0;
-    for (size_t i = 0; i < out_counts; i++) {
-      char* output_id = res_outputs_address_output_id(outputs_res, i);
-      res_output_t out_id_res;
-      memset(&out_id_res, 0, sizeof(res_output_t));
-      ret = get_output(&w->endpoint, output_id, &out_id_res);
-      if (out_id_res.is_error) {
-        printf("[%s:%d] Error response: %s\n", __func__, __LINE__, out_id_res.u.error->msg);
-        res_err_free(out_id_res.u.error);
-      }
-      
-      // add input to transaction essence
-      if (!out_id_res.u.output.is_spent) {
-        if (out_id_res.u.output.address_type == ADDRESS_VER_ED25519) {
-          hex_2_bin(out_id_res.u.output.tx_id, TRANSACTION_ID_BYTES * 2, tmp_tx_id, sizeof(tmp_tx_id));
-          ret = tx_payload_add_input_with_key(tx_payload, tmp_tx_id, out_id_res.u.output.output_idx, addr_keypair.pub,
-                                              addr_keypair.priv);
-          total_balance += out_id_res.u.output.amount;
-          if (total_balance >= balance) {
-            // balance is sufficient from current inputs
-            break;
-          }
-        } else {
-          printf("Unknow address type\n");
-        }
-      }
+    // the payments and the remainder
+    if ((tx_payload = wallet_select_inputs(w, balance, (uint16_t)count + 1, &total_balance)) == NULL) {
+      ret = -1;
     }
   }
 
@@ -215,22 +398,23 @@ static transaction_payload_t* wallet_build_transaction(iota_wallet_t* w, bool ch
     }
   }
 
-  if (ret == 0) {
-    remainder = total_balance - balance;
-    if (remainder > 0) {
-      ret = tx_payload_add_output(tx_payload, OUTPUT_SINGLE_OUTPUT, receiver, balance);
-      ret = tx_payload_add_output(tx_payload, OUTPUT_SINGLE_OUTPUT, send_addr, total_balance - balance);
-    } else {
-      ret = tx_payload_add_output(tx_payload, OUTPUT_SINGLE_OUTPUT, receiver, balance);
-    }
+  for (size_t i = 0; i < count && ret == 0; i++) {
+    ret = wallet_add_payment(tx_payload, payments[i].addr, payments[i].amount);
+  }
+
+  if (ret == 0 && total_balance > balance) {
+    // the remainder
+    ret = wallet_add_payment(tx_payload, send_addr, total_balance - balance);
+  }
 
+  if (ret == 0) {
     // with indexation?
     if (index && data && data_len != 0) {
       ret = tx_essence_add_payload(tx_payload->essence, 2, (void*)indexation_create(index, data, data_len));
     }
   }
 
-  res_outputs_address_free(outputs_res);
+  memset(&addr_keypair, 0, sizeof(iota_keypair_t));
 
   if (ret == -1) {
     tx_payload_free(tx_payload);
@@ -240,6 +424,56 @@ static transaction_payload_t* wallet_build_transaction(iota_wallet_t* w, bool ch
   return tx_payload;
 }
 
+// marks the inputs of a transaction spent by a message, reserved with an empty ID, or available again with NULL
+static void wallet_mark_inputs(iota_wallet_t* w, transaction_payload_t const* tx, char const msg_id[]) {
+  for (uint16_t i = 0; i < tx->essence->inputs.count; i++) {
+    utxo_input_t const* in = &tx->essence->inputs.elm[i];
+    if (msg_id) {
+      utxo_cache_set_spent(&w->utxos, in->tx_id, in->output_index, msg_id);
+    } else {
+      utxo_cache_set_unspent(&w->utxos, in->tx_id, in->output_index);
+    }
+  }
+}
+
+// signs and sends a transaction, the message takes the ownership of the payload, the inputs are released on failure
+static int wallet_send_transaction(iota_wallet_t* w, transaction_payload_t* tx, char msg_id[], size_t msg_id_len) {
+  core_message_t* msg = NULL;
+  res_send_message_t msg_res;
+  memset(&msg_res, 0, sizeof(res_send_message_t));
+
+  if ((msg = core_message_new()) == NULL) {
+    printf("[%s:%d] Err: create message failed\n", __func__, __LINE__);
+    wallet_mark_inputs(w, tx, NULL);
+    tx_payload_free(tx);
+    return -1;
+  }
+  msg->payload = tx;
+  msg->payload_type = MSG_PAYLOAD_TRANSACTION;
+  if (core_message_sign_transaction(msg) != 0) {
+    printf("[%s:%d] Err: sign transaction failed\n", __func__, __LINE__);
+    wallet_mark_inputs(w, tx, NULL);
+    core_message_free(msg);
+    return -1;
+  }
+
+  if (send_core_message(&w->endpoint, msg, &msg_res) == 0 && !msg_res.is_error) {
+    strncpy(msg_id, msg_res.u.msg_id, msg_id_len);
+    // the inputs are not selected again before the node drops them
+    wallet_mark_inputs(w, tx, msg_res.u.msg_id);
+    core_message_free(msg);
+    return 0;
+  }
+
+  if (msg_res.is_error) {
+    printf("[%s:%d] Error response: %s\n", __func__, __LINE__, msg_res.u.error->msg);
+    res_err_free(msg_res.u.error);
+  }
+  wallet_mark_inputs(w, tx, NULL);
+  core_message_free(msg);
+  return -1;
+}
+
 iota_wallet_t* wallet_create(char const ms[], char const pwd[], uint32_t account_index) {
   char mnemonic_tmp[512] = {0};  // buffer for random mnemonic
 
@@ -255,6 +489,9 @@ iota_wallet_t* wallet_create(char const ms[], char const pwd[], uint32_t account
     w->endpoint.port = NODE_DEFAULT_PORT;
     w->endpoint.use_tls = true;
     w->account_index = account_index;
+    memset(w->chain_nodes, 0, sizeof(w->chain_nodes));
+    w->utxos = utxo_cache_new();
+    w->coin_selection = COIN_SELECT_BRANCH_AND_BOUND;
 
     // drive mnemonic seed from the given sentence and password
     if (ms) {
@@ -307,13 +544,18 @@ int wallet_set_endpoint(iota_wallet_t* w, char const host[], uint16_t port, bool
 }
 
 int wallet_address_from_index(iota_wallet_t* w, bool change, uint32_t index, byte_t addr[]) {
-  char path_buf[IOTA_ACCOUNT_PATH_MAX] = {0};
+  iota_keypair_t keypair;
+  int ret = -1;
   if (!w || !addr) {
     printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
     return -1;
   }
-  get_address_path(w->account_index, change, index, path_buf, sizeof(path_buf));
-  return address_from_path(w->seed, sizeof(w->seed), path_buf, addr);
+
+  if (wallet_keypair_from_index(w, change, index, &keypair) == 0) {
+    ret = address_from_ed25519_pub(keypair.pub, addr);
+  }
+  memset(&keypair, 0, sizeof(iota_keypair_t));
+  return ret;
 }
 
 int wallet_bech32_from_index(iota_wallet_t* w, bool change, uint32_t index, char addr[]) {
@@ -326,9 +568,38 @@ int wallet_bech32_from_index(iota_wallet_t* w, bool change, uint32_t index, char
   return -1;
 }
 
+int wallet_addresses_range(iota_wallet_t* w, bool change, uint32_t start, uint32_t count, wallet_address_t out[]) {
+  byte_t tmp_addr[IOTA_ADDRESS_BYTES] = {0};
+  if (!w || (count && !out)) {
+    printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (start >= BIP32_HARDENED || count > BIP32_HARDENED - start) {
+    printf("[%s:%d] Err: address index is out of range\n", __func__, __LINE__);
+    return -1;
+  }
+
+  tmp_addr[0] = ADDRESS_VER_ED25519;
+  for (uint32_t i = 0; i < count; i++) {
+    out[i].index = start + i;
+    if (wallet_address_from_index(w, change, out[i].index, out[i].addr) != 0) {
+      printf("[%s:%d] get address %" PRIu32 " failed\n", __func__, __LINE__, out[i].index);
+      return -1;
+    }
+    memcpy(tmp_addr + 1, out[i].addr, ED25519_ADDRESS_BYTES);
+    if (address_2_bech32(tmp_addr, w->bech32HRP, out[i].bech32) != 0) {
+      printf("[%s:%d] convert address %" PRIu32 " to bech32 failed\n", __func__, __LINE__, out[i].index);
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int wallet_balance_by_address(iota_wallet_t* w, byte_t const addr[], uint64_t* balance) {
   char hex_addr[IOTA_ADDRESS_HEX_BYTES + 1] = {0};
   res_balance_t* bal_res = NULL;
+  int ret = -1;
 
   // binary address to hex string
   if (bin_2_hex(addr, ED25519_ADDRESS_BYTES, hex_addr, sizeof(hex_addr))) {
@@ -343,18 +614,15 @@ int wallet_balance_by_address(iota_wallet_t* w, byte_t const addr[], uint64_t* b
 
   if (get_balance(&w->endpoint, false, hex_addr, bal_res) != 0) {
     printf("[%s:%d] Err: get balance API failed\n", __func__, __LINE__);
-    res_balance_free(bal_res);
-    return -1;
-  }
-
-  if (bal_res->is_error) {
+  } else if (bal_res->is_error) {
     printf("[%s:%d] Err response: %s\n", __func__, __LINE__, bal_res->u.error->msg);
   } else {
     *balance = bal_res->u.output_balance->balance;
+    ret = 0;
   }
 
   res_balance_free(bal_res);
-  return 0;
+  return ret;
 }
 
 int wallet_balance_by_index(iota_wallet_t* w, bool change, uint32_t index, uint64_t* balance) {
@@ -371,6 +639,89 @@ int wallet_balance_by_bech32(iota_wallet_t* w, char const bech32[], uint64_t* ba
   return -1;
 }
 
+int wallet_gap_scan(bool change, uint32_t gap_limit, wallet_address_used_t used, void* ctx, uint32_t* next_index) {
+  uint32_t gap = 0;
+  bool is_used = false;
+
+  if (!used || !next_index) {
+    printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (gap_limit == 0) {
+    gap_limit = WALLET_DEFAULT_GAP_LIMIT;
+  }
+
+  *next_index = 0;
+  for (uint32_t index = 0; gap < gap_limit && index < BIP32_HARDENED; index++) {
+    if (used(ctx, change, index, &is_used) != 0) {
+      return -1;
+    }
+    if (is_used) {
+      *next_index = index + 1;
+      gap = 0;
+    } else {
+      gap++;
+    }
+  }
+  return 0;
+}
+
+// the context of the wallet_sync() lookups
+typedef struct {
+  iota_wallet_t* w;
+  wallet_account_summary_t* summary;
+} wallet_sync_ctx_t;
+
+// looks up the balance of an address, the outputs of a funded address are cached for the next transactions
+static int wallet_sync_address(void* ctx, bool change, uint32_t index, bool* used) {
+  wallet_sync_ctx_t* sync = (wallet_sync_ctx_t*)ctx;
+  byte_t addr[ED25519_ADDRESS_BYTES];
+  uint64_t balance = 0;
+  utxo_cache_ht *elm, *tmp;
+
+  // a single child derivation from the cached chain node
+  if (wallet_address_from_index(sync->w, change, index, addr) != 0) {
+    printf("[%s:%d] get address failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if (wallet_balance_by_address(sync->w, addr, &balance) != 0) {
+    return -1;
+  }
+
+  *used = balance > 0;
+  if (*used) {
+    if (wallet_refresh_utxos(sync->w, change, index, addr) != 0) {
+      return -1;
+    }
+    HASH_ITER(hh, sync->w->utxos, elm, tmp) {
+      if (elm->change == change && elm->addr_index == index) {
+        sync->summary->outputs++;
+      }
+    }
+    sync->summary->balance += balance;
+    sync->summary->used_addresses++;
+  }
+  return 0;
+}
+
+int wallet_sync(iota_wallet_t* w, uint32_t gap_limit, wallet_account_summary_t* summary) {
+  if (!w || !summary) {
+    printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+
+  wallet_sync_ctx_t ctx = {w, summary};
+  memset(summary, 0, sizeof(wallet_account_summary_t));
+  for (int change = 0; change < 2; change++) {
+    if (wallet_gap_scan(change, gap_limit, wallet_sync_address, &ctx, &summary->next_index[change]) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int wallet_send(iota_wallet_t* w, bool change, uint32_t addr_index, byte_t receiver[], uint64_t balance,
                 char const index[], byte_t data[], size_t data_len, char msg_id[], size_t msg_id_len) {
   core_message_t* msg = NULL;
@@ -389,52 +740,46 @@ int wallet_send(iota_wallet_t* w, bool change, uint32_t addr_index, byte_t recei
     return -1;
   }
 
-  // build payload
-  if (!receiver || balance == 0) {
-    if (!index || !data) {
-      printf("[%s:%d] Err: index and data parameters are needed\n", __func__, __LINE__);
-      return -1;
-    }
-    if ((idx = indexation_create(index, data, data_len)) == NULL) {
-      printf("[%s:%d] Err: create indexation payload failed\n", __func__, __LINE__);
+  if (receiver && balance != 0) {
+    // transaction
+    wallet_payment_t payment;
+    byte_t send_addr[ED25519_ADDRESS_BYTES];
+    memcpy(payment.addr, receiver, ED25519_ADDRESS_BYTES);
+    payment.amount = balance;
+    // a single request when the outputs of the address are known
+    if (wallet_address_from_index(w, change, addr_index, send_addr) != 0 ||
+        wallet_refresh_utxos(w, change, addr_index, send_addr) != 0) {
+      printf("[%s:%d] Err: get sender outputs failed\n", __func__, __LINE__);
       return -1;
     }
-  } else {
-    // transaction
-    if ((tx = wallet_build_transaction(w, change, addr_index, receiver, balance, index, data, data_len)) == NULL) {
+    if ((tx = wallet_build_transaction(w, change, addr_index, &payment, 1, index, data, data_len)) == NULL) {
       printf("[%s:%d] Err: create transaction payload failed\n", __func__, __LINE__);
       return -1;
     }
+    return wallet_send_transaction(w, tx, msg_id, msg_id_len);
+  }
+
+  // indexation payload only
+  if (!index || !data) {
+    printf("[%s:%d] Err: index and data parameters are needed\n", __func__, __LINE__);
+    return -1;
+  }
+  if ((idx = indexation_create(index, data, data_len)) == NULL) {
+    printf("[%s:%d] Err: create indexation payload failed\n", __func__, __LINE__);
+    return -1;
   }
 
   // put payload into message
   if ((msg = core_message_new()) == NULL) {
     printf("[%s:%d] Err: create message failed\n", __func__, __LINE__);
-    if (tx) {
-      tx_payload_free(tx);
-    } else {
-      indexation_free(idx);
-    }
+    indexation_free(idx);
     return -1;
   }
-
-  if (!tx) {
-    // indexation payload only
-    msg->payload = idx;
-    msg->payload_type = MSG_PAYLOAD_INDEXATION;
-  } else {
-    // transaction payload
-    msg->payload = tx;
-    msg->payload_type = MSG_PAYLOAD_TRANSACTION;
-    if (core_message_sign_transaction(msg) != 0) {
-      printf("[%s:%d] Err: sign transaction failed\n", __func__, __LINE__);
-      core_message_free(msg);
-      return -1;
-    }
-  }
+  msg->payload = idx;
+  msg->payload_type = MSG_PAYLOAD_INDEXATION;
 
   // send message
-  if (send_core_message(&w->endpoint, msg, &msg_res) == 0) {
+  if (send_core_message(&w->endpoint, msg, &msg_res) == 0 && !msg_res.is_error) {
     strncpy(msg_id, msg_res.u.msg_id, msg_id_len);
     core_message_free(msg);
     return 0;
@@ -449,8 +794,92 @@ int wallet_send(iota_wallet_t* w, bool change, uint32_t addr_index, byte_t recei
   return -1;
 }
 
+int wallet_build_batch(iota_wallet_t* w, bool change, uint32_t addr_index, wallet_payment_t const payments[],
+                       size_t count, transaction_payload_t* txs[], size_t* tx_count) {
+  if (!w || !payments || count == 0 || !txs || !tx_count) {
+    printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  *tx_count = 0;
+
+  // the inputs of each transaction are reserved so they are disjoint: the remainder of a transaction is not known to
+  // the node before it is confirmed
+  for (size_t built = 0; built < count; (*tx_count)++) {
+    size_t n = count - built < WALLET_BATCH_MAX_PAYMENTS ? count - built : WALLET_BATCH_MAX_PAYMENTS;
+    if ((txs[*tx_count] = wallet_build_transaction(w, change, addr_index, payments + built, n, NULL, NULL, 0)) ==
+        NULL) {
+      printf("[%s:%d] Err: create transaction payload failed\n", __func__, __LINE__);
+      break;
+    }
+    wallet_mark_inputs(w, txs[*tx_count], "");
+    built += n;
+  }
+
+  if (*tx_count == WALLET_BATCH_MESSAGES(count)) {
+    return 0;
+  }
+  for (size_t i = 0; i < *tx_count; i++) {
+    wallet_mark_inputs(w, txs[i], NULL);
+    tx_payload_free(txs[i]);
+    txs[i] = NULL;
+  }
+  *tx_count = 0;
+  return -1;
+}
+
+int wallet_send_batch(iota_wallet_t* w, bool change, uint32_t addr_index, wallet_payment_t const payments[],
+                      size_t count, char msg_ids[][IOTA_MESSAGE_ID_HEX_BYTES + 1], size_t* msg_count) {
+  byte_t send_addr[ED25519_ADDRESS_BYTES];
+  transaction_payload_t** txs = NULL;
+  size_t tx_count = 0;
+  int ret = -1;
+
+  if (!w || !payments || count == 0 || !msg_ids || !msg_count) {
+    printf("[%s:%d] Err: invalid parameters\n", __func__, __LINE__);
+    return -1;
+  }
+  *msg_count = 0;
+
+  if (wallet_address_from_index(w, change, addr_index, send_addr) != 0 ||
+      wallet_refresh_utxos(w, change, addr_index, send_addr) != 0) {
+    printf("[%s:%d] Err: get sender outputs failed\n", __func__, __LINE__);
+    return -1;
+  }
+
+  if ((txs = calloc(WALLET_BATCH_MESSAGES(count), sizeof(transaction_payload_t*))) == NULL) {
+    printf("[%s:%d] Err: OOM\n", __func__, __LINE__);
+    return -1;
+  }
+
+  // all the transactions are built before the first message
+  if ((ret = wallet_build_batch(w, change, addr_index, payments, count, txs, &tx_count)) == 0) {
+    for (size_t i = 0; i < tx_count; i++) {
+      // the message takes the ownership of the transaction
+      transaction_payload_t* tx = txs[i];
+      txs[i] = NULL;
+      if ((ret = wallet_send_transaction(w, tx, msg_ids[*msg_count], IOTA_MESSAGE_ID_HEX_BYTES + 1)) != 0) {
+        break;
+      }
+      (*msg_count)++;
+    }
+  }
+
+  // the transactions that were not sent
+  for (size_t i = 0; i < tx_count; i++) {
+    if (txs[i]) {
+      wallet_mark_inputs(w, txs[i], NULL);
+      tx_payload_free(txs[i]);
+    }
+  }
+  free(txs);
+  return ret;
+}
+
 void wallet_destroy(iota_wallet_t* w) {
   if (w) {
+    utxo_cache_free(&w->utxos);
+    // the seed and the cached keys
+    memset(w, 0, sizeof(iota_wallet_t));
     free(w);
   }
 }
@@ -20,6 +20,9 @@
 #include "core/models/models_message.h"
 #include "core/seed.h"
 #include "core/types.h"
+#include "core/utils/slip10.h"
+#include "wallet/coin_selection.h"
+#include "wallet/utxo_cache.h"
 
 /** @addtogroup IOTA_C
  * @{
@@ -41,6 +44,18 @@ extern "C" {
 #define NODE_DEFAULT_HOST "chrysalis-nodes.iota.org"
 #define NODE_DEFAULT_PORT 443
 
+// the number of consecutive unused addresses that ends the scan of a chain
+#define WALLET_DEFAULT_GAP_LIMIT 20
+
+// a bech32 address with the longest HRP a wallet holds, null terminator included
+#define WALLET_BECH32_ADDRESS_BYTES (BECH32_ADDRESS_LEN + 3)
+
+// the payments of a batch message, one of the 126 outputs of a transaction is kept for the remainder
+#define WALLET_BATCH_MAX_PAYMENTS 125
+
+// the number of messages sending a batch of count payments
+#define WALLET_BATCH_MESSAGES(count) (((count) + WALLET_BATCH_MAX_PAYMENTS - 1) / WALLET_BATCH_MAX_PAYMENTS)
+
 /**
  * @}
  */
@@ -49,15 +64,66 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief A derived m/44'/4218'/Account'/Change' node
+ *
+ * Addresses of a chain are children of this node, keeping it makes an address cost a single child derivation.
+ *
+ */
+typedef struct {
+  slip10_key_t key;  ///< the extended private key of the node
+  uint32_t account;  ///< the account index the key is derived for
+  bool valid;        ///< the key is derived
+} wallet_chain_node_t;
+
+/**
+ * @brief An address of a wallet range
+ *
+ */
+typedef struct {
+  uint32_t index;                            ///< the address index
+  byte_t addr[ED25519_ADDRESS_BYTES];        ///< the ed25519 address
+  char bech32[WALLET_BECH32_ADDRESS_BYTES];  ///< the bech32 address with the HRP of the wallet
+} wallet_address_t;
+
+/**
+ * @brief A payment of a batch
+ *
+ */
+typedef struct {
+  byte_t addr[ED25519_ADDRESS_BYTES];  ///< the receiver address in ed25519 format
+  uint64_t amount;                     ///< the amount to send
+} wallet_payment_t;
+
+/**
+ * @brief The funds of an account found by wallet_sync()
+ *
+ */
+typedef struct {
+  uint64_t balance;         ///< the total balance of the account
+  uint32_t used_addresses;  ///< the number of addresses holding funds
+  uint32_t outputs;         ///< the number of unspent outputs
+  uint32_t next_index[2];   ///< the index after the last used address of the external (0) and change (1) chains
+} wallet_account_summary_t;
+
+/**
+ * @brief Tells whether an address of a chain holds funds, see wallet_gap_scan()
+ *
+ */
+typedef int (*wallet_address_used_t)(void* ctx, bool change, uint32_t index, bool* used);
+
 /**
  * @brief IOTA wallet setting
  *
  */
 typedef struct {
-  byte_t seed[64];              ///< the mnemonic seed of this wallet
-  char bech32HRP[8];            ///< The Bech32 HRP of the network. `iota` for mainnet, `atoi` for testnet.
-  uint32_t account_index;       ///< wallet account index
-  iota_client_conf_t endpoint;  ///< IOTA node endpoint
+  byte_t seed[64];                        ///< the mnemonic seed of this wallet
+  char bech32HRP[8];                      ///< The Bech32 HRP of the network. `iota` for mainnet, `atoi` for testnet.
+  uint32_t account_index;                 ///< wallet account index
+  iota_client_conf_t endpoint;            ///< IOTA node endpoint
+  wallet_chain_node_t chain_nodes[2];     ///< the cached nodes of the external (0) and change (1) chains
+  utxo_cache_ht* utxos;                   ///< the known unspent outputs of the account
+  coin_select_strategy_t coin_selection;  ///< the strategy picking the inputs of transactions
 } iota_wallet_t;
 
 /**
@@ -113,13 +179,27 @@ int wallet_address_from_index(iota_wallet_t* w, bool change, uint32_t index, byt
  */
 int wallet_bech32_from_index(iota_wallet_t* w, bool change, uint32_t index, char addr[]);
 
+/**
+ * @brief Get a range of addresses in binary and bech32 forms
+ *
+ * The account/change node is derived once, each address of the range then costs a single child derivation.
+ *
+ * @param[in] w A wallet instance
+ * @param[in] change The change index which is {0, 1}, also known as wallet chain.
+ * @param[in] start The first address index
+ * @param[in] count The number of addresses
+ * @param[out] out An array of count addresses
+ * @return int 0 on success
+ */
+int wallet_addresses_range(iota_wallet_t* w, bool change, uint32_t start, uint32_t count, wallet_address_t out[]);
+
 /**
  * @brief Get balance by a given address
  *
  * @param[in] w A wallet instance
  * @param[in] addr An address for query
  * @param[out] balance The balance of the address
- * @return int 0 on success
+ * @return int 0 on success, -1 on a request failure or an error response
  */
 int wallet_balance_by_address(iota_wallet_t* w, byte_t const addr[], uint64_t* balance);
 
@@ -134,9 +214,39 @@ int wallet_balance_by_address(iota_wallet_t* w, byte_t const addr[], uint64_t* b
  */
 int wallet_balance_by_index(iota_wallet_t* w, bool change, uint32_t index, uint64_t* balance);
 
+/**
+ * @brief Scan the addresses of a chain in index order until gap_limit consecutive unused ones
+ *
+ * @param[in] change Is change/chain address?
+ * @param[in] gap_limit The number of consecutive unused addresses that ends the chain, 0 for WALLET_DEFAULT_GAP_LIMIT
+ * @param[in] used The lookup of an address
+ * @param[in] ctx The context passed to the lookup
+ * @param[out] next_index The index after the last used address, 0 if none is used
+ * @return int 0 on success, -1 if a lookup fails
+ */
+int wallet_gap_scan(bool change, uint32_t gap_limit, wallet_address_used_t used, void* ctx, uint32_t* next_index);
+
+/**
+ * @brief Discover the funds of the account
+ *
+ * The addresses of both chains are queried in index order, the scan of a chain stops after gap_limit consecutive
+ * addresses without funds. The outputs of the funded addresses are kept in the UTXO cache of the wallet. Requests go
+ * through the keep-alive connection pool of the client.
+ *
+ * @param[in] w A wallet instance
+ * @param[in] gap_limit The number of consecutive unused addresses that ends a chain, 0 for WALLET_DEFAULT_GAP_LIMIT
+ * @param[out] summary The account summary
+ * @return int 0 on success
+ */
+int wallet_sync(iota_wallet_t* w, uint32_t gap_limit, wallet_account_summary_t* summary);
+
 /**
  * @brief Send message to the Tangle
  *
+ * Inputs are picked by the coin_selection strategy of the wallet among the unspent outputs of the sender address and
+ * of the addresses found by wallet_sync(), the remainder goes back to the sender address. A remainder is
+ * COIN_SELECT_MIN_CHANGE at least, the node rejects a dust output.
+ *
  * @param[in] w A wallet instance
  * @param[in] change Is change/chain address?
  * @param[in] sender_index The address index of this wallet
@@ -151,6 +261,52 @@ int wallet_balance_by_index(iota_wallet_t* w, bool change, uint32_t index, uint6
 int wallet_send(iota_wallet_t* w, bool change, uint32_t addr_index, byte_t receiver[], uint64_t balance,
                 char const index[], byte_t data[], size_t data_len, char msg_id[], size_t msg_id_len);
 
+/**
+ * @brief Build the transactions of a batch of payments from the cached outputs
+ *
+ * Payments are grouped by WALLET_BATCH_MAX_PAYMENTS into transactions, payments to the same address in a group are
+ * merged into a single output and the remainder of each transaction goes back to the sender address. The inputs of
+ * the transactions are disjoint and reserved in the cache until they are spent or released. No request is made, the
+ * outputs of the sender address are expected to be refreshed.
+ *
+ * On failure nothing is built and no input is reserved.
+ *
+ * @param[in] w A wallet instance
+ * @param[in] change Is change/chain address?
+ * @param[in] addr_index The address index of this wallet
+ * @param[in] payments The payments to send
+ * @param[in] count The number of payments
+ * @param[out] txs A buffer holds WALLET_BATCH_MESSAGES(count) transactions, owned by the caller on success
+ * @param[out] tx_count The number of transactions built
+ * @return int 0 on success
+ */
+int wallet_build_batch(iota_wallet_t* w, bool change, uint32_t addr_index, wallet_payment_t const payments[],
+                       size_t count, transaction_payload_t* txs[], size_t* tx_count);
+
+/**
+ * @brief Send a batch of payments to the Tangle
+ *
+ * Payments are grouped by WALLET_BATCH_MAX_PAYMENTS into transactions, each one is sent in its own message. Payments
+ * to the same address in a group are merged into a single output. Inputs are picked as wallet_send() does, the
+ * remainder of each transaction goes back to the sender address.
+ *
+ * The outputs of the sender address are refreshed and all the transactions are built by wallet_build_batch() before
+ * the first message, each output is used once since the remainders are not spendable before they are confirmed.
+ * Nothing is sent if the outputs cannot cover every transaction; if a message is rejected the later ones are not sent and msg_count tells the messages that were sent.
+ * All the transactions of the batch are held in memory until they are sent.
+ *
+ * @param[in] w A wallet instance
+ * @param[in] change Is change/chain address?
+ * @param[in] addr_index The address index of this wallet
+ * @param[in] payments The payments to send
+ * @param[in] count The number of payments
+ * @param[out] msg_ids A buffer holds WALLET_BATCH_MESSAGES(count) message ID strings
+ * @param[out] msg_count The number of messages sent
+ * @return int 0 on success
+ */
+int wallet_send_batch(iota_wallet_t* w, bool change, uint32_t addr_index, wallet_payment_t const payments[],
+                      size_t count, char msg_ids[][IOTA_MESSAGE_ID_HEX_BYTES + 1], size_t* msg_count);
+
 /**
  * @brief Destory the wallet account
  *
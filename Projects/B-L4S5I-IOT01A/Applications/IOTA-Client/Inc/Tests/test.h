@@ -60,6 +60,13 @@ extern "C" {
 __weak void setUp(void) {};
 __weak void tearDown(void) {};
 
+/**
+ * @brief   A simple test for the coin selection of the wallet
+ * @param   None
+ * @retval  0:  Success.
+ *        !=0:  Failure.
+ */
+int test_coin_selection(void);
 /**
  * @brief   A simple test for crypto features
  * @param   None
@@ -109,6 +116,13 @@ int test_get_tips(void);
  *        !=0:  Failure.
  */
 void test_info(void);
+/**
+ * @brief   A simple test for the JSON stream parser
+ * @param   None
+ * @retval  0:  Success.
+ *        !=0:  Failure.
+ */
+int test_json_stream(void);
 /**
  * @brief   A simple test for building a an indexation/transaction message
  * @param   None
@@ -151,6 +165,20 @@ int test_response_error(void);
  *        !=0:  Failure.
  */
 int test_send_message(void);
+/**
+ * @brief   A simple test for the UTXO cache of the wallet
+ * @param   None
+ * @retval  0:  Success.
+ *        !=0:  Failure.
+ */
+int test_utxo_cache(void);
+/**
+ * @brief   A simple test for the wallet
+ * @param   None
+ * @retval  0:  Success.
+ *        !=0:  Failure.
+ */
+int test_wallet(void);
 
 /**
  * @}
@@ -0,0 +1,128 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+/* Includes ----------------------------------------------------------------- */
+#include <stdio.h>
+
+#include "unity.h"
+
+#include "wallet/coin_selection.h"
+
+/* Private defines ---------------------------------------------------------- */
+#define MI 1000000ULL
+
+/* Private variables -------------------------------------------------------- */
+static uint64_t const amounts[] = {5 * MI, 1 * MI, 3 * MI, 10 * MI};
+static size_t const amounts_count = sizeof(amounts) / sizeof(amounts[0]);
+
+/* Private functions -------------------------------------------------------- */
+void test_select_largest_first(void)
+{
+  size_t selected[4];
+  size_t count = 0;
+  uint64_t total = 0;
+
+  TEST_ASSERT(coin_select(amounts, amounts_count, 4 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_LARGEST_FIRST, 4,
+                          selected, &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(1, count);
+  TEST_ASSERT_EQUAL_UINT32(3, selected[0]);
+  TEST_ASSERT(total == 10 * MI);
+
+  // the largest outputs until the target is reached
+  TEST_ASSERT(coin_select(amounts, amounts_count, 14 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_LARGEST_FIRST, 4,
+                          selected, &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(2, count);
+  TEST_ASSERT_EQUAL_UINT32(3, selected[0]);
+  TEST_ASSERT_EQUAL_UINT32(0, selected[1]);
+  TEST_ASSERT(total == 15 * MI);
+}
+
+void test_select_min_inputs(void)
+{
+  size_t selected[4];
+  size_t count = 0;
+  uint64_t total = 0;
+
+  // the 10 Mi output is swapped for the 5 Mi one, the change is 1 Mi
+  TEST_ASSERT(coin_select(amounts, amounts_count, 4 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_MIN_INPUTS, 4, selected,
+                          &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(1, count);
+  TEST_ASSERT_EQUAL_UINT32(0, selected[0]);
+  TEST_ASSERT(total == 5 * MI);
+
+  // the swap would leave a dust change of 0.5 Mi
+  TEST_ASSERT(coin_select(amounts, amounts_count, 4500000, COIN_SELECT_MIN_CHANGE, COIN_SELECT_MIN_INPUTS, 4,
+                          selected, &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(1, count);
+  TEST_ASSERT_EQUAL_UINT32(3, selected[0]);
+  TEST_ASSERT(total == 10 * MI);
+
+  // without a minimum change the smallest change is kept
+  TEST_ASSERT(coin_select(amounts, amounts_count, 4500000, 0, COIN_SELECT_MIN_INPUTS, 4, selected, &count, &total) ==
+              0);
+  TEST_ASSERT_EQUAL_UINT32(1, count);
+  TEST_ASSERT_EQUAL_UINT32(0, selected[0]);
+  TEST_ASSERT(total == 5 * MI);
+}
+
+void test_select_branch_and_bound(void)
+{
+  size_t selected[4];
+  size_t count = 0;
+  uint64_t total = 0;
+
+  // an exact match has no change output
+  TEST_ASSERT(coin_select(amounts, amounts_count, 4 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 4,
+                          selected, &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(2, count);
+  TEST_ASSERT(amounts[selected[0]] + amounts[selected[1]] == 4 * MI);
+  TEST_ASSERT(total == 4 * MI);
+
+  TEST_ASSERT(coin_select(amounts, amounts_count, 19 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 4,
+                          selected, &count, &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(4, count);
+  TEST_ASSERT(total == 19 * MI);
+
+  // no exact match, the fallback adds an input rather than leaving a dust change
+  uint64_t const two[] = {7 * MI, 2 * MI};
+  TEST_ASSERT(coin_select(two, 2, 6500000, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 2, selected, &count,
+                          &total) == 0);
+  TEST_ASSERT_EQUAL_UINT32(2, count);
+  TEST_ASSERT(total == 9 * MI);
+}
+
+void test_select_failures(void)
+{
+  size_t selected[4];
+  size_t count = 0;
+  uint64_t total = 0;
+
+  // not enough funds
+  TEST_ASSERT(coin_select(amounts, amounts_count, 20 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 4,
+                          selected, &count, &total) == -1);
+  // too many inputs needed
+  TEST_ASSERT(coin_select(amounts, amounts_count, 16 * MI, COIN_SELECT_MIN_CHANGE, COIN_SELECT_LARGEST_FIRST, 2,
+                          selected, &count, &total) == -1);
+  // only a dust change is possible
+  uint64_t const one[] = {5 * MI};
+  TEST_ASSERT(coin_select(one, 1, 4500000, COIN_SELECT_MIN_CHANGE, COIN_SELECT_MIN_INPUTS, 1, selected, &count,
+                          &total) == -1);
+  // no output
+  TEST_ASSERT(coin_select(amounts, 0, 1, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 4, selected, &count,
+                          &total) == -1);
+  TEST_ASSERT(coin_select(amounts, amounts_count, 0, COIN_SELECT_MIN_CHANGE, COIN_SELECT_BRANCH_AND_BOUND, 4,
+                          selected, &count, &total) == -1);
+}
+
+/* Exported functions ------------------------------------------------------- */
+int test_coin_selection(void)
+{
+  UNITY_BEGIN();
+
+  RUN_TEST(test_select_largest_first);
+  RUN_TEST(test_select_min_inputs);
+  RUN_TEST(test_select_branch_and_bound);
+  RUN_TEST(test_select_failures);
+
+  return UNITY_END();
+}
@@ -8,6 +8,7 @@
 
 #include "stm32l4xx_hal.h"
 #include "core/address.h"
+#include "core/utils/slip10.h"
 #include "blake2b_data.h"
 #include "crypto/iota_crypto.h"
 
@@ -115,6 +116,8 @@ static void test_blake2b_hash(void)
     msg[i] = i;
   }
 
+  // the same vectors with the implementation picked for this CPU
+  TEST_ASSERT(iota_crypto_init() == 0);
   for (size_t i = 0; i < sizeof(msg); i++) {
     iota_blake2b_sum(msg, i, out_256, sizeof(out_256));
     iota_blake2b_sum(msg, i, out_512, sizeof(out_512));
@@ -123,6 +126,49 @@ static void test_blake2b_hash(void)
   }
 }
 
+// incremental hashing gives the one-shot hash, whatever the data split
+static void test_hash_incremental(void)
+{
+  uint8_t msg[256];
+  uint8_t out_256[32];
+  uint8_t exp_hash[CRYPTO_SHA512_HASH_BYTES];
+  uint8_t hash[CRYPTO_SHA512_HASH_BYTES];
+
+  for (size_t i = 0; i < sizeof(msg); i++) {
+    msg[i] = i;
+  }
+
+  iota_hash_state_t* state = iota_hash_state_new();
+  TEST_ASSERT_NOT_NULL(state);
+  for (size_t split = 0; split <= 200; split += 40) {
+    TEST_ASSERT(iota_blake2b_init(state, sizeof(out_256)) == 0);
+    TEST_ASSERT(iota_blake2b_update(state, msg, split) == 0);
+    TEST_ASSERT(iota_blake2b_update(state, msg + split, 200 - split) == 0);
+    TEST_ASSERT(iota_blake2b_final(state, out_256, sizeof(out_256)) == 0);
+    TEST_ASSERT_EQUAL_MEMORY(blake2b_256[200], out_256, sizeof(out_256));
+
+    TEST_ASSERT(iota_crypto_sha256(msg, 200, exp_hash) == 0);
+    TEST_ASSERT(iota_sha256_init(state) == 0);
+    TEST_ASSERT(iota_sha256_update(state, msg, split) == 0);
+    TEST_ASSERT(iota_sha256_update(state, msg + split, 200 - split) == 0);
+    TEST_ASSERT(iota_sha256_final(state, hash) == 0);
+    TEST_ASSERT_EQUAL_MEMORY(exp_hash, hash, CRYPTO_SHA256_HASH_BYTES);
+
+    TEST_ASSERT(iota_crypto_sha512(msg, 200, exp_hash) == 0);
+    TEST_ASSERT(iota_sha512_init(state) == 0);
+    TEST_ASSERT(iota_sha512_update(state, msg, split) == 0);
+    TEST_ASSERT(iota_sha512_update(state, msg + split, 200 - split) == 0);
+    TEST_ASSERT(iota_sha512_final(state, hash) == 0);
+    TEST_ASSERT_EQUAL_MEMORY(exp_hash, hash, CRYPTO_SHA512_HASH_BYTES);
+  }
+
+  // an update needs a started hash of the same algorithm
+  TEST_ASSERT(iota_blake2b_update(state, msg, 1) != 0);
+  TEST_ASSERT(iota_sha256_init(state) == 0);
+  TEST_ASSERT(iota_sha512_update(state, msg, 1) != 0);
+  iota_hash_state_free(state);
+}
+
 // HMAC-SHA-256 and HMAC-SHA-512
 // test vectors: https://tools.ietf.org/html/rfc4231#section-4.2
 void test_hmacsha()
@@ -203,6 +249,40 @@ void test_ed25519_signature()
 }
 #endif /* SIGNATURE_TEST_EXTENDED */
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+void test_ed25519_verify()
+{
+  uint8_t seed[ED_SEED_BYTES];
+  uint8_t msg[3][32];
+  uint8_t sig[3][ED_SIGNATURE_BYTES];
+  iota_keypair_t keypair;
+
+  memset(seed, 0x5A, sizeof(seed));
+  iota_crypto_keypair(seed, &keypair);
+  for (size_t i = 0; i < 3; i++) {
+    memset(msg[i], (int)i, sizeof(msg[i]));
+    TEST_ASSERT(iota_crypto_sign(keypair.priv, msg[i], sizeof(msg[i]), sig[i]) == 0);
+    TEST_ASSERT(iota_crypto_verify(keypair.pub, msg[i], sizeof(msg[i]), sig[i]) == 0);
+  }
+  // a signature of another message
+  TEST_ASSERT(iota_crypto_verify(keypair.pub, msg[0], sizeof(msg[0]), sig[1]) != 0);
+
+  uint8_t const* pub_keys[3] = {keypair.pub, keypair.pub, keypair.pub};
+  uint8_t const* msgs[3] = {msg[0], msg[1], msg[2]};
+  size_t msg_lens[3] = {sizeof(msg[0]), sizeof(msg[1]), sizeof(msg[2])};
+  uint8_t const* sigs[3] = {sig[0], sig[1], sig[2]};
+  bool valid[3];
+  TEST_ASSERT(iota_crypto_verify_batch(pub_keys, msgs, msg_lens, sigs, 3, valid) == 0);
+  TEST_ASSERT(valid[0] && valid[1] && valid[2]);
+
+  // the invalid signature is found in the batch
+  sig[1][0] ^= 0x01;
+  TEST_ASSERT(iota_crypto_verify_batch(pub_keys, msgs, msg_lens, sigs, 3, valid) != 0);
+  TEST_ASSERT(valid[0] && !valid[1] && valid[2]);
+  TEST_ASSERT(iota_crypto_verify_batch(pub_keys, msgs, msg_lens, sigs, 3, NULL) != 0);
+}
+#endif /* CRYPTO_HAS_ED25519_VERIFY */
+
 void test_address_gen()
 {
   // address from ed25519 keypair
@@ -218,6 +298,32 @@ void test_address_gen()
   TEST_ASSERT(address_from_ed25519_pub(seed_keypair.pub, ed_addr) == 0);
 //  dump_hex(ed_addr, ED25519_ADDRESS_BYTES);
 //  dump_hex(seed, IOTA_SEED_BYTES);
+
+  // a child of a derived chain node is the key of the full path
+  slip10_key_t chain_key, addr_key, child_key;
+  TEST_ASSERT(slip10_key_from_path(seed, sizeof(seed), "m/44'/4218'/0'/1'", ED25519_CURVE, &chain_key) == 0);
+  TEST_ASSERT(slip10_key_from_path(seed, sizeof(seed), "m/44'/4218'/0'/1'/7'", ED25519_CURVE, &addr_key) == 0);
+  TEST_ASSERT(slip10_key_derive_child(ED25519_CURVE, &chain_key, 7 | BIP32_HARDENED, &child_key) == 0);
+  TEST_ASSERT_EQUAL_MEMORY(&addr_key, &child_key, sizeof(slip10_key_t));
+  // ed25519 only supports hardened indices
+  TEST_ASSERT(slip10_key_derive_child(ED25519_CURVE, &chain_key, 7, &child_key) != 0);
+
+  // the binary path gives the address of the string path
+  byte_t path_addr[ED25519_ADDRESS_BYTES];
+  uint32_t const indices[] = {44 | BIP32_HARDENED, 4218 | BIP32_HARDENED, 0 | BIP32_HARDENED, 1 | BIP32_HARDENED,
+                              7 | BIP32_HARDENED};
+  TEST_ASSERT(address_from_path(seed, sizeof(seed), "m/44'/4218'/0'/1'/7'", path_addr) == 0);
+  TEST_ASSERT(address_from_indices(seed, sizeof(seed), indices, 5, ed_addr) == 0);
+  TEST_ASSERT_EQUAL_MEMORY(path_addr, ed_addr, sizeof(ed_addr));
+  TEST_ASSERT(address_from_indices(seed, sizeof(seed), indices, 4, ed_addr) == 0);
+  TEST_ASSERT(memcmp(path_addr, ed_addr, sizeof(ed_addr)) != 0);
+
+  bip32_path_t path;
+  TEST_ASSERT(slip10_parse_path("m/44H/4218H/0H/1H/7H", &path) == 0);
+  TEST_ASSERT_EQUAL_INT(5, path.len);
+  TEST_ASSERT_EQUAL_MEMORY(indices, path.path, sizeof(indices));
+  TEST_ASSERT(slip10_parse_path("m/44'/2147483648'", &path) != 0);
+  TEST_ASSERT(slip10_parse_path("m/44'//0'", &path) != 0);
 }
 
 // test vectors: https://www.di-mgt.com.au/sha_testvectors.html
@@ -265,6 +371,28 @@ void test_sha()
   TEST_ASSERT_EQUAL_MEMORY(tmp_hash, tmp_bin, CRYPTO_SHA512_HASH_BYTES);
 }
 
+void test_randombytes()
+{
+  uint8_t buf1[32], buf2[32], large[600];
+
+  // successive requests from the pool and across refills differ
+  iota_crypto_randombytes(buf1, sizeof(buf1));
+  for (size_t i = 0; i < 20; i++) {
+    iota_crypto_randombytes(buf2, sizeof(buf2));
+    TEST_ASSERT(memcmp(buf1, buf2, sizeof(buf1)) != 0);
+    memcpy(buf1, buf2, sizeof(buf1));
+  }
+
+  // requests larger than the pool
+  memset(large, 0, sizeof(large));
+  iota_crypto_randombytes(large, sizeof(large));
+  TEST_ASSERT(memcmp(large, large + 300, 32) != 0);
+
+  iota_crypto_rng_reseed();
+  iota_crypto_randombytes(buf2, sizeof(buf2));
+  TEST_ASSERT(memcmp(buf1, buf2, sizeof(buf1)) != 0);
+}
+
 void test_pbkdf2_hmac_sha512()
 {
 #define BUF_SIZE 256
@@ -305,7 +433,19 @@ int test_crypto(void)
   printf("test_hmacsha exp time[ms]: %lu\n", end - start);
 #endif /* EXPENDED_TEST_TIME */
 
+#ifdef EXPENDED_TEST_TIME
+  start = HAL_GetTick();
+#endif /* EXPENDED_TEST_TIME */
+  RUN_TEST(test_pbkdf2_hmac_sha512);
+#ifdef EXPENDED_TEST_TIME
+  end = HAL_GetTick();
+  printf("test_pbkdf2_hmac_sha512 exp time[ms]: %lu\n", end - start);
+#endif /* EXPENDED_TEST_TIME */
+
   RUN_TEST(test_blake2b_hash);
+  RUN_TEST(test_hash_incremental);
+
+  RUN_TEST(test_randombytes);
 
 #ifdef EXPENDED_TEST_TIME
   start = HAL_GetTick();
@@ -316,6 +456,10 @@ int test_crypto(void)
   printf("test_ed25519_signature exp time[ms]: %lu\n", end - start);
 #endif /* EXPENDED_TEST_TIME */
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  RUN_TEST(test_ed25519_verify);
+#endif
+
 #ifdef EXPENDED_TEST_TIME
   start = HAL_GetTick();
 #endif /* EXPENDED_TEST_TIME */
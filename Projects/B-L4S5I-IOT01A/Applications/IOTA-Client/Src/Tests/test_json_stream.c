@@ -0,0 +1,196 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+/* Includes ----------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "client/api/json_stream.h"
+
+/* Private define ----------------------------------------------------------- */
+#define LOG_MAX 1024
+
+/* Private typedef ---------------------------------------------------------- */
+// the events of a parse, one "event path=value" line each
+typedef struct {
+  char log[LOG_MAX];
+  size_t len;
+  int abort_at;  // the event number stopping the parse, -1 for none
+  int events;
+} stream_log_t;
+
+/* Private variables -------------------------------------------------------- */
+static char const doc[] =
+    " {\"data\": {\"messageIds\": [\"7dab\", \"d008\"], \"count\": 2, \"maxResults\":1000,"
+    " \"text\": \"a\\\"b\\\\c\\/d\\n\\t\\u0041\\u00e9\\u20ac\", \"ok\": true, \"none\": null,"
+    " \"nested\": [[], {}, [-1.5e3, false]]}} ";
+
+/* Private functions -------------------------------------------------------- */
+static int log_event(void* opaque, json_stream_event_t event, char const* path, char const* value, size_t len)
+{
+  stream_log_t* log = (stream_log_t*)opaque;
+  TEST_ASSERT_EQUAL_UINT32(strlen(value), len);
+  if (log->events++ == log->abort_at) {
+    return -1;
+  }
+  int n = snprintf(log->log + log->len, LOG_MAX - log->len, "%d %s=%s\n", event, path, value);
+  TEST_ASSERT(n > 0 && (size_t)n < LOG_MAX - log->len);
+  log->len += (size_t)n;
+  return 0;
+}
+
+static void log_init(stream_log_t* log)
+{
+  memset(log, 0, sizeof(stream_log_t));
+  log->abort_at = -1;
+}
+
+// parses a document fed in two chunks split at the given byte
+static int parse_split(char const* json, size_t len, size_t split, stream_log_t* log)
+{
+  json_stream_t js;
+  log_init(log);
+  json_stream_init(&js, log_event, log);
+  if (json_stream_feed(&js, json, split) != 0 || json_stream_feed(&js, json + split, len - split) != 0) {
+    return -1;
+  }
+  return json_stream_finish(&js);
+}
+
+// parses a document fed one byte at a time
+static int parse_bytes(char const* json, size_t len, stream_log_t* log)
+{
+  json_stream_t js;
+  log_init(log);
+  json_stream_init(&js, log_event, log);
+  for (size_t i = 0; i < len; i++) {
+    if (json_stream_feed(&js, json + i, 1) != 0) {
+      return -1;
+    }
+  }
+  return json_stream_finish(&js);
+}
+
+void test_stream_split(void)
+{
+  static stream_log_t whole, part;
+  size_t len = strlen(doc);
+
+  TEST_ASSERT(parse_split(doc, len, len, &whole) == 0);
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "4 data.messageIds[]=7dab\n4 data.messageIds[]=d008\n"));
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "5 data.count=2\n"));
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "5 data.maxResults=1000\n"));
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "4 data.text=a\"b\\c/d\n\tA\xC3\xA9\xE2\x82\xAC\n"));
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "6 data.ok=true\n7 data.none=null\n"));
+  TEST_ASSERT_NOT_NULL(strstr(whole.log, "5 data.nested[][]=-1.5e3\n6 data.nested[][]=false\n"));
+
+  // the same events whatever the chunks
+  for (size_t split = 0; split <= len; split++) {
+    TEST_ASSERT(parse_split(doc, len, split, &part) == 0);
+    TEST_ASSERT_EQUAL_STRING(whole.log, part.log);
+  }
+  TEST_ASSERT(parse_bytes(doc, len, &part) == 0);
+  TEST_ASSERT_EQUAL_STRING(whole.log, part.log);
+}
+
+void test_stream_truncated(void)
+{
+  static char json[JSON_STREAM_TOKEN_MAX + 32];
+  static stream_log_t log;
+  char value[JSON_STREAM_TOKEN_MAX + 1];
+  size_t len;
+
+  // the longest string value
+  memset(value, 'x', JSON_STREAM_TOKEN_MAX - 1);
+  value[JSON_STREAM_TOKEN_MAX - 1] = '\0';
+  len = (size_t)snprintf(json, sizeof(json), "{\"id\":\"%s\"}", value);
+  for (size_t split = 0; split <= len; split++) {
+    TEST_ASSERT(parse_split(json, len, split, &log) == 0);
+    char const* line = strstr(log.log, "4 id=");
+    TEST_ASSERT_NOT_NULL(line);
+    TEST_ASSERT(strncmp(line + strlen("4 id="), value, JSON_STREAM_TOKEN_MAX - 1) == 0);
+    TEST_ASSERT_EQUAL_CHAR('\n', line[strlen("4 id=") + JSON_STREAM_TOKEN_MAX - 1]);
+  }
+
+  // one character more, the value never reaches the callback
+  value[JSON_STREAM_TOKEN_MAX - 1] = 'x';
+  value[JSON_STREAM_TOKEN_MAX] = '\0';
+  len = (size_t)snprintf(json, sizeof(json), "{\"id\":\"%s\"}", value);
+  for (size_t split = 0; split <= len; split++) {
+    TEST_ASSERT(parse_split(json, len, split, &log) == -1);
+    TEST_ASSERT_NULL(strstr(log.log, "4 id="));
+  }
+
+  // an escape decoded past the buffer, split inside the escape
+  value[JSON_STREAM_TOKEN_MAX - 2] = '\0';
+  len = (size_t)snprintf(json, sizeof(json), "{\"id\":\"%s\\u20ac\"}", value);
+  for (size_t split = 0; split <= len; split++) {
+    TEST_ASSERT(parse_split(json, len, split, &log) == -1);
+    TEST_ASSERT_NULL(strstr(log.log, "4 id="));
+  }
+
+  // a truncated key
+  len = (size_t)snprintf(json, sizeof(json), "{\"%s\":1}", value);
+  TEST_ASSERT(parse_bytes(json, len, &log) == -1);
+}
+
+void test_stream_errors(void)
+{
+  static stream_log_t log;
+  json_stream_t js;
+  char const* invalid[] = {"{\"a\":\"\\x\"}", "{\"a\":\"\\u12g4\"}", "{\"a\" 1}", "{\"a\":1]", "[1,}", "[tru]",
+                           "{\"a\":\"b\nc\"}", "{} {}"};
+
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    size_t len = strlen(invalid[i]);
+    for (size_t split = 0; split <= len; split++) {
+      TEST_ASSERT(parse_split(invalid[i], len, split, &log) == -1);
+    }
+  }
+
+  // an incomplete document
+  TEST_ASSERT(parse_split(doc, strlen(doc) - 3, strlen(doc) / 2, &log) == -1);
+
+  // a number at the root
+  TEST_ASSERT(parse_split("42", 2, 1, &log) == 0);
+  TEST_ASSERT_EQUAL_STRING("5 =42\n", log.log);
+
+  // the callback stops the parse, the error is sticky
+  log_init(&log);
+  log.abort_at = 2;
+  json_stream_init(&js, log_event, &log);
+  TEST_ASSERT(json_stream_feed(&js, doc, strlen(doc)) == -1);
+  TEST_ASSERT(json_stream_feed(&js, " ", 1) == -1);
+  TEST_ASSERT(json_stream_finish(&js) == -1);
+}
+
+void test_stream_numbers(void)
+{
+  uint32_t n32 = 0;
+  uint64_t n64 = 0;
+
+  TEST_ASSERT(json_stream_to_uint32("4294967295", &n32) == 0);
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, n32);
+  TEST_ASSERT(json_stream_to_uint32("4294967296", &n32) == -1);
+  TEST_ASSERT(json_stream_to_uint64("18446744073709551615", &n64) == 0);
+  TEST_ASSERT(n64 == UINT64_MAX);
+  TEST_ASSERT(json_stream_to_uint64("18446744073709551616", &n64) == -1);
+  TEST_ASSERT(json_stream_to_uint64("-1", &n64) == -1);
+  TEST_ASSERT(json_stream_to_uint64("1.5", &n64) == -1);
+  TEST_ASSERT(json_stream_to_uint64("", &n64) == -1);
+}
+
+/* Exported functions ------------------------------------------------------- */
+int test_json_stream(void)
+{
+  UNITY_BEGIN();
+
+  RUN_TEST(test_stream_split);
+  RUN_TEST(test_stream_truncated);
+  RUN_TEST(test_stream_errors);
+  RUN_TEST(test_stream_numbers);
+
+  return UNITY_END();
+}
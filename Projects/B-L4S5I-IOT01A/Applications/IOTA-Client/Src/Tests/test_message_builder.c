@@ -7,6 +7,7 @@
 #include "unity.h"
 
 #include "client/api/message_builder.h"
+#include "core/pow.h"
 
 /* Private functions -------------------------------------------------------- */
 void test_msg_indexation(void)
@@ -37,6 +38,14 @@ void test_msg_indexation(void)
   TEST_ASSERT_EQUAL_STRING(exp_str, str);
   free(str);
 
+  // the same string in a caller buffer, the terminator must fit
+  char json[512];
+  size_t json_len = strlen(exp_str);
+  TEST_ASSERT_EQUAL_UINT32(json_len, message_to_json_str(msg, NULL, 0));
+  TEST_ASSERT_EQUAL_UINT32(json_len, message_to_json_str(msg, json, json_len));
+  TEST_ASSERT_EQUAL_UINT32(json_len, message_to_json_str(msg, json, json_len + 1));
+  TEST_ASSERT_EQUAL_STRING(exp_str, json);
+
   core_message_free(msg);
 }
 
@@ -46,11 +55,11 @@ void test_msg_tx(void)
       "{\"networkId\":null,\"parentMessageIds\":[\"0000000000000000000000000000000000000000000000000000000000000000\","
       "\"0000000000000000000000000000000000000000000000000000000000000000\"],\"payload\":{\"type\":0,\"essence\":{"
       "\"type\":0,\"inputs\":[{\"type\":0,\"transactionId\":"
-      "\"2BFBF7463B008C0298103121874F64B59D2B6172154AA14205DB2CE0BA553B03\",\"transactionOutputIndex\":0},{\"type\":0,"
-      "\"transactionId\":\"0000000000000000000000000000000000000000000000000000000000000000\","
-      "\"transactionOutputIndex\":1}],\"outputs\":[{\"type\":0,\"address\":{\"type\":0,\"address\":"
-      "\"AD32258255E7CF927A4833F457F220B7187CF975E82AEEE2E23FCAE5056AB5F4\"},\"amount\":1000},{\"type\":0,\"address\":{"
-      "\"type\":0,\"address\":\"0000000000000000000000000000000000000000000000000000000000000000\"},\"amount\":9999}],"
+      "\"0000000000000000000000000000000000000000000000000000000000000000\",\"transactionOutputIndex\":1},{\"type\":0,"
+      "\"transactionId\":\"2BFBF7463B008C0298103121874F64B59D2B6172154AA14205DB2CE0BA553B03\","
+      "\"transactionOutputIndex\":0}],\"outputs\":[{\"type\":0,\"address\":{\"type\":0,\"address\":"
+      "\"0000000000000000000000000000000000000000000000000000000000000000\"},\"amount\":9999},{\"type\":0,\"address\":{"
+      "\"type\":0,\"address\":\"AD32258255E7CF927A4833F457F220B7187CF975E82AEEE2E23FCAE5056AB5F4\"},\"amount\":1000}],"
       "\"payload\":null},\"unlockBlocks\":[{\"type\":0,\"signature\":{\"type\":0,\"publicKey\":"
       "\"0000000000000000000000000000000000000000000000000000000000000000\",\"signature\":"
       "\"00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000"
@@ -97,9 +106,399 @@ void test_msg_tx(void)
   // printf("%s\n", msg_str);
   TEST_ASSERT_EQUAL_STRING(exp_str, msg_str);
 
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  // the placeholder signature is rejected
+  TEST_ASSERT(core_message_verify_transaction(msg) != 0);
+#endif
+
   free(msg_str);
   // free message and sub entities
   core_message_free(msg);
+
+  // a signed transaction is verified, inputs of the same key share a signature
+  byte_t seed[ED_SEED_BYTES];
+  iota_keypair_t keypair;
+  memset(seed, 0x5A, sizeof(seed));
+  iota_crypto_keypair(seed, &keypair);
+  msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  tx = tx_payload_new();
+  TEST_ASSERT_NOT_NULL(tx);
+  TEST_ASSERT(tx_payload_add_input_with_key(tx, tx_id0, 0, keypair.pub, keypair.priv) == 0);
+  TEST_ASSERT(tx_payload_add_input_with_key(tx, tx_id1, 1, keypair.pub, keypair.priv) == 0);
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr0, 1000) == 0);
+  TEST_ASSERT(tx_essence_add_payload(tx->essence, 2, indexation_create("HI", addr0, 8)) == 0);
+  msg->payload_type = 0;
+  msg->payload = tx;
+  TEST_ASSERT(core_message_sign_transaction(msg) == 0);
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  TEST_ASSERT(core_message_verify_transaction(msg) == 0);
+#endif
+  // the streamed essence hash is the hash of the serialized essence
+  byte_t b_essence[256];
+  byte_t exp_hash[CRYPTO_BLAKE2B_HASH_BYTES];
+  byte_t essence_hash[CRYPTO_BLAKE2B_HASH_BYTES];
+  size_t essence_len = tx_essence_serialize(tx->essence, b_essence);
+  TEST_ASSERT_EQUAL_UINT32(tx_essence_serialize_length(tx->essence), essence_len);
+  TEST_ASSERT(iota_blake2b_sum(b_essence, essence_len, exp_hash, sizeof(exp_hash)) == 0);
+  TEST_ASSERT(tx_essence_hash(tx->essence, essence_hash) == 0);
+  TEST_ASSERT_EQUAL_MEMORY(exp_hash, essence_hash, sizeof(exp_hash));
+  // the essence changes after signing
+  tx->essence->outputs.elm[0].amount++;
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  TEST_ASSERT(core_message_verify_transaction(msg) != 0);
+#endif
+  core_message_free(msg);
+}
+
+void test_msg_network_id_nonce(void)
+{
+  char const* const exp_str =
+      "{\"networkId\":\"6530425480034647824\",\"parentMessageIds\":["
+      "\"0000000000000000000000000000000000000000000000000000000000000000\"],\"payload\":{\"type\":2,\"index\":"
+      "\"48454C4C4F\",\"data\":\"48454C4C4F\"},\"nonce\":\"18446744073709551615\"}";
+
+  byte_t idx_data[5] = {0x48, 0x45, 0x4C, 0x4C, 0x4F};
+  byte_t empty_parent[IOTA_MESSAGE_ID_BYTES];
+  memset(empty_parent, 0, sizeof(empty_parent));
+  indexation_t* idx = indexation_create("HELLO", idx_data, sizeof(idx_data));
+  TEST_ASSERT_NOT_NULL(idx);
+  core_message_t* msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  msg->network_id = 6530425480034647824ULL;
+  msg->nonce = UINT64_MAX;
+  msg->payload_type = 2;
+  msg->payload = idx;
+  core_message_add_parent(msg, empty_parent);
+
+  // appended with its terminator to the existing content
+  byte_buf_t* buf = byte_buf_new_with_data((byte_t*)"x", 1);
+  TEST_ASSERT_NOT_NULL(buf);
+  TEST_ASSERT(message_to_json_buf(msg, buf) == 0);
+  TEST_ASSERT_EQUAL_UINT32(strlen(exp_str) + 2, buf->len);
+  TEST_ASSERT_EQUAL_STRING(exp_str, (char*)buf->data + 1);
+
+  byte_buf_free(buf);
+  core_message_free(msg);
+}
+
+void test_msg_serialize(void)
+{
+  byte_t idx_data[2] = {0x01, 0x02};
+  byte_t parent0[IOTA_MESSAGE_ID_BYTES];
+  byte_t parent1[IOTA_MESSAGE_ID_BYTES];
+  memset(parent0, 0xFF, sizeof(parent0));
+  memset(parent1, 0x00, sizeof(parent1));
+
+  indexation_t* idx = indexation_create("HI", idx_data, sizeof(idx_data));
+  TEST_ASSERT_NOT_NULL(idx);
+  core_message_t* msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  msg->network_id = 1;
+  msg->nonce = 2;
+  msg->payload_type = 2;
+  msg->payload = idx;
+  core_message_add_parent(msg, parent0);
+  core_message_add_parent(msg, parent1);
+
+  // network ID + parents count + 2 parents + payload length + indexation payload + nonce
+  size_t exp_len = 8 + 1 + 2 * IOTA_MESSAGE_ID_BYTES + 4 + (4 + 2 + 2 + 4 + 2) + 8;
+  TEST_ASSERT_EQUAL_UINT32(exp_len, core_message_serialize_length(msg));
+  byte_t buf[128];
+  // a buffer too small is left untouched and the required length is returned
+  memset(buf, 0xAA, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT32(exp_len, core_message_serialize(msg, NULL, 0));
+  TEST_ASSERT_EQUAL_UINT32(exp_len, core_message_serialize(msg, buf, exp_len - 1));
+  TEST_ASSERT_EACH_EQUAL_UINT8(0xAA, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT32(14, indexation_payload_serialize(idx, buf, 13));
+  TEST_ASSERT_EACH_EQUAL_UINT8(0xAA, buf, sizeof(buf));
+  TEST_ASSERT_EQUAL_UINT32(exp_len, core_message_serialize(msg, buf, exp_len));
+
+  byte_t exp_head[9] = {0x01, 0, 0, 0, 0, 0, 0, 0, 0x02};
+  TEST_ASSERT_EQUAL_MEMORY(exp_head, buf, sizeof(exp_head));
+  // parents are sorted
+  TEST_ASSERT_EQUAL_MEMORY(parent1, buf + 9, IOTA_MESSAGE_ID_BYTES);
+  TEST_ASSERT_EQUAL_MEMORY(parent0, buf + 9 + IOTA_MESSAGE_ID_BYTES, IOTA_MESSAGE_ID_BYTES);
+  byte_t exp_payload[18] = {14, 0, 0, 0, 2, 0, 0, 0, 2, 0, 'H', 'I', 2, 0, 0, 0, 0x01, 0x02};
+  TEST_ASSERT_EQUAL_MEMORY(exp_payload, buf + 9 + 2 * IOTA_MESSAGE_ID_BYTES, sizeof(exp_payload));
+  byte_t exp_nonce[8] = {0x02, 0, 0, 0, 0, 0, 0, 0};
+  TEST_ASSERT_EQUAL_MEMORY(exp_nonce, buf + exp_len - 8, sizeof(exp_nonce));
+
+  // the message ID is the BLAKE2b-256 hash of the serialized message
+  byte_t const exp_id[IOTA_MESSAGE_ID_BYTES] = {0x9E, 0x17, 0x45, 0xE8, 0xFA, 0xEB, 0x90, 0x60, 0x74, 0xB6, 0xD2,
+                                                0x86, 0x79, 0x28, 0xEC, 0x8D, 0x2B, 0x79, 0xAF, 0x9E, 0xA3, 0xD1,
+                                                0x48, 0xFA, 0x26, 0xCF, 0xA6, 0x04, 0x29, 0x0F, 0x7F, 0x5E};
+  byte_t id[IOTA_MESSAGE_ID_BYTES];
+  TEST_ASSERT(core_message_id(msg, id) == 0);
+  TEST_ASSERT_EQUAL_MEMORY(exp_id, id, IOTA_MESSAGE_ID_BYTES);
+
+  core_message_free(msg);
+}
+
+void test_msg_deserialize(void)
+{
+  byte_t tx_id0[TRANSACTION_ID_BYTES];
+  byte_t addr0[ED25519_ADDRESS_BYTES];
+  byte_t parent[IOTA_MESSAGE_ID_BYTES];
+  byte_t sig[ED25519_SIGNATURE_BLOCK_BYTES];
+  byte_t idx_data[3] = {0x01, 0x02, 0x03};
+  memset(tx_id0, 0x11, sizeof(tx_id0));
+  memset(addr0, 0x22, sizeof(addr0));
+  memset(parent, 0x33, sizeof(parent));
+  memset(sig, 0, sizeof(sig));
+
+  core_message_t* msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  msg->network_id = 6530425480034647824ULL;
+  msg->nonce = 2695978;
+  core_message_add_parent(msg, parent);
+  transaction_payload_t* tx = tx_payload_new();
+  TEST_ASSERT_NOT_NULL(tx);
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id0, 1) == 0);
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr0, 1000) == 0);
+  TEST_ASSERT(tx_essence_add_payload(tx->essence, 2, indexation_create("HI", idx_data, sizeof(idx_data))) == 0);
+  TEST_ASSERT(tx_payload_add_sig_block(tx, sig, ED25519_SIGNATURE_BLOCK_BYTES) == 0);
+  TEST_ASSERT(tx_payload_add_ref_block(tx, 0) == 0);
+  msg->payload_type = 0;
+  msg->payload = tx;
+
+  size_t len = core_message_serialize_length(msg);
+  TEST_ASSERT(len > 0);
+  byte_t* buf = malloc(len * 2);
+  TEST_ASSERT_NOT_NULL(buf);
+  TEST_ASSERT_EQUAL_UINT32(len, core_message_serialize(msg, buf, len));
+
+  // the transaction payload is the message payload
+  size_t tx_len = tx_payload_serialize_length(tx);
+  TEST_ASSERT_EQUAL_UINT32(tx_len, tx_payload_serialize(tx, buf + len, tx_len - 1));
+  TEST_ASSERT_EQUAL_UINT32(tx_len, tx_payload_serialize(tx, buf + len, tx_len));
+  TEST_ASSERT_EQUAL_MEMORY(buf + 8 + 1 + IOTA_MESSAGE_ID_BYTES + 4, buf + len, tx_len);
+
+  // truncated data is rejected
+  TEST_ASSERT_NULL(core_message_deserialize(buf, len - 1));
+
+  core_message_t* msg2 = core_message_deserialize(buf, len);
+  TEST_ASSERT_NOT_NULL(msg2);
+  TEST_ASSERT(msg2->network_id == msg->network_id);
+  TEST_ASSERT(msg2->nonce == msg->nonce);
+  TEST_ASSERT_EQUAL_UINT32(0, msg2->payload_type);
+  transaction_payload_t* tx2 = (transaction_payload_t*)msg2->payload;
+  TEST_ASSERT_EQUAL_UINT16(1, utxo_inputs_count(&tx2->essence->inputs));
+  TEST_ASSERT_EQUAL_UINT16(1, utxo_outputs_count(&tx2->essence->outputs));
+  TEST_ASSERT_EQUAL_UINT16(2, unlock_blocks_count(tx2->unlock_blocks));
+  TEST_ASSERT_NOT_NULL(tx2->essence->payload);
+
+  // serializing again gives the same bytes
+  TEST_ASSERT_EQUAL_UINT32(len, core_message_serialize(msg2, buf + len, len));
+  TEST_ASSERT_EQUAL_MEMORY(buf, buf + len, len);
+
+  free(buf);
+  core_message_free(msg2);
+  core_message_free(msg);
+}
+
+static bool pow_cancel_now(void* opaque)
+{
+  (void)opaque;
+  return true;
+}
+
+void test_msg_pow(void)
+{
+  // trailing zeros of the Curl-P-81 hash, the nonce is the only data
+  byte_t nonce0[POW_NONCE_BYTES] = {0, 0, 0, 0, 0, 0, 0, 0};
+  byte_t nonce1[POW_NONCE_BYTES] = {203, 124, 2, 0, 0, 0, 0, 0};
+  byte_t nonce2[POW_NONCE_BYTES] = {65, 235, 119, 85, 85, 85, 85, 85};
+  TEST_ASSERT_EQUAL_UINT8(1, pow_trailing_zeros(nonce0, sizeof(nonce0)));
+  TEST_ASSERT_EQUAL_UINT8(10, pow_trailing_zeros(nonce1, sizeof(nonce1)));
+  TEST_ASSERT_EQUAL_UINT8(14, pow_trailing_zeros(nonce2, sizeof(nonce2)));
+
+  // 3^zeros >= message length * score
+  TEST_ASSERT_EQUAL_UINT8(0, pow_target_zeros(100, 0));
+  TEST_ASSERT_EQUAL_UINT8(9, pow_target_zeros(4000, 4));
+  TEST_ASSERT_EQUAL_UINT8(10, pow_target_zeros(4000, 5));
+
+  // the smallest nonce is found
+  byte_t data[40 + POW_NONCE_BYTES];
+  for (size_t i = 0; i < 40; i++) {
+    data[i] = (byte_t)i;
+  }
+  uint64_t nonce = 0;
+  TEST_ASSERT(pow_search(data, 40, 4, NULL, &nonce) == 0);
+  TEST_ASSERT(nonce == 13);
+
+  // any nonce reaches a zero target, but a zero nonce asks the node for the proof-of-work
+  TEST_ASSERT(pow_search(data, 40, 0, NULL, &nonce) == 0);
+  TEST_ASSERT(nonce == 1);
+
+  // a second worker searches other nonces
+  pow_worker_t worker = {.worker_id = 1, .worker_count = 2, .cancel = NULL, .opaque = NULL};
+  TEST_ASSERT(pow_search(data, 40, 4, &worker, &nonce) == 0);
+  TEST_ASSERT(nonce != 13);
+  for (size_t i = 0; i < POW_NONCE_BYTES; i++) {
+    data[40 + i] = (byte_t)(nonce >> (8 * i));
+  }
+  TEST_ASSERT(pow_trailing_zeros(data, sizeof(data)) >= 4);
+
+  worker.cancel = pow_cancel_now;
+  TEST_ASSERT(pow_search(data, 40, 4, &worker, &nonce) == -1);
+
+  // the nonce of a message reaches the score
+  byte_t parent[IOTA_MESSAGE_ID_BYTES];
+  memset(parent, 0x44, sizeof(parent));
+  core_message_t* msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  msg->network_id = 1;
+  msg->payload_type = 2;
+  msg->payload = indexation_create("HI", data, 4);
+  core_message_add_parent(msg, parent);
+  TEST_ASSERT(core_message_pow(msg, 10, NULL) == 0);
+  size_t len = core_message_serialize_length(msg);
+  byte_t buf[128];
+  TEST_ASSERT_EQUAL_UINT32(len, core_message_serialize(msg, buf, sizeof(buf)));
+  TEST_ASSERT(pow_trailing_zeros(buf, len) >= pow_target_zeros(len, 10));
+
+  // the buffer holds the final message
+  byte_t pow_buf[128];
+  msg->nonce = 0;
+  TEST_ASSERT(core_message_pow_buf(msg, 10, NULL, pow_buf, len - 1) == -1);
+  TEST_ASSERT(core_message_pow_buf(msg, 10, NULL, pow_buf, len) == 0);
+  TEST_ASSERT_EQUAL_UINT32(len, core_message_serialize(msg, buf, sizeof(buf)));
+  TEST_ASSERT_EQUAL_MEMORY(buf, pow_buf, len);
+  core_message_free(msg);
+}
+
+void test_tx_essence_order(void)
+{
+  byte_t tx_id[TRANSACTION_ID_BYTES];
+  byte_t addr[ED25519_ADDRESS_BYTES];
+  byte_t buf[2 * UTXO_OUTPUT_SERIALIZED_BYTES];
+
+  transaction_payload_t* tx = tx_payload_new_with_capacity(3, 2);
+  TEST_ASSERT_NOT_NULL(tx);
+  // inputs are kept in order of transaction ID then output index
+  memset(tx_id, 0x11, sizeof(tx_id));
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 1) == 0);
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 0) == 0);
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 0) != 0);
+  memset(tx_id, 0x01, sizeof(tx_id));
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 5) == 0);
+  // the essence is full
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 6) != 0);
+  TEST_ASSERT_EQUAL_UINT16(3, utxo_inputs_count(&tx->essence->inputs));
+  TEST_ASSERT_EQUAL_UINT16(5, tx->essence->inputs.elm[0].output_index);
+  TEST_ASSERT_EQUAL_UINT16(0, tx->essence->inputs.elm[1].output_index);
+  TEST_ASSERT_EQUAL_UINT16(1, tx->essence->inputs.elm[2].output_index);
+  TEST_ASSERT(utxo_inputs_find_by_id(&tx->essence->inputs, tx_id, 5) == &tx->essence->inputs.elm[0]);
+  TEST_ASSERT_NULL(utxo_inputs_find_by_id(&tx->essence->inputs, tx_id, 0));
+
+  // outputs are kept in order of output type then address
+  memset(addr, 0x22, sizeof(addr));
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_DUST_ALLOWANCE, addr, 1000000) == 0);
+  memset(addr, 0x33, sizeof(addr));
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr, 1000) == 0);
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr, 1000) != 0);
+  TEST_ASSERT_EQUAL_UINT32(sizeof(buf), utxo_outputs_serialization(&tx->essence->outputs, buf));
+  TEST_ASSERT_EQUAL_UINT8(OUTPUT_SINGLE_OUTPUT, buf[0]);
+  TEST_ASSERT_EQUAL_UINT8(OUTPUT_DUST_ALLOWANCE, buf[UTXO_OUTPUT_SERIALIZED_BYTES]);
+  TEST_ASSERT_NOT_NULL(utxo_outputs_find_by_addr(&tx->essence->outputs, OUTPUT_SINGLE_OUTPUT, addr));
+  TEST_ASSERT_NULL(utxo_outputs_find_by_addr(&tx->essence->outputs, OUTPUT_DUST_ALLOWANCE, addr));
+  tx_payload_free(tx);
+
+  // the protocol limits
+  TEST_ASSERT_NULL(tx_payload_new_with_capacity(UTXO_INPUT_MAX_COUNT + 1, 1));
+}
+
+void test_tx_default_capacity(void)
+{
+  byte_t tx_id[TRANSACTION_ID_BYTES];
+  byte_t addr[ED25519_ADDRESS_BYTES];
+
+  // the plain constructor takes up to the protocol limits
+  transaction_payload_t* tx = tx_payload_new();
+  TEST_ASSERT_NOT_NULL(tx);
+  for (uint16_t i = 0; i < UTXO_INPUT_MAX_COUNT; i++) {
+    memset(tx_id, 0, sizeof(tx_id));
+    memcpy(tx_id, &i, sizeof(i));
+    TEST_ASSERT(tx_payload_add_input(tx, tx_id, 0) == 0);
+  }
+  TEST_ASSERT(tx_payload_add_input(tx, tx_id, 1) != 0);
+  for (uint16_t i = 0; i < UTXO_OUTPUT_MAX_COUNT; i++) {
+    memset(addr, 0, sizeof(addr));
+    memcpy(addr, &i, sizeof(i));
+    TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr, 1000) == 0);
+  }
+  TEST_ASSERT_EQUAL_UINT16(UTXO_INPUT_MAX_COUNT, utxo_inputs_count(&tx->essence->inputs));
+  TEST_ASSERT_EQUAL_UINT16(UTXO_OUTPUT_MAX_COUNT, utxo_outputs_count(&tx->essence->outputs));
+  tx_payload_free(tx);
+}
+
+void test_tx_unlock_blocks(void)
+{
+  byte_t seed[ED_SEED_BYTES];
+  byte_t tx_id[TRANSACTION_ID_BYTES];
+  byte_t addr[ED25519_ADDRESS_BYTES];
+  iota_keypair_t keypair[3];
+  for (int k = 0; k < 3; k++) {
+    memset(seed, 0x10 + k, sizeof(seed));
+    iota_crypto_keypair(seed, &keypair[k]);
+  }
+  memset(addr, 0x44, sizeof(addr));
+
+  // the largest transaction, the inputs of a key share a signature block
+  core_message_t* msg = core_message_new();
+  TEST_ASSERT_NOT_NULL(msg);
+  transaction_payload_t* tx = tx_payload_new_with_capacity(UTXO_INPUT_MAX_COUNT, 1);
+  TEST_ASSERT_NOT_NULL(tx);
+  for (uint16_t i = 0; i < UTXO_INPUT_MAX_COUNT; i++) {
+    memset(tx_id, 0, sizeof(tx_id));
+    memcpy(tx_id, &i, sizeof(i));
+    TEST_ASSERT(tx_payload_add_input_with_key(tx, tx_id, 0, keypair[i % 3].pub, keypair[i % 3].priv) == 0);
+  }
+  TEST_ASSERT(tx_payload_add_output(tx, OUTPUT_SINGLE_OUTPUT, addr, 1000) == 0);
+  msg->payload_type = 0;
+  msg->payload = tx;
+  TEST_ASSERT(core_message_sign_transaction(msg) == 0);
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  TEST_ASSERT(core_message_verify_transaction(msg) == 0);
+#endif
+
+  TEST_ASSERT_EQUAL_UINT16(UTXO_INPUT_MAX_COUNT, unlock_blocks_count(tx->unlock_blocks));
+  int sig_blocks = 0;
+  for (uint16_t i = 0; i < tx->unlock_blocks->count; i++) {
+    unlock_block_elm_t const* b = &tx->unlock_blocks->elm[i];
+    if (b->type == 0) {
+      sig_blocks++;
+    } else {
+      // the same key as the referenced signature
+      TEST_ASSERT_EQUAL_MEMORY(tx->essence->inputs.elm[b->reference].keypair.pub_key,
+                               tx->essence->inputs.elm[i].keypair.pub_key, ED_PUBLIC_KEY_BYTES);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(3, sig_blocks);
+  for (int k = 0; k < 3; k++) {
+    int32_t index = unlock_blocks_find_pub(tx->unlock_blocks, keypair[k].pub);
+    TEST_ASSERT(index >= 0 && index < 3);
+    TEST_ASSERT_EQUAL_UINT8(0, tx->unlock_blocks->elm[index].type);
+  }
+  memset(seed, 0x20, sizeof(seed));
+  iota_crypto_keypair(seed, &keypair[0]);
+  TEST_ASSERT_EQUAL_INT32(-1, unlock_blocks_find_pub(tx->unlock_blocks, keypair[0].pub));
+
+  // the blocks are full
+  byte_t sig[ED25519_SIGNATURE_BLOCK_BYTES];
+  memset(sig, 0, sizeof(sig));
+  TEST_ASSERT(tx_payload_add_sig_block(tx, sig, sizeof(sig)) != 0);
+  TEST_ASSERT(tx_payload_add_ref_block(tx, 0) != 0);
+
+  // a reference to a reference block is rejected
+  tx->unlock_blocks->elm[UTXO_INPUT_MAX_COUNT - 1].type = 1;
+  tx->unlock_blocks->elm[UTXO_INPUT_MAX_COUNT - 1].reference = UTXO_INPUT_MAX_COUNT - 2;
+  TEST_ASSERT(tx->unlock_blocks->elm[UTXO_INPUT_MAX_COUNT - 2].type == 1);
+#if defined(CRYPTO_HAS_ED25519_VERIFY)
+  TEST_ASSERT(core_message_verify_transaction(msg) != 0);
+#endif
+  core_message_free(msg);
 }
 
 /* Exported functions ------------------------------------------------------- */
@@ -109,6 +508,13 @@ int test_message_builder(void)
 
   RUN_TEST(test_msg_indexation);
   RUN_TEST(test_msg_tx);
+  RUN_TEST(test_msg_network_id_nonce);
+  RUN_TEST(test_msg_serialize);
+  RUN_TEST(test_msg_deserialize);
+  RUN_TEST(test_msg_pow);
+  RUN_TEST(test_tx_essence_order);
+  RUN_TEST(test_tx_default_capacity);
+  RUN_TEST(test_tx_unlock_blocks);
 
   return UNITY_END();
 }
@@ -0,0 +1,152 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+/* Includes ----------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "wallet/utxo_cache.h"
+
+/* Private define ----------------------------------------------------------- */
+#define MSG_A "a6b1c2d3e4f5a6b1c2d3e4f5a6b1c2d3e4f5a6b1c2d3e4f5a6b1c2d3e4f5a6b1"
+#define MSG_B "b7c2d3e4f5a6b7c2d3e4f5a6b7c2d3e4f5a6b7c2d3e4f5a6b7c2d3e4f5a6b7c2"
+
+/* Private variables -------------------------------------------------------- */
+static byte_t tx_a[TRANSACTION_ID_BYTES];
+static byte_t tx_b[TRANSACTION_ID_BYTES];
+
+/* Private functions -------------------------------------------------------- */
+static utxo_cache_ht* add_output(utxo_cache_ht** cache, byte_t const tx_id[], uint16_t index, uint64_t amount)
+{
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  utxo_cache_output_id(tx_id, index, output_id);
+  return utxo_cache_add(cache, output_id, amount, false, 0);
+}
+
+static void fill_tx_ids(void)
+{
+  memset(tx_a, 0xA1, sizeof(tx_a));
+  memset(tx_b, 0xA1, sizeof(tx_b));
+  tx_b[TRANSACTION_ID_BYTES - 1] = 0xB2;
+}
+
+void test_output_id(void)
+{
+  utxo_cache_ht* cache = utxo_cache_new();
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  fill_tx_ids();
+
+  // the transaction ID followed by the little endian output index
+  utxo_cache_output_id(tx_a, 0x0102, output_id);
+  TEST_ASSERT_EQUAL_MEMORY(tx_a, output_id, TRANSACTION_ID_BYTES);
+  TEST_ASSERT_EQUAL_HEX8(0x02, output_id[TRANSACTION_ID_BYTES]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, output_id[TRANSACTION_ID_BYTES + 1]);
+
+  // outputs differing only by their last transaction ID byte or by their index are distinct keys
+  utxo_cache_ht* a0 = add_output(&cache, tx_a, 0, 100);
+  utxo_cache_ht* a1 = add_output(&cache, tx_a, 1, 200);
+  utxo_cache_ht* b0 = add_output(&cache, tx_b, 0, 300);
+  TEST_ASSERT_NOT_NULL(a0);
+  TEST_ASSERT_NOT_NULL(a1);
+  TEST_ASSERT_NOT_NULL(b0);
+  TEST_ASSERT_EQUAL_UINT32(3, utxo_cache_count(&cache));
+  TEST_ASSERT_EQUAL_UINT16(1, a1->output_index);
+  TEST_ASSERT_FALSE(a1->is_spent);
+  TEST_ASSERT_TRUE(a1->listed);
+
+  utxo_cache_output_id(tx_b, 0, output_id);
+  TEST_ASSERT(utxo_cache_find(&cache, output_id) == b0);
+  utxo_cache_output_id(tx_a, 1, output_id);
+  TEST_ASSERT(utxo_cache_find(&cache, output_id) == a1);
+  utxo_cache_output_id(tx_a, 256, output_id);
+  TEST_ASSERT_NULL(utxo_cache_find(&cache, output_id));
+
+  // an output is added once
+  TEST_ASSERT_NULL(add_output(&cache, tx_a, 1, 200));
+  TEST_ASSERT_EQUAL_UINT32(3, utxo_cache_count(&cache));
+
+  utxo_cache_remove(&cache, a1);
+  utxo_cache_output_id(tx_a, 1, output_id);
+  TEST_ASSERT_NULL(utxo_cache_find(&cache, output_id));
+  TEST_ASSERT_EQUAL_UINT32(2, utxo_cache_count(&cache));
+
+  utxo_cache_free(&cache);
+  TEST_ASSERT_NULL(cache);
+}
+
+void test_spent_outputs(void)
+{
+  utxo_cache_ht* cache = utxo_cache_new();
+  fill_tx_ids();
+
+  utxo_cache_ht* a0 = add_output(&cache, tx_a, 0, 100);
+  utxo_cache_ht* a1 = add_output(&cache, tx_a, 1, 200);
+  utxo_cache_ht* b0 = add_output(&cache, tx_b, 0, 300);
+  utxo_cache_ht* b1 = add_output(&cache, tx_b, 1, 400);
+  TEST_ASSERT_NOT_NULL(b1);
+
+  // spent by a sent message
+  TEST_ASSERT(utxo_cache_set_spent(&cache, tx_a, 0, MSG_A) == 0);
+  TEST_ASSERT_TRUE(a0->is_spent);
+  TEST_ASSERT_EQUAL_STRING(MSG_A, a0->spent_msg_id);
+  TEST_ASSERT(utxo_cache_set_spent(&cache, tx_b, 0, MSG_A) == 0);
+  TEST_ASSERT(utxo_cache_set_spent(&cache, tx_a, 1, MSG_B) == 0);
+
+  // pending, reserved by a message not sent yet
+  TEST_ASSERT(utxo_cache_set_spent(&cache, tx_b, 1, "") == 0);
+  TEST_ASSERT_TRUE(b1->is_spent);
+  TEST_ASSERT_EQUAL_STRING("", b1->spent_msg_id);
+
+  // unknown outputs
+  TEST_ASSERT(utxo_cache_set_spent(&cache, tx_a, 2, MSG_A) == -1);
+  TEST_ASSERT(utxo_cache_set_unspent(&cache, tx_b, 2) == -1);
+
+  // the message was not sent, its reserved input is available again
+  TEST_ASSERT(utxo_cache_set_unspent(&cache, tx_b, 1) == 0);
+  TEST_ASSERT_FALSE(b1->is_spent);
+  TEST_ASSERT_EQUAL_STRING("", b1->spent_msg_id);
+
+  // the first message failed, only its inputs are released
+  TEST_ASSERT_EQUAL_UINT32(2, utxo_cache_clear_spent(&cache, MSG_A));
+  TEST_ASSERT_FALSE(a0->is_spent);
+  TEST_ASSERT_FALSE(b0->is_spent);
+  TEST_ASSERT_EQUAL_STRING("", a0->spent_msg_id);
+  TEST_ASSERT_TRUE(a1->is_spent);
+  TEST_ASSERT_EQUAL_STRING(MSG_B, a1->spent_msg_id);
+  TEST_ASSERT_EQUAL_UINT32(0, utxo_cache_clear_spent(&cache, MSG_A));
+
+  // releasing the pending outputs does not touch unspent ones
+  TEST_ASSERT_EQUAL_UINT32(0, utxo_cache_clear_spent(&cache, ""));
+  TEST_ASSERT_EQUAL_UINT32(1, utxo_cache_clear_spent(&cache, MSG_B));
+  TEST_ASSERT_FALSE(a1->is_spent);
+
+  utxo_cache_free(&cache);
+}
+
+void test_msg_failed(void)
+{
+  // still pending
+  TEST_ASSERT_FALSE(utxo_cache_msg_failed("", 0));
+  TEST_ASSERT_FALSE(utxo_cache_msg_failed("noTransaction", 0));
+  // confirmed
+  TEST_ASSERT_FALSE(utxo_cache_msg_failed("included", 123));
+  // will never spend its inputs
+  TEST_ASSERT_TRUE(utxo_cache_msg_failed("conflicting", 123));
+  TEST_ASSERT_TRUE(utxo_cache_msg_failed("conflicting", 0));
+  TEST_ASSERT_TRUE(utxo_cache_msg_failed("noTransaction", 123));
+  TEST_ASSERT_TRUE(utxo_cache_msg_failed("", 123));
+}
+
+/* Exported functions ------------------------------------------------------- */
+int test_utxo_cache(void)
+{
+  UNITY_BEGIN();
+
+  RUN_TEST(test_output_id);
+  RUN_TEST(test_spent_outputs);
+  RUN_TEST(test_msg_failed);
+
+  return UNITY_END();
+}
@@ -0,0 +1,203 @@
+// Copyright 2021 IOTA Stiftung
+// SPDX-License-Identifier: Apache-2.0
+
+/* Includes ----------------------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+
+#include "unity.h"
+
+#include "wallet/wallet.h"
+
+/* Private define ----------------------------------------------------------- */
+#define TEST_MNEMONIC                                                                                              \
+  "giant dynamic museum toddler six deny defense ostrich bomb access mercy blood explain muscle shoot shallow glad " \
+  "autumn author calm heavy hawk abuse rally"
+#define TEST_PAYMENTS (WALLET_BATCH_MAX_PAYMENTS + 5)
+#define TEST_MI 1000000
+
+/* Private typedef ---------------------------------------------------------- */
+// a stubbed balance lookup, the used addresses of each chain and the lookups made
+typedef struct {
+  uint32_t const* used[2];
+  size_t used_count[2];
+  uint32_t lookups[2];
+  uint32_t fail_at;
+} gap_stub_t;
+
+/* Private functions -------------------------------------------------------- */
+static int gap_stub_lookup(void* ctx, bool change, uint32_t index, bool* used)
+{
+  gap_stub_t* stub = (gap_stub_t*)ctx;
+  stub->lookups[change]++;
+  if (index == stub->fail_at) {
+    return -1;
+  }
+  *used = false;
+  for (size_t i = 0; i < stub->used_count[change]; i++) {
+    if (stub->used[change][i] == index) {
+      *used = true;
+    }
+  }
+  return 0;
+}
+
+void test_gap_scan(void)
+{
+  uint32_t const external[] = {0, 3, 7};
+  uint32_t const change[] = {2};
+  gap_stub_t stub = {{external, change}, {3, 1}, {0, 0}, UINT32_MAX};
+  uint32_t next = 0;
+
+  // the scan stops after 4 unused addresses following the last used one
+  TEST_ASSERT(wallet_gap_scan(false, 4, gap_stub_lookup, &stub, &next) == 0);
+  TEST_ASSERT_EQUAL_UINT32(8, next);
+  TEST_ASSERT_EQUAL_UINT32(12, stub.lookups[0]);
+
+  // a gap as large as the limit ends the chain
+  TEST_ASSERT(wallet_gap_scan(false, 3, gap_stub_lookup, &stub, &next) == 0);
+  TEST_ASSERT_EQUAL_UINT32(4, next);
+
+  TEST_ASSERT(wallet_gap_scan(true, 4, gap_stub_lookup, &stub, &next) == 0);
+  TEST_ASSERT_EQUAL_UINT32(3, next);
+  TEST_ASSERT_EQUAL_UINT32(7, stub.lookups[1]);
+
+  // an unused chain, with the default limit
+  stub.used_count[1] = 0;
+  stub.lookups[1] = 0;
+  TEST_ASSERT(wallet_gap_scan(true, 0, gap_stub_lookup, &stub, &next) == 0);
+  TEST_ASSERT_EQUAL_UINT32(0, next);
+  TEST_ASSERT_EQUAL_UINT32(WALLET_DEFAULT_GAP_LIMIT, stub.lookups[1]);
+
+  // a failed lookup fails the scan
+  stub.fail_at = 5;
+  TEST_ASSERT(wallet_gap_scan(false, 4, gap_stub_lookup, &stub, &next) == -1);
+  TEST_ASSERT(wallet_gap_scan(false, 4, NULL, &stub, &next) == -1);
+}
+
+// adds an output of the sender address to the cache of the wallet
+static void add_sender_output(iota_wallet_t* w, byte_t tag, uint64_t amount)
+{
+  byte_t tx_id[TRANSACTION_ID_BYTES];
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  memset(tx_id, tag, sizeof(tx_id));
+  utxo_cache_output_id(tx_id, 0, output_id);
+  TEST_ASSERT_NOT_NULL(utxo_cache_add(&w->utxos, output_id, amount, false, 0));
+}
+
+static void fill_payments(wallet_payment_t payments[], size_t count)
+{
+  for (size_t i = 0; i < count; i++) {
+    memset(payments[i].addr, 0, ED25519_ADDRESS_BYTES);
+    payments[i].addr[0] = (byte_t)(i + 1);
+    payments[i].addr[1] = (byte_t)((i + 1) >> 8);
+    payments[i].amount = TEST_MI;
+  }
+}
+
+static uint64_t input_amount(iota_wallet_t* w, utxo_input_t const* in)
+{
+  byte_t output_id[UTXO_OUTPUT_ID_BYTES];
+  utxo_cache_output_id(in->tx_id, in->output_index, output_id);
+  utxo_cache_ht* elm = utxo_cache_find(&w->utxos, output_id);
+  TEST_ASSERT_NOT_NULL(elm);
+  // reserved by a message not sent yet
+  TEST_ASSERT_TRUE(elm->is_spent);
+  TEST_ASSERT_EQUAL_STRING("", elm->spent_msg_id);
+  return elm->amount;
+}
+
+void test_batch_split(void)
+{
+  static wallet_payment_t payments[TEST_PAYMENTS];
+  transaction_payload_t* txs[WALLET_BATCH_MESSAGES(TEST_PAYMENTS)] = {NULL};
+  byte_t sender[ED25519_ADDRESS_BYTES];
+  size_t tx_count = 0;
+  size_t paid = 0;
+
+  iota_wallet_t* w = wallet_create(TEST_MNEMONIC, "", 0);
+  TEST_ASSERT_NOT_NULL(w);
+  TEST_ASSERT(wallet_address_from_index(w, false, 0, sender) == 0);
+  add_sender_output(w, 0x11, 100 * TEST_MI);
+  add_sender_output(w, 0x22, 50 * TEST_MI);
+  add_sender_output(w, 0x33, 20 * TEST_MI);
+  fill_payments(payments, TEST_PAYMENTS);
+
+  TEST_ASSERT_EQUAL_UINT32(2, WALLET_BATCH_MESSAGES(TEST_PAYMENTS));
+  TEST_ASSERT(wallet_build_batch(w, false, 0, payments, TEST_PAYMENTS, txs, &tx_count) == 0);
+  TEST_ASSERT_EQUAL_UINT32(2, tx_count);
+
+  for (size_t i = 0; i < tx_count; i++) {
+    transaction_essence_t const* essence = txs[i]->essence;
+    size_t n = i == 0 ? WALLET_BATCH_MAX_PAYMENTS : TEST_PAYMENTS - WALLET_BATCH_MAX_PAYMENTS;
+    uint64_t inputs = 0;
+
+    // the inputs of the messages are disjoint
+    for (uint16_t j = 0; j < essence->inputs.count; j++) {
+      inputs += input_amount(w, &essence->inputs.elm[j]);
+      for (size_t k = 0; k < i; k++) {
+        TEST_ASSERT_NULL(utxo_inputs_find_by_id(&txs[k]->essence->inputs, essence->inputs.elm[j].tx_id,
+                                                essence->inputs.elm[j].output_index));
+      }
+    }
+
+    // the payments of the message and the remainder
+    TEST_ASSERT_EQUAL_UINT16(n + 1, utxo_outputs_count(&essence->outputs));
+    for (size_t j = paid; j < paid + n; j++) {
+      utxo_output_t const* out = utxo_outputs_find_by_addr(&essence->outputs, OUTPUT_SINGLE_OUTPUT, payments[j].addr);
+      TEST_ASSERT_NOT_NULL(out);
+      TEST_ASSERT(out->amount == TEST_MI);
+    }
+    utxo_output_t const* remainder = utxo_outputs_find_by_addr(&essence->outputs, OUTPUT_SINGLE_OUTPUT, sender);
+    TEST_ASSERT_NOT_NULL(remainder);
+    TEST_ASSERT(inputs - n * TEST_MI >= COIN_SELECT_MIN_CHANGE);
+    TEST_ASSERT(remainder->amount == inputs - n * TEST_MI);
+    paid += n;
+  }
+
+  for (size_t i = 0; i < tx_count; i++) {
+    tx_payload_free(txs[i]);
+  }
+  wallet_destroy(w);
+}
+
+void test_batch_failure(void)
+{
+  static wallet_payment_t payments[TEST_PAYMENTS];
+  transaction_payload_t* txs[WALLET_BATCH_MESSAGES(TEST_PAYMENTS)] = {NULL};
+  size_t tx_count = 0;
+  utxo_cache_ht *elm, *tmp;
+
+  iota_wallet_t* w = wallet_create(TEST_MNEMONIC, "", 0);
+  TEST_ASSERT_NOT_NULL(w);
+  // enough for the first message only
+  add_sender_output(w, 0x11, 130 * TEST_MI);
+  add_sender_output(w, 0x22, 2 * TEST_MI);
+  fill_payments(payments, TEST_PAYMENTS);
+
+  // the second message fails, the inputs of the first one are released
+  TEST_ASSERT(wallet_build_batch(w, false, 0, payments, TEST_PAYMENTS, txs, &tx_count) == -1);
+  TEST_ASSERT_EQUAL_UINT32(0, tx_count);
+  TEST_ASSERT_NULL(txs[0]);
+  HASH_ITER(hh, w->utxos, elm, tmp) { TEST_ASSERT_FALSE(elm->is_spent); }
+
+  // a single message is covered
+  TEST_ASSERT(wallet_build_batch(w, false, 0, payments, WALLET_BATCH_MAX_PAYMENTS, txs, &tx_count) == 0);
+  TEST_ASSERT_EQUAL_UINT32(1, tx_count);
+  tx_payload_free(txs[0]);
+
+  TEST_ASSERT(wallet_build_batch(w, false, 0, payments, 0, txs, &tx_count) == -1);
+  wallet_destroy(w);
+}
+
+/* Exported functions ------------------------------------------------------- */
+int test_wallet(void)
+{
+  UNITY_BEGIN();
+
+  RUN_TEST(test_gap_scan);
+  RUN_TEST(test_batch_split);
+  RUN_TEST(test_batch_failure);
+
+  return UNITY_END();
+}
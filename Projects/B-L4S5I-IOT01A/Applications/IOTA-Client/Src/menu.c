@@ -171,6 +171,10 @@ static void test_menu(void)
     printf("|%*s|\r\n", -WW, " 11. Client get message metadata;");
     printf("|%*s|\r\n", -WW, " 12. Client get message children;");
     printf("|%*s|\r\n", -WW, " 13. Test crypto;");
+    printf("|%*s|\r\n", -WW, " 14. Test coin selection;");
+    printf("|%*s|\r\n", -WW, " 15. Test wallet;");
+    printf("|%*s|\r\n", -WW, " 16. Test UTXO cache;");
+    printf("|%*s|\r\n", -WW, " 17. Test JSON stream;");
     printf("|%*s|\r\n", -WW, "");
     printf("|%*s|\r\n", -WW, " 0.  Back to the main menu.");
     printf("|%*s|\r\n", -WW, "");
@@ -265,6 +269,30 @@ static void test_menu(void)
       terminal_print_frame("End [Test crypto]", '*', '*', '*', WW, BLUE);
       serial_press_any();
       break;
+    case 14:
+      terminal_print_frame("Test coin selection", '*', '*', '*', WW, BLUE);
+      test_coin_selection();
+      terminal_print_frame("End [Test coin selection]", '*', '*', '*', WW, BLUE);
+      serial_press_any();
+      break;
+    case 15:
+      terminal_print_frame("Test wallet", '*', '*', '*', WW, BLUE);
+      test_wallet();
+      terminal_print_frame("End [Test wallet]", '*', '*', '*', WW, BLUE);
+      serial_press_any();
+      break;
+    case 16:
+      terminal_print_frame("Test UTXO cache", '*', '*', '*', WW, BLUE);
+      test_utxo_cache();
+      terminal_print_frame("End [Test UTXO cache]", '*', '*', '*', WW, BLUE);
+      serial_press_any();
+      break;
+    case 17:
+      terminal_print_frame("Test JSON stream", '*', '*', '*', WW, BLUE);
+      test_json_stream();
+      terminal_print_frame("End [Test JSON stream]", '*', '*', '*', WW, BLUE);
+      serial_press_any();
+      break;
     default:
       printf("\r\nWrong choice [%ld]. Try again.\r\n\r\n", choice);
       break;